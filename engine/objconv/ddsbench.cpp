@@ -0,0 +1,118 @@
+/*
+ * Times the software DDS decompressor (gldrv/sdds.cpp) on real data:
+ *   ddsbench [-n repeats] [-c cachedir] file.dds...
+ * Every mipmap level of every file is decoded, as GFXTransferTexture does when s3tc is unavailable.
+ * With -c, reading the decoded chain back from a decoded texture cache in cachedir is timed too.
+ */
+#include "gldrv/sdds.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+static unsigned int getl32(const unsigned char *buf)
+{
+    return buf[0] | (buf[1] << 8) | (buf[2] << 16) | ((unsigned int)buf[3] << 24);
+}
+
+static bool readFile(const char *filename, std::vector<unsigned char> &contents)
+{
+    FILE *fp = fopen(filename, "rb");
+    if (!fp)
+        return false;
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    contents.resize(size > 0 ? size : 0);
+    bool ok = size > 0 && fread(&contents[0], 1, size, fp) == (size_t)size;
+    fclose(fp);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    int repeats = 10;
+    std::string cachedir;
+    int first = 1;
+    for (; first + 1 < argc && argv[first][0] == '-'; first += 2)
+    {
+        if (strcmp(argv[first], "-n") == 0)
+            repeats = atoi(argv[first + 1]);
+        else if (strcmp(argv[first], "-c") == 0)
+            cachedir = argv[first + 1];
+        else
+            break;
+    }
+    if (first >= argc || repeats < 1)
+    {
+        fprintf(stderr, "usage: %s [-n repeats] [-c cachedir] file.dds...\n", argv[0]);
+        return 1;
+    }
+    double totalms = 0;
+    double totalcachems = 0;
+    double totalpixels = 0;
+    for (int i = first; i < argc; ++i)
+    {
+        std::vector<unsigned char> contents;
+        if (!readFile(argv[i], contents) || contents.size() < 128 || memcmp(&contents[0], "DDS ", 4) != 0)
+        {
+            fprintf(stderr, "%s: not a DDS file\n", argv[i]);
+            continue;
+        }
+        const unsigned char *header = &contents[4];
+        int height = getl32(header + 8);
+        int width = getl32(header + 12);
+        int mips = getl32(header + 24);
+        TEXTUREFORMAT format;
+        if (memcmp(header + 80, "DXT1", 4) == 0)
+            format = DXT1;
+        else if (memcmp(header + 80, "DXT3", 4) == 0)
+            format = DXT3;
+        else if (memcmp(header + 80, "DXT5", 4) == 0)
+            format = DXT5;
+        else
+        {
+            fprintf(stderr, "%s: not DXT compressed\n", argv[i]);
+            continue;
+        }
+        int levels = 0;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeats; ++r)
+        {
+            unsigned char *decoded = nullptr;
+            levels = ddsDecompressMips(&contents[128], decoded, format, height, width, mips);
+            free(decoded);
+        }
+        double ms =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / repeats;
+        printf("%s: %dx%d, %d levels, %.3f ms", argv[i], width, height, levels, ms);
+        totalms += ms;
+        if (!cachedir.empty())
+        {
+            // The first call fills the cache, the timed ones read it back
+            unsigned char *decoded = nullptr;
+            ddsDecompressMipsCached(cachedir, &contents[128], decoded, format, height, width, mips);
+            free(decoded);
+            start = std::chrono::steady_clock::now();
+            for (int r = 0; r < repeats; ++r)
+            {
+                decoded = nullptr;
+                ddsDecompressMipsCached(cachedir, &contents[128], decoded, format, height, width, mips);
+                free(decoded);
+            }
+            double cachems =
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / repeats;
+            printf(", from cache %.3f ms", cachems);
+            totalcachems += cachems;
+        }
+        printf("\n");
+        totalpixels += (double)width * height * 4 / 3;
+    }
+    if (totalms > 0)
+        printf("total: %.3f ms, %.1f Mpixels/s\n", totalms, totalpixels / totalms / 1000.0);
+    if (totalcachems > 0)
+        printf("total from cache: %.3f ms, %.1f Mpixels/s\n", totalcachems, totalpixels / totalcachems / 1000.0);
+    return 0;
+}
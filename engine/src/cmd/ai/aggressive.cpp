@@ -12,6 +12,7 @@
 #include "event_xml.h"
 #include "faction_generic.h"
 #include "flybywire.h"
+#include "galaxy_graph.h"
 #include "gfx/cockpit_generic.h"
 #include "hard_coded_scripts.h"
 #include "lin_time.h"
@@ -1537,9 +1538,23 @@ static Unit *ChooseNavPoint(Unit *parent, Unit **otherdest, float *lurk_on_arriv
                 }
                 else
                 {
+                    // Not next door: head for the jump point that starts the route there
+                    const GalaxyGraph &graph = _Universe->getGalaxyGraph();
+                    vector<GalaxyGraph::SystemId> route;
+                    if (graph.route(graph.find(ss->getFileName()), graph.find(srcdst[thirdRand]), route,
+                                    parent->faction) &&
+                        route.size() > 1)
+                    {
+                        i = stats->jumpPoints.find(graph.name(route[1]));
+                        if (i != stats->jumpPoints.end())
+                        {
+                            Unit *un = i->second.GetUnit();
+                            if (un)
+                                return un;
+                        }
+                    }
                     total_size = stats->navs[whichlist].size() +
                                  stats->navs[0].size(); // no such jump point--have to random-walk it
-                    // maybe one day we can incorporate some sort of route planning
                 }
             }
         }
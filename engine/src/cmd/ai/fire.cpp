@@ -1,5 +1,6 @@
 #include "fire.h"
 #include "cmd/ai/communication.h"
+#include "cmd/contact_snapshot.h"
 #include "cmd/pilot.h"
 #include "cmd/planet_generic.h"
 #include "cmd/role_bitmask.h"
@@ -675,8 +676,7 @@ void FireAt::ChooseTargets(int numtargs, bool force)
     }
     if (unitLocator.action.mytarg == nullptr) // decided to rechoose or did not have initial target
     {
-        findObjects(_Universe->activeStarSystem()->collidemap[Unit::UNIT_ONLY], parent->location[Unit::UNIT_ONLY],
-                    &unitLocator);
+        ContactSnapshot::Find(_Universe->activeStarSystem()->collidemap[Unit::UNIT_ONLY], parent, &unitLocator);
     }
     Unit *mytarg = unitLocator.action.mytarg;
     targetpick += queryTime() - pretable;
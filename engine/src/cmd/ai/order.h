@@ -25,6 +25,7 @@
 
 #include "cmd/container.h"
 #include "gfx/vec.h"
+#include "object_pool.h"
 #include <list>
 #include <string>
 #include <vector>
@@ -42,6 +43,10 @@
 class Animation;
 class Order
 {
+  public:
+    // AI scripts build and drop order trees all the time; every Order type has a pool
+    POOLED_ALLOCATION("Order")
+
   private:
   protected:
     virtual ~Order();
@@ -446,6 +446,8 @@ BaseComputer::BaseComputer(Unit *player, Unit *base, const std::vector<DisplayMo
     : m_displayModes(modes), m_player(player), m_base(base), m_currentDisplay(nullptr_DISPLAY), m_selectedList(nullptr),
       m_playingMuzak(false)
 {
+    m_upgradeIndex.stamp = 0;
+    m_upgradeIndex.hassellable = false;
     // Make sure we get this color loaded.
     // Initialize mode group controls array.
     for (int32_t i = 0; i < DISPLAY_MODE_COUNT; i++)
@@ -2394,8 +2396,23 @@ bool BaseComputer::pickerChangedSelection(const EventCommandId &command, Control
     return true;
 }
 
-bool UpgradeAllowed(const Cargo &item, Unit *playerUnit)
+struct ProhibitedUpgrade
 {
+    std::string content;
+    int quantity;
+};
+
+// Prohibited_Upgrades of the ship, parsed once per ship type rather than once per listed part
+static const std::vector<ProhibitedUpgrade> &ProhibitedUpgrades(Unit *playerUnit)
+{
+    static std::string lastname;
+    static int lastfaction = -1;
+    static std::vector<ProhibitedUpgrade> prohibited;
+    if (lastfaction == playerUnit->faction && lastname == playerUnit->name.get())
+        return prohibited;
+    lastname = playerUnit->name.get();
+    lastfaction = playerUnit->faction;
+    prohibited.clear();
     std::string prohibited_upgrades = UniverseUtil::LookupUnitStat(
         playerUnit->name, FactionUtil::GetFactionName(playerUnit->faction), "Prohibited_Upgrades");
     while (prohibited_upgrades.length())
@@ -2423,6 +2440,19 @@ bool UpgradeAllowed(const Cargo &item, Unit *playerUnit)
             std::string tmp = prohibited_upgrade.substr(where + 1);
             quantity = atoi(tmp.c_str());
         }
+        ProhibitedUpgrade entry = {content, quantity};
+        prohibited.push_back(entry);
+    }
+    return prohibited;
+}
+
+bool UpgradeAllowed(const Cargo &item, Unit *playerUnit)
+{
+    const std::vector<ProhibitedUpgrade> &prohibited = ProhibitedUpgrades(playerUnit);
+    for (size_t p = 0; p < prohibited.size(); ++p)
+    {
+        const std::string &content = prohibited[p].content;
+        int quantity = prohibited[p].quantity;
         if (item.content == content || (0 == string(item.category).find(content)))
         {
             if (quantity == 0)
@@ -3450,6 +3480,46 @@ bool BaseComputer::acceptMission(const EventCommandId &command, Control *control
     return true;
 }
 
+BaseComputer::UpgradeIndex &BaseComputer::upgradeIndex(Unit *playerUnit)
+{
+    if (m_upgradeIndex.stamp != playerUnit->ConfigStamp())
+    {
+        m_upgradeIndex.stamp = playerUnit->ConfigStamp();
+        m_upgradeIndex.upgrades.clear();
+        m_upgradeIndex.hassellable = false;
+        m_upgradeIndex.sellable.clear();
+    }
+    return m_upgradeIndex;
+}
+
+// Same as playerUnit->FilterUpgradeList, checking each part against the ship once while it stays the same.
+void BaseComputer::filterUpgradeList(Unit *playerUnit, vector<CargoColor> &list)
+{
+    UpgradeIndex &index = upgradeIndex(playerUnit);
+    vector<CargoColor> unknown;
+    for (size_t i = 0; i < list.size(); ++i)
+    {
+        if (index.upgrades.find(list[i].cargo.content) == index.upgrades.end())
+        {
+            unknown.push_back(list[i]);
+            unknown.back().color = DEFAULT_UPGRADE_COLOR();
+        }
+    }
+    if (!unknown.empty())
+    {
+        playerUnit->FilterDowngradeList(unknown, false);
+        for (size_t i = 0; i < unknown.size(); ++i)
+            index.upgrades[unknown[i].cargo.content] = unknown[i].color;
+    }
+    for (size_t i = 0; i < list.size(); ++i)
+    {
+        const GFXColor &color = index.upgrades[list[i].cargo.content];
+        if (!equalColors(color, DEFAULT_UPGRADE_COLOR()))
+            list[i].color = color;
+    }
+    playerUnit->FilterUpgradePrices(list);
+}
+
 // Load the all the controls for the UPGRADE display.
 void BaseComputer::loadUpgradeControls()
 {
@@ -3478,7 +3548,7 @@ void BaseComputer::loadBuyUpgradeControls()
     std::vector<std::string> filtervec;
     filtervec.push_back("upgrades");
     loadMasterList(baseUnit, filtervec, std::vector<std::string>(), true, tlist);
-    playerUnit->FilterUpgradeList(tlist.masterList);
+    filterUpgradeList(playerUnit, tlist.masterList);
 
     // Mark all the upgrades that we can't do.
     // cargo.mission == true means we can't upgrade this.
@@ -3522,24 +3592,34 @@ void BaseComputer::loadSellUpgradeControls()
     tlist.masterList.clear(); // Just in case
 
     // Get a list of upgrades on our ship we could sell.
-    Unit *partListUnit = &GetUnitMasterPartList();
-
-    loadMasterList(partListUnit, weapfiltervec, std::vector<std::string>(), false, tlist);
-    ClearDowngradeMap();
-    playerUnit->FilterDowngradeList(tlist.masterList);
-    static const bool clearDowngrades =
-        XMLSupport::parse_bool(vs_config->getVariable("physics", "only_show_best_downgrade", "true"));
-    if (clearDowngrades)
+    UpgradeIndex &index = upgradeIndex(playerUnit);
+    if (!index.hassellable)
     {
-        std::set<std::string> downgradeMap = GetListOfDowngrades();
-        for (unsigned int i = 0; i < tlist.masterList.size(); ++i)
+        Unit *partListUnit = &GetUnitMasterPartList();
+
+        loadMasterList(partListUnit, weapfiltervec, std::vector<std::string>(), false, tlist);
+        ClearDowngradeMap();
+        playerUnit->FilterDowngradeList(tlist.masterList);
+        static const bool clearDowngrades =
+            XMLSupport::parse_bool(vs_config->getVariable("physics", "only_show_best_downgrade", "true"));
+        if (clearDowngrades)
         {
-            if (downgradeMap.find(tlist.masterList[i].cargo.content) == downgradeMap.end())
+            std::set<std::string> downgradeMap = GetListOfDowngrades();
+            for (unsigned int i = 0; i < tlist.masterList.size(); ++i)
             {
-                tlist.masterList.erase(tlist.masterList.begin() + i);
-                i--;
+                if (downgradeMap.find(tlist.masterList[i].cargo.content) == downgradeMap.end())
+                {
+                    tlist.masterList.erase(tlist.masterList.begin() + i);
+                    i--;
+                }
             }
         }
+        index.sellable = tlist.masterList;
+        index.hassellable = true;
+    }
+    else
+    {
+        tlist.masterList = index.sellable;
     }
     // Mark all the upgrades that we can't do.
     // cargo.mission == true means we can't upgrade this.
@@ -5077,7 +5157,7 @@ bool BaseComputer::showPlayerInfo(const EventCommandId &command, Control *contro
     string text = "#b#Factions:#-b#n1.7#";
 
     // Number of kills for each faction.
-    vector<float> *killList = &_Universe->AccessCockpit()->savegame->getMissionData(string("kills"));
+    const vector<float> *killList = &_Universe->AccessCockpit()->savegame->readMissionData(string("kills"));
 
     // Make everything bold.
     text += "#b#";
@@ -6580,8 +6660,13 @@ bool BaseComputer::actionConfirmedSaveGame()
                 {
                     UniverseUtil::setCurrentSaveGame(tmp);
                     WriteSaveGame(cockpit, false);
+                    // Only the writer knows whether the save made it to disk
+                    bool saved = WaitForSaveFileWrites();
                     loadLoadSaveControls();
-                    showAlert("Game saved successfully.");
+                    if (saved)
+                        showAlert("Game saved successfully.");
+                    else
+                        showAlert("Could not write the saved game. Check that you have permissions and free space.");
                 }
                 else
                 {
@@ -6618,6 +6703,7 @@ bool BaseComputer::actionSaveGame(const EventCommandId &command, Control *contro
         Cockpit *cockpit = _Universe->isPlayerStarship(player);
         if (cockpit)
         {
+            WaitForSaveFileWrites();
             VSFileSystem::VSFile fp;
             VSFileSystem::VSError err = fp.OpenReadOnly(tmp, SaveFile);
             if (err > Ok)
@@ -25,6 +25,7 @@
 #include "cmd/unit_generic.h"
 #include "gui/simplepicker.h"
 #include "gui/windowcontroller.h"
+#include <map>
 
 // The BaseComputer class displays an interactive screen that supports a
 // number of functions in a base.
@@ -295,6 +296,18 @@ class BaseComputer : public WctlBase<BaseComputer>
     // Load a master list with missions.
     void loadMissionsMasterList(TransactionList &list);
 
+    // What the upgrade checks found out about the player's ship, good while its ConfigStamp holds.
+    struct UpgradeIndex
+    {
+        unsigned int stamp;
+        std::map<std::string, GFXColor> upgrades; // Color FilterUpgradeList leaves a white part with
+        bool hassellable;
+        std::vector<CargoColor> sellable; // Master part list after FilterDowngradeList
+    };
+    // The index for the ship, emptied first if the ship changed since it was filled.
+    UpgradeIndex &upgradeIndex(Unit *playerUnit);
+    void filterUpgradeList(Unit *playerUnit, vector<CargoColor> &list);
+
     // VARIABLES
     vector<DisplayMode> m_displayModes; // List of diaplays to provide.
   public:
@@ -307,6 +320,7 @@ class BaseComputer : public WctlBase<BaseComputer>
     TransactionList *m_selectedList;           // Which transaction list has the selection. nullptr = none.
     Control *m_modeGroups[DISPLAY_MODE_COUNT]; // Array of GroupControls, one for each mode.
     bool m_playingMuzak;                       // True = We are playing muzak for some mode.
+    UpgradeIndex m_upgradeIndex;               // Kept for as long as we are docked here.
 
     // INTERNAL CLASSES.
     class UpgradeOperation;
@@ -3,6 +3,7 @@
 #include "gfx/decalqueue.h"
 #include "unit_generic.h"
 #include "vegastrike.h"
+#include <algorithm>
 #include <vector>
 using std::vector;
 #include "aldrv/audiolib.h"
@@ -54,6 +55,7 @@ Beam::~Beam()
     // DO NOT DELETE - shared vlist
     // delete vlist;
     beamdecals.DelTexture(decal);
+    BeamBatch::Forget(this);
 }
 
 extern void AdjustMatrixToTrackTarget(Matrix &mat, const Vector &vel, Unit *target, float speed, bool lead, float cone);
@@ -223,3 +225,200 @@ void Beam::CollideHuge(const LineCollide &lc, Unit *targetToCollideWith, Unit *f
         }
     }
 }
+
+static BeamBatch *active_beam_batch = nullptr; // taking beams
+static BeamBatch *queued_beam_batch = nullptr; // holding beams, until resolved
+
+BeamBatch::BeamBatch(bool enable) : active(enable && !queued_beam_batch)
+{
+    if (active)
+        active_beam_batch = queued_beam_batch = this;
+}
+
+BeamBatch::~BeamBatch()
+{
+    Resolve();
+}
+
+BeamBatch *BeamBatch::Active()
+{
+    return active_beam_batch;
+}
+
+void BeamBatch::Defer(Beam *beam, Unit *target, Unit *firer, Unit *superunit)
+{
+    Pending p;
+    p.beam = beam;
+    p.target = target;
+    p.firer = firer;
+    p.superunit = superunit;
+    p.simulation_atom = SIMULATION_ATOM;
+    p.minlook = p.maxlook = 0;
+    pending.push_back(p);
+}
+
+void BeamBatch::Forget(const Beam *beam)
+{
+    if (!queued_beam_batch)
+        return;
+    std::vector<Pending> &pending = queued_beam_batch->pending;
+    for (size_t i = 0; i < pending.size(); ++i)
+        if (pending[i].beam == beam)
+            pending[i].beam = nullptr;
+}
+
+// Same walk as CollideHuge, done once for all the beams of superunit: order[first] .. order[last-1]
+void BeamBatch::Gather(size_t first, size_t last)
+{
+    Unit *superunit = pending[order[first]].superunit;
+    CollideMap::iterator superloc = superunit->location[Unit::UNIT_ONLY];
+    if (is_null(superloc))
+        return;
+    CollideMap *cm = _Universe->activeStarSystem()->collidemap[Unit::UNIT_ONLY];
+    double superkey = (*superloc)->getKey();
+    CollideMap::iterator tmore = superloc;
+    if (!cm->Iterable(superloc))
+    {
+        CollideArray::CollidableBackref *br = static_cast<CollideArray::CollidableBackref *>(superloc);
+        CollideMap::iterator tmploc = cm->begin() + br->toflattenhints_offset;
+        if (tmploc == cm->end())
+            tmploc--;
+        tmore = superloc = tmploc;
+    }
+    else
+    {
+        ++tmore;
+    }
+    for (size_t i = first; i < last; ++i)
+    {
+        Pending &p = pending[order[i]];
+        if (!p.beam || !p.beam->curlength)
+            continue;
+        const Beam *beam = p.beam;
+        double r0 = beam->center.i;
+        double r1 = beam->center.i + beam->direction.i * beam->curlength;
+        p.minlook = r0 < r1 ? r0 : r1;
+        p.maxlook = r0 < r1 ? r1 : r0;
+        p.maxlook += (p.maxlook - superkey) + 2 * beam->curlength;
+        p.minlook += (p.minlook - superkey) - 2 * beam->curlength * beam->curlength;
+    }
+
+    walking.clear();
+    if (superloc != cm->begin())
+        for (size_t i = first; i < last; ++i)
+            if (pending[order[i]].beam && pending[order[i]].beam->curlength && pending[order[i]].minlook < superkey)
+                walking.push_back(order[i]);
+    for (CollideMap::iterator tless = superloc; !walking.empty() && tless != cm->begin();)
+    {
+        --tless;
+        for (size_t w = 0; w < walking.size();)
+        {
+            const Pending &p = pending[walking[w]];
+            if ((*tless)->getKey() < p.minlook)
+            {
+                walking[w] = walking.back();
+                walking.pop_back();
+                continue;
+            }
+            if ((*tless)->radius > 0 && beamCheckCollision(p.beam->center, p.beam->curlength, **tless))
+                candidates.push_back(std::make_pair(walking[w], (size_t)(tless - cm->begin())));
+            ++w;
+        }
+    }
+
+    walking.clear();
+    for (size_t i = first; i < last; ++i)
+        if (pending[order[i]].beam && pending[order[i]].beam->curlength && pending[order[i]].maxlook > superkey)
+            walking.push_back(order[i]);
+    for (CollideMap::iterator t = tmore; !walking.empty() && t != cm->end(); ++t)
+    {
+        for (size_t w = 0; w < walking.size();)
+        {
+            const Pending &p = pending[walking[w]];
+            if ((*t)->getKey() > p.maxlook)
+            {
+                walking[w] = walking.back();
+                walking.pop_back();
+                continue;
+            }
+            if ((*t)->radius > 0 && beamCheckCollision(p.beam->center, p.beam->curlength, **t))
+                candidates.push_back(std::make_pair(walking[w], (size_t)(t - cm->begin())));
+            ++w;
+        }
+    }
+}
+
+// The gathered units were in reach of the whole beam; as hits cut it, each is checked again just before
+void BeamBatch::Collide(size_t index, const std::pair<size_t, size_t> *first, const std::pair<size_t, size_t> *last)
+{
+    Pending &p = pending[index];
+    if (!p.beam->curlength)
+        return;
+    if (is_null(p.superunit->location[Unit::UNIT_ONLY]))
+    {
+        if (p.target)
+            p.beam->Collide(p.target, p.firer, p.superunit);
+        return;
+    }
+    CollideMap *cm = _Universe->activeStarSystem()->collidemap[Unit::UNIT_ONLY];
+    bool targcheck = false;
+    for (; first != last && p.beam; ++first)
+    {
+        const Collidable &collidable = *(cm->begin() + first->second);
+        if (collidable.radius > 0 && beamCheckCollision(p.beam->center, p.beam->curlength, collidable))
+        {
+            Unit *un = collidable.ref.unit;
+            p.beam->Collide(un, p.firer, p.superunit);
+            targcheck = (targcheck || un == p.target);
+        }
+    }
+    if (p.beam && p.target && !targcheck)
+        p.beam->Collide(p.target, p.firer, p.superunit);
+}
+
+void BeamBatch::Resolve()
+{
+    if (!active)
+        return;
+    active = false;
+    active_beam_batch = nullptr;
+    order.resize(pending.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+                     [this](size_t a, size_t b) { return pending[a].superunit < pending[b].superunit; });
+    for (size_t first = 0, last; first < order.size(); first = last)
+    {
+        for (last = first + 1; last < order.size() && pending[order[last]].superunit == pending[order[first]].superunit;
+             ++last)
+        {
+        }
+        Gather(first, last);
+    }
+    // Per beam, in walk order
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const std::pair<size_t, size_t> &a, const std::pair<size_t, size_t> &b) {
+                         return a.first < b.first;
+                     });
+    float backup = SIMULATION_ATOM;
+    const std::pair<size_t, size_t> *c = candidates.data();
+    const std::pair<size_t, size_t> *cend = c + candidates.size();
+    for (size_t i = 0; i < pending.size(); ++i)
+    {
+        const std::pair<size_t, size_t> *first = c;
+        while (c != cend && c->first == i)
+            ++c;
+        if (!pending[i].beam)
+            continue;
+        SIMULATION_ATOM = pending[i].simulation_atom;
+        Collide(i, first, c);
+        // Collide may have taken the beam down with its ship
+        if (pending[i].beam)
+            pending[i].beam->UpdateCollideInfo();
+    }
+    SIMULATION_ATOM = backup;
+    queued_beam_batch = nullptr;
+    pending.clear();
+    candidates.clear();
+    order.clear();
+}
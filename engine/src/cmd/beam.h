@@ -53,6 +53,8 @@ class Beam
 
     void RecalculateVertices(const Matrix &trans);
     void CollideHuge(const LineCollide &, Unit *targetToCollideWith, Unit *firer, Unit *superunit);
+    void UpdateCollideInfo();
+    friend class BeamBatch;
 
   public:
     void ListenToOwner(bool listen)
@@ -89,4 +91,43 @@ class Beam
     bool Collide(class Unit *target, Unit *firer, Unit *superunit /*for cargo*/);
     static void ProcessDrawQueue();
 };
+
+/**
+ * While a BeamBatch is active, Beam::UpdatePhysics queues the collision of the beam instead of
+ * walking the collide map right away. Resolve() walks the map once for all the beams of a ship,
+ * then collides every beam, in the order they were queued, with what it found, in the order
+ * CollideHuge would have found it; so beams are cut and deal damage just as before. The only
+ * difference is that units simulated after the firing ship in the same physics frame are hit
+ * where they ended up rather than where they were.
+ */
+class BeamBatch
+{
+    struct Pending
+    {
+        Beam *beam; // null once the beam is gone
+        Unit *target;
+        Unit *firer;
+        Unit *superunit;
+        float simulation_atom; // damage depends on the atom of the unit being simulated
+        double minlook;
+        double maxlook;
+    };
+    std::vector<Pending> pending;
+    std::vector<std::pair<size_t, size_t>> candidates; // pending index and collide map offset, in walk order
+    std::vector<size_t> order;   // pending indices, by firing ship
+    std::vector<size_t> walking; // beams still within reach during a walk
+    bool active;
+
+    void Gather(size_t first, size_t last);
+    void Collide(size_t index, const std::pair<size_t, size_t> *first, const std::pair<size_t, size_t> *last);
+
+  public:
+    explicit BeamBatch(bool enable);
+    ~BeamBatch();
+    static BeamBatch *Active();
+    void Defer(Beam *beam, Unit *target, Unit *firer, Unit *superunit);
+    /// For beams deleted while queued, as happens when their ship is killed
+    static void Forget(const Beam *beam);
+    void Resolve();
+};
 #endif
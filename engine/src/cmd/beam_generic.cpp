@@ -335,47 +335,57 @@ void Beam::UpdatePhysics(const Transformation &trans, const Matrix &m, Unit *tar
         RemoveFromSystem(false);
 #endif
     }
+    else if (BeamBatch *batch = BeamBatch::Active())
+    {
+        batch->Defer(this, listen_to_owner ? targetToCollideWith : nullptr, firer, superunit);
+    }
     else
     {
         CollideHuge(CollideInfo, listen_to_owner ? targetToCollideWith : nullptr, firer, superunit);
-        if (!(curlength <= range && curlength > 0))
-        {
-            // if curlength just happens to be nan --FIXME THIS MAKES NO SENSE AT ALL --chuck_starchaser
-            if (curlength > range)
-            {
-                curlength = range;
-            }
-            else
-            {
-                curlength = 0;
-            }
-        }
-        QVector tmpvec(center + direction.Cast().Scale(curlength));
-        QVector tmpMini = center.Min(tmpvec);
-        tmpvec = center.Max(tmpvec);
-#ifdef BEAMCOLQ
-        if (TableLocationChanged(CollideInfo, tmpMini, tmpvec) || (curthick > 0 && CollideInfo.object.b == nullptr))
+        UpdateCollideInfo();
+    }
+    // Check if collide...that'll change max beam length REAL quick
+}
+
+// Once collided, as that cuts the beam
+void Beam::UpdateCollideInfo()
+{
+    if (!(curlength <= range && curlength > 0))
+    {
+        // if curlength just happens to be nan --FIXME THIS MAKES NO SENSE AT ALL --chuck_starchaser
+        if (curlength > range)
         {
-            RemoveFromSystem(false);
-#endif
-            CollideInfo.object.b = this;
-            CollideInfo.hhuge = (((CollideInfo.Maxi.i - CollideInfo.Mini.i) / coltableacc) *
-                                     ((CollideInfo.Maxi.j - CollideInfo.Mini.j) / coltableacc) *
-                                     (CollideInfo.Maxi.k - CollideInfo.Mini.k) / coltableacc >
-                                 tablehuge);
-            CollideInfo.Mini = tmpMini;
-            CollideInfo.Maxi = tmpvec;
-#ifdef BEAMCOLQ
-            AddCollideQueue(CollideInfo);
+            curlength = range;
         }
         else
         {
-            CollideInfo.Mini = tmpMini;
-            CollideInfo.Maxi = tmpvec;
+            curlength = 0;
         }
+    }
+    QVector tmpvec(center + direction.Cast().Scale(curlength));
+    QVector tmpMini = center.Min(tmpvec);
+    tmpvec = center.Max(tmpvec);
+#ifdef BEAMCOLQ
+    if (TableLocationChanged(CollideInfo, tmpMini, tmpvec) || (curthick > 0 && CollideInfo.object.b == nullptr))
+    {
+        RemoveFromSystem(false);
 #endif
+        CollideInfo.object.b = this;
+        CollideInfo.hhuge = (((CollideInfo.Maxi.i - CollideInfo.Mini.i) / coltableacc) *
+                                 ((CollideInfo.Maxi.j - CollideInfo.Mini.j) / coltableacc) *
+                                 (CollideInfo.Maxi.k - CollideInfo.Mini.k) / coltableacc >
+                             tablehuge);
+        CollideInfo.Mini = tmpMini;
+        CollideInfo.Maxi = tmpvec;
+#ifdef BEAMCOLQ
+        AddCollideQueue(CollideInfo);
     }
-    // Check if collide...that'll change max beam length REAL quick
+    else
+    {
+        CollideInfo.Mini = tmpMini;
+        CollideInfo.Maxi = tmpvec;
+    }
+#endif
 }
 
 extern Cargo *GetMasterPartList(const char *);
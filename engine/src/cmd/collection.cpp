@@ -1,12 +1,13 @@
 #include "collection.h"
 
-#include <list>
 #include <vector>
 #ifndef LIST_TESTING
+#include "configxml.h"
 #include "unit_generic.h"
 #include "unit_util.h"
+#include "vs_globals.h"
+#include "xml_support.h"
 
-using std::list;
 using std::vector;
 // UnitIterator  BEGIN:
 
@@ -41,17 +42,19 @@ UnitCollection::UnitIterator::UnitIterator(const UnitIterator &orig)
 UnitCollection::UnitIterator::UnitIterator(UnitCollection *orig)
 {
     col = orig;
-    it = col->units.begin();
+    col->compact();
+    it = col->nodes[End].next;
     col->reg(this);
-    while (it != col->units.end())
+    while (it != End)
     {
-        if ((*it) == nullptr)
+        Unit *unit = col->nodes[it].unit;
+        if (unit == nullptr)
         {
-            ++it;
+            it = col->nodes[it].next;
         }
         else
         {
-            if ((*it)->Killed())
+            if (unit->Killed())
             {
                 col->erase(it);
             }
@@ -73,7 +76,7 @@ UnitCollection::UnitIterator::~UnitIterator()
 
 void UnitCollection::UnitIterator::remove()
 {
-    if (col && it != col->units.end())
+    if (col && it != End)
     {
         col->erase(it);
     }
@@ -81,9 +84,9 @@ void UnitCollection::UnitIterator::remove()
 
 void UnitCollection::UnitIterator::moveBefore(UnitCollection &otherlist)
 {
-    if (col && it != col->units.end())
+    if (col && it != End)
     {
-        otherlist.prepend(*it);
+        otherlist.prepend(col->nodes[it].unit);
         col->erase(it);
     }
 }
@@ -98,30 +101,30 @@ void UnitCollection::UnitIterator::preinsert(Unit *unit)
 
 void UnitCollection::UnitIterator::postinsert(Unit *unit)
 {
-    list<Unit *>::iterator tmp = it;
-    if (col && unit && it != col->units.end())
+    if (col && unit && it != End)
     {
-        ++tmp;
+        Position tmp = col->nodes[it].next;
         col->insert(tmp, unit);
     }
 }
 
 void UnitCollection::UnitIterator::advance()
 {
-    if (!col || it == col->units.end())
+    if (!col || it == End)
     {
         return;
     }
-    ++it;
-    while (it != col->units.end())
+    it = col->nodes[it].next;
+    while (it != End)
     {
-        if ((*it) == nullptr)
+        Unit *unit = col->nodes[it].unit;
+        if (unit == nullptr)
         {
-            ++it;
+            it = col->nodes[it].next;
         }
         else
         {
-            if ((*it)->Killed())
+            if (unit->Killed())
             {
                 col->erase(it);
             }
@@ -136,7 +139,7 @@ void UnitCollection::UnitIterator::advance()
 Unit *UnitCollection::UnitIterator::next()
 {
     advance();
-    return *it;
+    return **this;
 }
 
 // UnitIterator END:
@@ -145,6 +148,14 @@ Unit *UnitCollection::UnitIterator::next()
 
 UnitCollection::ConstIterator &UnitCollection::ConstIterator::operator=(const UnitCollection::ConstIterator &orig)
 {
+    if (orig.col)
+    {
+        ++orig.col->constIters;
+    }
+    if (col)
+    {
+        --col->constIters;
+    }
     col = orig.col;
     it = orig.it;
     return *this;
@@ -154,14 +165,20 @@ UnitCollection::ConstIterator::ConstIterator(const ConstIterator &orig)
 {
     col = orig.col;
     it = orig.it;
+    if (col)
+    {
+        ++col->constIters;
+    }
 }
 
 UnitCollection::ConstIterator::ConstIterator(const UnitCollection *orig)
 {
     col = orig;
-    for (it = orig->units.begin(); it != col->units.end(); ++it)
+    ++col->constIters;
+    for (it = col->nodes[End].next; it != End; it = col->nodes[it].next)
     {
-        if ((*it) && !(*it)->Killed())
+        Unit *unit = col->nodes[it].unit;
+        if (unit && !unit->Killed())
         {
             break;
         }
@@ -170,42 +187,33 @@ UnitCollection::ConstIterator::ConstIterator(const UnitCollection *orig)
 
 UnitCollection::ConstIterator::~ConstIterator()
 {
+    if (col)
+    {
+        --col->constIters;
+    }
 }
 
 Unit *UnitCollection::ConstIterator::next()
 {
     advance();
-    if (col && it != col->units.end())
-    {
-        return *it;
-    }
-    return nullptr;
+    return **this;
 }
 
 inline void UnitCollection::ConstIterator::advance()
 {
-    if (!col || it == col->units.end())
+    if (!col || it == End)
     {
         return;
     }
-    ++it;
-    while (it != col->units.end())
+    it = col->nodes[it].next;
+    while (it != End)
     {
-        if ((*it) == nullptr)
-        {
-            ++it;
-        }
-        else
+        Unit *unit = col->nodes[it].unit;
+        if (unit && !unit->Killed())
         {
-            if ((*it)->Killed())
-            {
-                ++it;
-            }
-            else
-            {
-                break;
-            }
+            break;
         }
+        it = col->nodes[it].next;
     }
 }
 
@@ -226,34 +234,118 @@ const UnitCollection::ConstIterator UnitCollection::ConstIterator::operator++(in
 
 // UnitCollection  BEGIN:
 
-UnitCollection::UnitCollection()
+UnitCollection::UnitCollection() : freeNodes(End), count(0), scattered(0), constIters(0)
 {
+    Node sentinel = {nullptr, End, End};
+    nodes.push_back(sentinel);
     activeIters.reserve(20);
 }
 
 UnitCollection::UnitCollection(const UnitCollection &unit_collection)
+    : freeNodes(End), count(0), scattered(0), constIters(0)
 {
-    list<Unit *>::const_iterator in = unit_collection.units.begin();
-    while (in != unit_collection.units.end())
+    Node sentinel = {nullptr, End, End};
+    nodes.reserve(unit_collection.count + 1);
+    nodes.push_back(sentinel);
+    for (Position in = unit_collection.nodes[End].next; in != End; in = unit_collection.nodes[in].next)
     {
-        append(*in);
-        ++in;
+        append(unit_collection.nodes[in].unit);
     }
 }
 
+UnitCollection::Position UnitCollection::link(Position pos, Unit *unit)
+{
+    Position node;
+    if (freeNodes != End)
+    {
+        node = freeNodes;
+        freeNodes = nodes[node].prev;
+    }
+    else
+    {
+        node = nodes.size();
+        Node fresh = {nullptr, End, End};
+        nodes.push_back(fresh);
+    }
+    Position prev = nodes[pos].prev;
+    nodes[node].unit = unit;
+    nodes[node].prev = prev;
+    nodes[node].next = pos;
+    nodes[prev].next = node;
+    nodes[pos].prev = node;
+    ++count;
+    // A walk stays linear as long as each node follows the one before it in memory
+    if ((prev != End && node != prev + 1) || (pos != End && pos != node + 1))
+    {
+        ++scattered;
+    }
+    return node;
+}
+
+UnitCollection::Position UnitCollection::unlink(Position pos)
+{
+    Position next = nodes[pos].next;
+    nodes[nodes[pos].prev].next = next;
+    nodes[next].prev = nodes[pos].prev;
+    nodes[pos].unit = nullptr;
+    nodes[pos].prev = freeNodes;
+    freeNodes = pos;
+    --count;
+    ++scattered;
+    return next;
+}
+
+void UnitCollection::compact()
+{
+    static unsigned int min_scattered =
+        XMLSupport::parse_int(vs_config->getVariable("physics", "collection_compact_threshold", "64"));
+    // ConstIterators cannot be moved along, and the tombstones are cheaper to drop first
+    if (constIters || !removedIters.empty() || scattered < min_scattered || scattered < count / 4)
+    {
+        return;
+    }
+    vector<Node> packed;
+    packed.reserve(count + 1);
+    vector<Position> moved(nodes.size(), End);
+    Node sentinel = {nullptr, End, End};
+    packed.push_back(sentinel);
+    for (Position in = nodes[End].next; in != End; in = nodes[in].next)
+    {
+        Position out = packed.size();
+        Node node = {nodes[in].unit, out - 1, End};
+        packed.back().next = out;
+        packed.push_back(node);
+        moved[in] = out;
+    }
+    packed.front().prev = packed.size() - 1;
+    for (size_t i = 0; i < activeIters.size(); ++i)
+    {
+        // An iterator left on a removed node goes on to the node that followed it
+        Position it = activeIters[i]->it;
+        while (it != End && moved[it] == End)
+        {
+            it = nodes[it].next;
+        }
+        activeIters[i]->it = moved[it];
+    }
+    nodes.swap(packed);
+    freeNodes = End;
+    scattered = 0;
+}
+
 void UnitCollection::insert_unique(Unit *unit)
 {
     if (unit)
     {
-        for (list<Unit *>::iterator it = units.begin(); it != units.end(); ++it)
+        for (Position it = nodes[End].next; it != End; it = nodes[it].next)
         {
-            if (*it == unit)
+            if (nodes[it].unit == unit)
             {
                 return;
             }
         }
         unit->Ref();
-        units.push_front(unit);
+        link(nodes[End].next, unit);
     }
 }
 
@@ -262,7 +354,7 @@ void UnitCollection::prepend(Unit *unit)
     if (unit)
     {
         unit->Ref();
-        units.push_front(unit);
+        link(nodes[End].next, unit);
     }
 }
 
@@ -273,12 +365,11 @@ void UnitCollection::prepend(UnitIterator *it)
     {
         return;
     }
-    list<Unit *>::iterator tmpI = units.begin();
+    Position first = nodes[End].next;
     while ((tmp = **it))
     {
         tmp->Ref();
-        units.insert(tmpI, tmp);
-        ++tmpI;
+        link(first, tmp);
         it->advance();
     }
 }
@@ -288,7 +379,7 @@ void UnitCollection::append(Unit *un)
     if (un)
     {
         un->Ref();
-        units.push_back(un);
+        link(End, un);
     }
 }
 
@@ -302,19 +393,19 @@ void UnitCollection::append(UnitIterator *it)
     while ((tmp = **it))
     {
         tmp->Ref();
-        units.push_back(tmp);
+        link(End, tmp);
         it->advance();
     }
 }
 
-void UnitCollection::insert(list<Unit *>::iterator &temp, Unit *unit)
+void UnitCollection::insert(Position &temp, Unit *unit)
 {
     if (unit)
     {
         unit->Ref();
-        temp = units.insert(temp, unit);
+        link(temp, unit);
     }
-    temp = units.end();
+    temp = End;
 }
 
 void UnitCollection::clear()
@@ -324,40 +415,41 @@ void UnitCollection::clear()
         fprintf(stderr, "WARNING! Attempting to clear a collection with active iterators!\n");
         return;
     }
-
-    for (list<Unit *>::iterator it = units.begin(); it != units.end(); ++it)
-    {
-        (*it)->UnRef();
-        (*it) = nullptr;
-    }
-    units.clear();
+    destr();
 }
 
 void UnitCollection::destr()
 {
-    for (list<Unit *>::iterator it = units.begin(); it != units.end(); ++it)
+    for (Position it = nodes[End].next; it != End; it = nodes[it].next)
     {
-        if (*it)
+        if (nodes[it].unit)
         {
-            (*it)->UnRef();
-            (*it) = nullptr;
+            nodes[it].unit->UnRef();
+            nodes[it].unit = nullptr;
         }
     }
     for (auto t = activeIters.begin(); t != activeIters.end(); ++t)
     {
         (*t)->col = nullptr;
     }
+    activeIters.clear();
+    removedIters.clear();
+    nodes.resize(1);
+    nodes[End].prev = nodes[End].next = End;
+    freeNodes = End;
+    count = 0;
+    scattered = 0;
 }
 
 bool UnitCollection::contains(const Unit *unit) const
 {
-    if (units.empty() || !unit)
+    if (!unit)
     {
         return false;
     }
-    for (list<Unit *>::const_iterator it = units.begin(); it != units.end(); ++it)
+    for (Position it = nodes[End].next; it != End; it = nodes[it].next)
     {
-        if ((*it) == unit && !(*it)->Killed())
+        if (nodes[it].unit == unit && !unit->Killed())
         {
             return true;
         }
@@ -365,56 +457,56 @@ bool UnitCollection::contains(const Unit *unit) const
     return false;
 }
 
-inline void UnitCollection::erase(list<Unit *>::iterator &it2)
+inline void UnitCollection::erase(Position &it2)
 {
-    if (!(*it2))
+    Unit *unit = nodes[it2].unit;
+    if (!unit)
     {
-        ++it2;
+        it2 = nodes[it2].next;
         return;
     }
+    // Released last: dropping the reference may destroy the unit, which may touch this collection
+    nodes[it2].unit = nullptr;
     // If we have more than 4 iterators, just push node onto vector.
-    if (activeIters.size() > 3)
-    {
-        removedIters.push_back(it2);
-        (*it2)->UnRef();
-        (*it2) = nullptr;
-        ++it2;
-        return;
-    }
+    bool tombstone = activeIters.size() > 3;
     // If we have between 2 and 4 iterators, see if any are actually
     // on the node we want to remove, if so, just push onto vector.
     // Purpose : This special case is to reduce the size of the list in the
     // situation where removedIters isn't being processed.
-    if (activeIters.size() > 1)
+    if (!tombstone && activeIters.size() > 1)
     {
         for (vector<UnitCollection::UnitIterator *>::size_type i = 0; i < activeIters.size(); ++i)
         {
             if (activeIters[i]->it == it2)
             {
-                removedIters.push_back(it2);
-                (*it2)->UnRef();
-                (*it2) = nullptr;
-                ++it2;
-                return;
+                tombstone = true;
+                break;
             }
         }
     }
-    // If we have 1 iterator, or none of the iterators are currently on the
-    // requested node to be removed, then remove it right away.
-    (*it2)->UnRef();
-    (*it2) = nullptr;
-    it2 = units.erase(it2);
+    if (tombstone)
+    {
+        removedIters.push_back(it2);
+        it2 = nodes[it2].next;
+    }
+    else
+    {
+        // If we have 1 iterator, or none of the iterators are currently on the
+        // requested node to be removed, then remove it right away.
+        it2 = unlink(it2);
+    }
+    unit->UnRef();
 }
 
 bool UnitCollection::remove(const Unit *unit)
 {
-    if (units.empty() || !unit)
+    if (!unit)
     {
         return false;
     }
-    for (list<Unit *>::iterator it = units.begin(); it != units.end(); ++it)
+    for (Position it = nodes[End].next; it != End; it = nodes[it].next)
     {
-        if ((*it) == unit)
+        if (nodes[it].unit == unit)
         {
             erase(it);
             return (true);
@@ -425,12 +517,14 @@ bool UnitCollection::remove(const Unit *unit)
 
 const UnitCollection &UnitCollection::operator=(const UnitCollection &uc)
 {
+    if (this == &uc)
+    {
+        return *this;
+    }
     destr();
-    list<Unit *>::const_iterator in = uc.units.begin();
-    while (in != uc.units.end())
+    for (Position in = uc.nodes[End].next; in != End; in = uc.nodes[in].next)
     {
-        append(*in);
-        ++in;
+        append(uc.nodes[in].unit);
     }
     return *this;
 }
@@ -451,11 +545,11 @@ inline void UnitCollection::unreg(UnitCollection::UnitIterator *iter)
         }
     }
     if (activeIters.empty() ||
-        (activeIters.size() == 1 && (activeIters[0]->it == units.end() || (*(activeIters[0]->it)))))
+        (activeIters.size() == 1 && (activeIters[0]->it == End || nodes[activeIters[0]->it].unit)))
     {
         while (!removedIters.empty())
         {
-            units.erase(removedIters.back());
+            unlink(removedIters.back());
             removedIters.pop_back();
         }
     }
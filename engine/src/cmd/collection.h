@@ -6,7 +6,6 @@
 #define _UNITCOLLECTION_H_
 
 #include <cstddef>
-#include <list>
 #include <vector>
 
 class Unit;
@@ -19,10 +18,20 @@ class Unit;
  * Currently, you dont assign one collection to another.
  * You're not supposed to hold references to the list across physics frames
  * UnitCollection is designed to be robust to at least 20,000 units.
+ *
+ * It is a linked list whose nodes live in one array and link by index. Positions never move while
+ * held, so iterators survive inserts and removals as they would on a std::list, but units added
+ * in order sit next to each other in memory and a walk is a mostly linear scan. Once inserts in the
+ * middle and removals have scattered the order, the array is rewritten in list order the next time
+ * an iterator is created while no ConstIterator is out (see compact()).
  */
 class UnitCollection
 {
   public:
+    /* Index of a node; End is the sentinel before the first and after the last unit */
+    typedef unsigned int Position;
+    static const Position End = 0;
+
     /*
      * UnitIterator is the "node" class for UnitCollection.
      * It's meant to mimic std::iterator's for the most part, but
@@ -33,7 +42,7 @@ class UnitCollection
     class UnitIterator
     {
       public:
-        UnitIterator() : col(nullptr)
+        UnitIterator() : col(nullptr), it(End)
         {
         }
         UnitIterator(const UnitIterator &);
@@ -42,11 +51,7 @@ class UnitCollection
 
         inline bool isDone()
         {
-            if (col && it != col->units.end())
-            {
-                return false;
-            }
-            return true;
+            return !col || it == End;
         }
 
         /*   Request the current unit to be removed */
@@ -85,9 +90,9 @@ class UnitCollection
         }
         inline Unit *operator*()
         {
-            if (col && it != col->units.end())
+            if (col && it != End)
             {
-                return *it;
+                return col->nodes[it].unit;
             }
             return nullptr;
         }
@@ -98,18 +103,19 @@ class UnitCollection
         UnitCollection *col;
 
         // Current position in the list
-        std::list<class Unit *>::iterator it;
+        Position it;
     };
 
     /* This class is to be used when no changes to the list are made
      * and the iterator doesn't persist across physics frames.
      * that is to say, these should only be used as temporary iterators
      * in loops where the list is not modified.
+     * It must not outlive its collection: while one is out the collection is not compacted.
      */
     class ConstIterator
     {
       public:
-        ConstIterator() : col(nullptr)
+        ConstIterator() : col(nullptr), it(End)
         {
         }
         ConstIterator(const ConstIterator &);
@@ -124,20 +130,16 @@ class UnitCollection
 
         inline bool isDone()
         {
-            if (col && it != col->units.end())
-            {
-                return false;
-            }
-            return true;
+            return !col || it == End;
         }
         void advance();
         const ConstIterator &operator++();
         const ConstIterator operator++(int);
         inline Unit *operator*() const
         {
-            if (it != col->units.end() && !col->empty())
+            if (col && it != End)
             {
-                return *it;
+                return col->nodes[it].unit;
             }
             return nullptr;
         }
@@ -145,7 +147,7 @@ class UnitCollection
       protected:
         friend class UnitCollection;
         const UnitCollection *col;
-        std::list<class Unit *>::const_iterator it;
+        Position it;
     };
 
     /* backwards compatibility only.  Typedefs suck. dont use them. */
@@ -182,18 +184,7 @@ class UnitCollection
     void insert_unique(Unit *);
     inline bool empty() const
     {
-        if (units.empty())
-        {
-            return true;
-        }
-        else if (removedIters.empty() || units.size() > removedIters.size())
-        {
-            return false;
-        }
-        else
-        {
-            return true;
-        }
+        return count == removedIters.size();
     }
 
     // Add a unit or iterator to the front of the list. */
@@ -205,7 +196,7 @@ class UnitCollection
     void append(UnitIterator *);
 
     /* This is how iterators insert units. Always inserts before iterator */
-    void insert(std::list<Unit *>::iterator &, Unit *);
+    void insert(Position &, Unit *);
 
     /* Whipes out entire list only if no iterators are being held.
      * No code uses this function as of 0.5 release */
@@ -222,7 +213,7 @@ class UnitCollection
      * The reason for this is so we can be scalable to 20,000+ units and
      * modifications to the list by multiple held iterators dont bog us down
      */
-    void erase(std::list<class Unit *>::iterator &);
+    void erase(Position &);
 
     /* traverse list and remove first (only) matching Unit.
      * Do not use in fast-path code */
@@ -231,17 +222,17 @@ class UnitCollection
     /* Returns number of non-null units in list */
     inline int size() const
     {
-        return units.size() - removedIters.size();
+        return count - removedIters.size();
     }
 
     /* Returns last non-null unit in list. May be Killed() */
     inline Unit *back()
     {
-        for (auto it = units.rbegin(); it != units.rend(); ++it)
+        for (Position it = nodes[End].prev; it != End; it = nodes[it].prev)
         {
-            if (*it)
+            if (nodes[it].unit)
             {
-                return *it;
+                return nodes[it].unit;
             }
         }
         return nullptr;
@@ -250,11 +241,11 @@ class UnitCollection
     /* Returns first non-null unit in list. May be Killed() */
     inline Unit *front()
     {
-        for (auto it = units.begin(); it != units.end(); ++it)
+        for (Position it = nodes[End].next; it != End; it = nodes[it].next)
         {
-            if (*it)
+            if (nodes[it].unit)
             {
-                return *it;
+                return nodes[it].unit;
             }
         }
         return nullptr;
@@ -264,9 +255,26 @@ class UnitCollection
     friend class UnitIterator;
     friend class ConstIterator;
 
-    /* Does not clear list.  It sets all the Unit pointers to null
-     * And sets all the current iterator's collection pointers to nullptr.
-     * Effectively shutting the list down so it can be destroyed safely. */
+    struct Node
+    {
+        Unit *unit;
+        Position prev;
+        Position next;
+    };
+
+    /* Links a new node holding unit in front of pos and returns it */
+    Position link(Position pos, Unit *unit);
+
+    /* Unlinks the node at pos, puts it on the free chain and returns the position after it.
+     * The node keeps its next, so an iterator left on it still walks on to the rest of the list */
+    Position unlink(Position pos);
+
+    /* Rewrites the nodes in list order and moves the held UnitIterators along,
+     * if enough of the list has been scattered to make it worthwhile */
+    void compact();
+
+    /* Releases every Unit, empties the list and sets all the current iterator's
+     * collection pointers to nullptr, so the list can be destroyed or refilled safely. */
     void destr();
 
     /* Nothing uses this operator as of 0.5, but maybe someday */
@@ -289,9 +297,17 @@ class UnitCollection
     /* This is a list of positions in the collection that are pointing to
      * nullptr units, positions that should be removed from the collection
      * but couldn't because another iterator was referencing it. */
-    std::vector<std::list<class Unit *>::iterator> removedIters;
-
-    /* Main collection */
-    std::list<class Unit *> units;
+    std::vector<Position> removedIters;
+
+    /* Main collection. nodes[End] is the sentinel: its next is the first node, its prev the last */
+    std::vector<Node> nodes;
+    /* Unused nodes, chained through prev; End when there are none */
+    Position freeNodes;
+    /* Linked nodes, removed ones still waiting in removedIters included */
+    unsigned int count;
+    /* Links made out of memory order since the last compaction */
+    unsigned int scattered;
+    /* ConstIterators out on this collection; they are not tracked one by one, so they block compaction */
+    mutable unsigned int constIters;
 };
 #endif
@@ -25,24 +25,121 @@
 */
 #include "CSopcodecollider.h"
 
-static std::vector<csCollisionPair> pairs;
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string.h>
+#include <thread>
+#include <unordered_map>
 
-csOPCODECollider::csOPCODECollider(const std::vector<mesh_polygon> &polygons)
+csCollisionContext::csCollisionContext()
 {
-    m_pCollisionModel = nullptr;
-    vertholder = nullptr;
     TreeCollider.SetFirstContact(true);
     TreeCollider.SetFullBoxBoxTest(false);
     TreeCollider.SetTemporalCoherence(false);
-    opcMeshInt.SetCallback(&MeshCallback, this);
-    GeometryInitialize(polygons);
-    CollisionFace collFace;
     rCollider.SetFirstContact(true);
 }
 
+csCollisionContext &csOPCODECollider::MainContext()
+{
+    static csCollisionContext context;
+    return context;
+}
+
+/*
+ * Collision geometry is welded (corners at the same position become one vertex) and indexed, and
+ * every distinct geometry is built only once: units of the same hull, or different hulls using
+ * the same collision mesh, share one vertex buffer and one tree, whatever the number of colliders
+ * made from it.  Geometry is looked up by a hash of its welded contents, and compared in full
+ * before being shared.  Colliders are only ever created on the sim thread.
+ */
+struct csCollisionGeometry
+{
+    std::vector<Point> vertices;
+    std::vector<uint32_t> indices;
+    MeshInterface opcMeshInt;
+    Model model;
+    size_t hash;
+
+    static void MeshCallback(uint32_t triangle_index, VertexPointers &triangle, void *user_data)
+    {
+        const csCollisionGeometry *geometry = (const csCollisionGeometry *)user_data;
+        const uint32_t *index = &geometry->indices[3 * triangle_index];
+        triangle.Vertex[0] = &geometry->vertices[index[0]];
+        triangle.Vertex[1] = &geometry->vertices[index[1]];
+        triangle.Vertex[2] = &geometry->vertices[index[2]];
+    }
+};
+
+namespace
+{
+struct WeldKey
+{
+    uint32_t bits[3];
+    bool operator==(const WeldKey &o) const
+    {
+        return bits[0] == o.bits[0] && bits[1] == o.bits[1] && bits[2] == o.bits[2];
+    }
+};
+
+struct WeldKeyHash
+{
+    size_t operator()(const WeldKey &k) const
+    {
+        return (size_t)k.bits[0] * 73856093u ^ (size_t)k.bits[1] * 19349663u ^ (size_t)k.bits[2] * 83492791u;
+    }
+};
+
+typedef std::unordered_multimap<size_t, std::weak_ptr<csCollisionGeometry>> GeometryMap;
+
+// Never destroyed, as colliders held by other statics may outlive it
+GeometryMap &sharedGeometry()
+{
+    static GeometryMap *geometries = new GeometryMap;
+    return *geometries;
+}
+
+size_t hashGeometry(const std::vector<Point> &vertices, const std::vector<uint32_t> &indices)
+{
+    size_t hash = vertices.size() * 31 + indices.size();
+    std::hash<std::string> hasher;
+    if (!vertices.empty())
+        hash ^= hasher(std::string((const char *)&vertices[0], vertices.size() * sizeof(Point))) + (hash << 6);
+    if (!indices.empty())
+        hash ^= hasher(std::string((const char *)&indices[0], indices.size() * sizeof(uint32_t))) + (hash << 6);
+    return hash;
+}
+
+bool samePoints(const std::vector<Point> &a, const std::vector<Point> &b)
+{
+    return a.size() == b.size() && (a.empty() || memcmp(&a[0], &b[0], a.size() * sizeof(Point)) == 0);
+}
+
+void releaseGeometry(csCollisionGeometry *geometry)
+{
+    auto range = sharedGeometry().equal_range(geometry->hash);
+    for (auto i = range.first; i != range.second;)
+    {
+        if (i->second.expired())
+            i = sharedGeometry().erase(i);
+        else
+            ++i;
+    }
+    delete geometry;
+}
+} // namespace
+
+csOPCODECollider::csOPCODECollider(const std::vector<mesh_polygon> &polygons)
+{
+    m_pCollisionModel = nullptr;
+    vertholder = nullptr;
+    indices = nullptr;
+    GeometryInitialize(polygons);
+}
+
 void csOPCODECollider::GeometryInitialize(const std::vector<mesh_polygon> &polygons)
 {
-    OPCODECREATE OPCC;
     unsigned int tri_count = 0;
     std::vector<Vector>::size_type vert_count = 0;
     for (std::vector<mesh_polygon>::size_type i = 0; i < polygons.size(); ++i)
@@ -50,88 +147,93 @@ void csOPCODECollider::GeometryInitialize(const std::vector<mesh_polygon> &polyg
         vert_count += polygons[i].v.size();
     }
     tri_count = vert_count / 3;
-    if (tri_count)
+    if (!tri_count)
     {
-        m_pCollisionModel = new Model;
-        if (!m_pCollisionModel)
-        {
-            return;
-        }
-
-        vertholder = new Point[vert_count];
-
-        csBox3 tmp;
-        tmp.StartBoundingBox();
-        uint32_t last = 0;
+        return;
+    }
 
-        /* Copies the Vector's in mesh_polygon to Point's in vertholder.
-         * This sucks but i dont see anyway around it */
-        for (std::vector<mesh_polygon>::size_type i = 0; i < polygons.size(); ++i)
+    /* Welds the corners of the polygons, which were all distinct Point's before */
+    std::vector<Point> vertices;
+    std::vector<uint32_t> corner_indices;
+    vertices.reserve(vert_count / 2);
+    corner_indices.reserve(tri_count * 3);
+    std::unordered_map<WeldKey, uint32_t, WeldKeyHash> welded;
+    welded.reserve(vert_count);
+    for (std::vector<mesh_polygon>::size_type i = 0; i < polygons.size(); ++i)
+    {
+        const mesh_polygon *p = (&polygons[i]);
+        for (std::vector<Vector>::size_type j = 0; j < p->v.size() && corner_indices.size() < tri_count * 3; ++j)
         {
-            const mesh_polygon *p = (&polygons[i]);
-            for (std::vector<Vector>::size_type j = 0; j < p->v.size(); ++j)
-            {
-                vertholder[last++].Set(p->v[j].i, p->v[j].j, p->v[j].k);
-                tmp.AddBoundingVertex(p->v[j]);
-            }
+            Point point(p->v[j].i, p->v[j].j, p->v[j].k);
+            WeldKey key;
+            memcpy(key.bits, &point, sizeof(key.bits));
+            auto found = welded.insert(std::make_pair(key, (uint32_t)vertices.size()));
+            if (found.second)
+                vertices.push_back(point);
+            corner_indices.push_back(found.first->second);
         }
-        radius = std::max({tmp.MaxX() - tmp.MinX(), tmp.MaxY() - tmp.MinY(), tmp.MaxZ() - tmp.MinZ()});
-        opcMeshInt.SetNbTriangles(tri_count);
-        opcMeshInt.SetNbVertices(last);
+    }
+
+    size_t hash = hashGeometry(vertices, corner_indices);
+    auto range = sharedGeometry().equal_range(hash);
+    for (auto i = range.first; i != range.second && !geometry; ++i)
+    {
+        std::shared_ptr<csCollisionGeometry> candidate = i->second.lock();
+        if (candidate && candidate->indices == corner_indices && samePoints(candidate->vertices, vertices))
+            geometry = candidate;
+    }
+    if (!geometry)
+    {
+        geometry.reset(new csCollisionGeometry, releaseGeometry);
+        geometry->hash = hash;
+        geometry->vertices.swap(vertices);
+        geometry->indices.swap(corner_indices);
+        geometry->opcMeshInt.SetCallback(&csCollisionGeometry::MeshCallback, geometry.get());
+        geometry->opcMeshInt.SetNbTriangles(tri_count);
+        geometry->opcMeshInt.SetNbVertices(geometry->vertices.size());
 
         // Mesh data
-        OPCC.mIMesh = &opcMeshInt;
+        OPCODECREATE OPCC;
+        OPCC.mIMesh = &geometry->opcMeshInt;
         OPCC.mSettings.mRules = SPLIT_SPLATTER_POINTS | SPLIT_GEOM_CENTER;
         /* NoLeaf and quantized creates an optimized, both in organization and
          * memory overhead, tree.*/
         OPCC.mNoLeaf = true;
         OPCC.mQuantized = true;
+        // bool status = m_pCollisionModel->Build (OPCC);
+        geometry->model.Build(OPCC);
+        sharedGeometry().insert(std::make_pair(hash, std::weak_ptr<csCollisionGeometry>(geometry)));
     }
-    else
-    {
-        return;
-    }
-
-    // bool status = m_pCollisionModel->Build (OPCC);
-    m_pCollisionModel->Build(OPCC);
+    m_pCollisionModel = &geometry->model;
+    vertholder = &geometry->vertices[0];
+    indices = &geometry->indices[0];
 }
 
 csOPCODECollider::~csOPCODECollider()
 {
-
-    if (m_pCollisionModel)
-    {
-        delete m_pCollisionModel;
-        m_pCollisionModel = nullptr;
-    }
-    delete[] vertholder;
 }
 
-void csOPCODECollider::MeshCallback(uint32_t triangle_index, VertexPointers &triangle, void *user_data)
+bool csOPCODECollider::rayCollide(const Ray &boltbeam, Vector &norm, float &distance)
 {
-    csOPCODECollider *collider = (csOPCODECollider *)user_data;
-    Point *vertholder = collider->vertholder;
-    int32_t index = 3 * triangle_index;
-    triangle.Vertex[0] = &vertholder[index];
-    triangle.Vertex[1] = &vertholder[index + 1];
-    triangle.Vertex[2] = &vertholder[index + 2];
+    return rayCollide(boltbeam, norm, distance, MainContext());
 }
 
-bool csOPCODECollider::rayCollide(const Ray &boltbeam, Vector &norm, float &distance)
+bool csOPCODECollider::rayCollide(const Ray &boltbeam, Vector &norm, float &distance, csCollisionContext &context)
 {
+    RayCollider &rCollider = context.rCollider;
     rCollider.SetHitCallback(&csOPCODECollider::RayCallback);
-    rCollider.SetUserData(this);
+    rCollider.SetUserData(&context);
     rCollider.SetFirstContact(false);
     // rCollider.SetClosestHit(true);
-    collFace.mDistance = FLT_MAX;
+    context.collFace.mDistance = FLT_MAX;
     bool retval = rCollider.Collide(boltbeam, *m_pCollisionModel);
     rCollider.SetUserData(nullptr);
     if (retval)
     {
-        retval = collFace.mDistance != FLT_MAX;
+        retval = context.collFace.mDistance != FLT_MAX;
         if (retval)
         {
-            distance = collFace.mDistance;
+            distance = context.collFace.mDistance;
 #ifdef VS_DEBUG
             printf("Opcode actually reported a hit at %f meters!\n", distance);
 #endif
@@ -148,20 +250,41 @@ bool csOPCODECollider::rayCollide(const Ray &boltbeam, Vector &norm, float &dist
 
 void csOPCODECollider::RayCallback(const CollisionFace &faceHit, void *user_data)
 {
-    csOPCODECollider *collider = (csOPCODECollider *)user_data;
-    if (collider)
+    csCollisionContext *context = (csCollisionContext *)user_data;
+    if (context)
     {
-        if (collider->collFace.mDistance > faceHit.mDistance)
+        if (context->collFace.mDistance > faceHit.mDistance)
         {
-            collider->collFace = faceHit;
+            context->collFace = faceHit;
         }
     }
 }
 
 bool csOPCODECollider::Collide(csOPCODECollider &otherCollider, const csReversibleTransform *trans1,
                                const csReversibleTransform *trans2)
+{
+    return Collide(otherCollider, trans1, trans2, MainContext());
+}
+
+bool csOPCODECollider::Collide(csOPCODECollider &otherCollider, const csReversibleTransform *trans1,
+                               const csReversibleTransform *trans2, csCollisionContext &context, BVTCache *coherence)
 {
     csOPCODECollider *col2 = (csOPCODECollider *)&otherCollider;
+    BVTCache &ColCache = coherence ? *coherence : context.ColCache;
+    AABBTreeCollider &TreeCollider = context.TreeCollider;
+    if (!this->m_pCollisionModel || !col2->m_pCollisionModel)
+    {
+        return (false);
+    }
+    if (ColCache.Model0 != this->m_pCollisionModel || ColCache.Model1 != col2->m_pCollisionModel ||
+        ColCache.id0 >= this->m_pCollisionModel->GetMeshInterface()->GetNbTriangles() ||
+        ColCache.id1 >= col2->m_pCollisionModel->GetMeshInterface()->GetNbTriangles())
+    {
+        // The remembered triangles belong to other meshes
+        ColCache.ResetCache();
+        ColCache.id1 = 0;
+    }
+    TreeCollider.SetTemporalCoherence(coherence != nullptr);
     ColCache.Model0 = this->m_pCollisionModel;
     ColCache.Model1 = col2->m_pCollisionModel;
     csMatrix3 m1;
@@ -237,7 +360,7 @@ bool csOPCODECollider::Collide(csOPCODECollider &otherCollider, const csReversib
         bool status = (TreeCollider.GetContactStatus() != false);
         if (status)
         {
-            CopyCollisionPairs(this, col2);
+            CopyCollisionPairs(context, this, col2);
         }
         return (status);
     }
@@ -247,19 +370,48 @@ bool csOPCODECollider::Collide(csOPCODECollider &otherCollider, const csReversib
     }
 }
 
+static bool sameTransform(const csReversibleTransform &a, const csReversibleTransform &b)
+{
+    return a.GetT2O() == b.GetT2O() && a.GetO2TTranslation() == b.GetO2TTranslation();
+}
+
+bool csOPCODECollider::Collide(csOPCODECollider &otherCollider, const csReversibleTransform &trans1,
+                               const csReversibleTransform &trans2, csCollisionContext &context,
+                               csCollisionCache &cache, csCollisionPair &contact)
+{
+    if (cache.tested && cache.first == this && cache.second == &otherCollider &&
+        sameTransform(cache.firstTransform, trans1) && sameTransform(cache.secondTransform, trans2))
+    {
+        if (cache.hit)
+            contact = cache.contact;
+        return cache.hit;
+    }
+    context.pairs.clear();
+    bool hit = Collide(otherCollider, &trans1, &trans2, context, &cache.bvt) && !context.pairs.empty();
+    if (hit)
+        contact = cache.contact = context.pairs[0];
+    cache.tested = true;
+    cache.first = this;
+    cache.second = &otherCollider;
+    cache.firstTransform = trans1;
+    cache.secondTransform = trans2;
+    cache.hit = hit;
+    return hit;
+}
+
 void csOPCODECollider::ResetCollisionPairs()
 {
-    pairs.clear();
+    MainContext().pairs.clear();
 }
 
 csCollisionPair *csOPCODECollider::GetCollisions()
 {
-    return (pairs.data());
+    return (MainContext().pairs.data());
 }
 
 size_t csOPCODECollider::GetCollisionPairCount()
 {
-    return (pairs.size());
+    return (MainContext().pairs.size());
 }
 
 Vector csOPCODECollider::getVertex(unsigned int which) const
@@ -272,13 +424,15 @@ Vector csOPCODECollider::getVertex(unsigned int which) const
     return (Vector(vertholder[which].x, vertholder[which].y, vertholder[which].z));
 }
 
-void csOPCODECollider::CopyCollisionPairs(csOPCODECollider *col1, csOPCODECollider *col2)
+void csOPCODECollider::CopyCollisionPairs(csCollisionContext &context, csOPCODECollider *col1,
+                                          csOPCODECollider *col2)
 {
     if (!col1 || !col2)
     {
         return;
     }
 
+    const AABBTreeCollider &TreeCollider = context.TreeCollider;
     uint32_t N_pairs = TreeCollider.GetNbPairs();
     if (N_pairs == 0)
     {
@@ -286,24 +440,132 @@ void csOPCODECollider::CopyCollisionPairs(csOPCODECollider *col1, csOPCODECollid
     }
 
     const Pair *colPairs = TreeCollider.GetPairs();
-    Point *vertholder0 = col1->vertholder;
-    Point *vertholder1 = col2->vertholder;
-    int32_t j;
+    const Point *vertholder0 = col1->vertholder;
+    const Point *vertholder1 = col2->vertholder;
+    const uint32_t *j;
+    std::vector<csCollisionPair> &pairs = context.pairs;
     size_t oldlen = pairs.size();
     if (oldlen == 0)
     {
         return;
     }
+    pairs.resize(oldlen + N_pairs);
     for (uint32_t i = 0; i < N_pairs; ++i)
     {
-        j = 3 * colPairs[i].id0;
-        pairs[oldlen].a1 = vertholder0[j];
-        pairs[oldlen].b1 = vertholder0[j + 1];
-        pairs[oldlen].c1 = vertholder0[j + 2];
-        j = 3 * colPairs[i].id1;
-        pairs[oldlen].a2 = vertholder1[j];
-        pairs[oldlen].b2 = vertholder1[j + 1];
-        pairs[oldlen].c2 = vertholder1[j + 2];
+        j = &col1->indices[3 * colPairs[i].id0];
+        pairs[oldlen].a1 = vertholder0[j[0]];
+        pairs[oldlen].b1 = vertholder0[j[1]];
+        pairs[oldlen].c1 = vertholder0[j[2]];
+        j = &col2->indices[3 * colPairs[i].id1];
+        pairs[oldlen].a2 = vertholder1[j[0]];
+        pairs[oldlen].b2 = vertholder1[j[1]];
+        pairs[oldlen].c2 = vertholder1[j[2]];
         ++oldlen;
     }
 }
+
+/*
+ * CollideBatch worker pool.  Queries are handed out by chain (a query and the
+ * alternatives following it) through an atomic counter; every thread keeps its
+ * own context.  Workers are started on first use and never stop.
+ */
+namespace
+{
+std::mutex batch_mutex;
+std::condition_variable batch_start;
+std::condition_variable batch_done;
+std::vector<csCollisionQuery> *batch_queries = nullptr;
+std::vector<size_t> batch_chains; // index of the first query of every chain
+std::atomic<size_t> batch_next(0);
+unsigned int batch_generation = 0;
+unsigned int batch_workers = 0;
+unsigned int batch_joined = 0; // workers that picked up the current generation
+unsigned int batch_busy = 0;
+
+void resolveQuery(csCollisionQuery &query, csCollisionContext &context)
+{
+    if (query.cache && query.first && query.second)
+    {
+        query.hit = query.first->Collide(*query.second, query.firstTransform, query.secondTransform, context,
+                                         *query.cache, query.contact);
+        return;
+    }
+    context.pairs.clear();
+    query.hit = query.first && query.second &&
+                query.first->Collide(*query.second, &query.firstTransform, &query.secondTransform, context) &&
+                !context.pairs.empty();
+    if (query.hit)
+        query.contact = context.pairs[0];
+}
+
+void resolveChains(csCollisionContext &context)
+{
+    std::vector<csCollisionQuery> &queries = *batch_queries;
+    for (size_t chain; (chain = batch_next++) < batch_chains.size();)
+    {
+        size_t end = chain + 1 < batch_chains.size() ? batch_chains[chain + 1] : queries.size();
+        bool hit = false;
+        for (size_t i = batch_chains[chain]; i < end; ++i)
+        {
+            if (hit)
+            {
+                queries[i].hit = false;
+                continue;
+            }
+            resolveQuery(queries[i], context);
+            hit = queries[i].hit;
+        }
+    }
+}
+
+void batchWorker()
+{
+    csCollisionContext context;
+    unsigned int seen = 0;
+    std::unique_lock<std::mutex> lock(batch_mutex);
+    for (;;)
+    {
+        batch_start.wait(lock, [&seen] { return batch_generation != seen; });
+        seen = batch_generation;
+        ++batch_joined;
+        ++batch_busy;
+        lock.unlock();
+
+        resolveChains(context);
+
+        lock.lock();
+        --batch_busy;
+        batch_done.notify_all();
+    }
+}
+} // namespace
+
+void csOPCODECollider::CollideBatch(std::vector<csCollisionQuery> &queries, unsigned int threads)
+{
+    std::vector<size_t> chains;
+    for (size_t i = 0; i < queries.size(); ++i)
+        if (i == 0 || !queries[i].alternative)
+            chains.push_back(i);
+    threads = std::min<size_t>(threads, chains.size());
+    std::unique_lock<std::mutex> lock(batch_mutex);
+    batch_queries = &queries;
+    batch_chains.swap(chains);
+    batch_next = 0;
+    if (threads > 1)
+    {
+        for (; batch_workers < threads - 1; ++batch_workers)
+            std::thread(batchWorker).detach();
+        ++batch_generation;
+        batch_joined = 0;
+        batch_start.notify_all();
+    }
+    lock.unlock();
+
+    resolveChains(MainContext());
+
+    lock.lock();
+    if (threads > 1)
+        // Every worker has to have seen this batch before the next one may reuse the shared state
+        batch_done.wait(lock, [] { return batch_joined == batch_workers && batch_busy == 0; });
+    batch_queries = nullptr;
+}
@@ -35,6 +35,8 @@
 #include "csgeom2/optransfrm.h"
 #include "csgeom2/opvector3.h"
 #include "gfx/mesh.h"
+#include <memory>
+#include <vector>
 
 /*
     How to use Collider.
@@ -64,44 +66,106 @@
     We also need the number of collided vectors in case we dont have
     first hit set to true.
     csOPCodeCollider.GetCollisionPairCount();
+
+    The calls above share one context and may only be made from the sim
+    thread.  Code running elsewhere passes its own csCollisionContext to
+    Collide and rayCollide and reads the pairs out of it instead, and
+    CollideBatch resolves a whole list of queries on several threads.
 */
 
+class csOPCODECollider;
+
+/* Scratch state and results of narrowphase queries.  Colliders are only read
+ * while colliding, so any number of threads can test the same colliders as
+ * long as each one uses its own context. */
+class csCollisionContext
+{
+  public:
+    csCollisionContext();
+
+    /* Collider type: Tree - Used primarily for mesh on mesh collisions */
+    AABBTreeCollider TreeCollider;
+    BVTCache ColCache;
+
+    /* Collider type: Ray - used to check if a ray collided with a tree */
+    RayCollider rCollider;
+    CollisionFace collFace;
+
+    /* Triangle pairs found by Collide, appended to until cleared */
+    std::vector<csCollisionPair> pairs;
+};
+
+/* What a pair of colliders found the last time they were tested against each
+ * other, for callers that keep it from one frame to the next */
+struct csCollisionCache
+{
+    csCollisionCache() : tested(false), first(nullptr), second(nullptr), hit(false)
+    {
+    }
+
+    /* Last colliding pair of triangles, tested before descending the trees
+     * (OPCODE temporal coherence) */
+    BVTCache bvt;
+
+    /* The last query, whose result stands as long as neither collider moved */
+    bool tested;
+    const csOPCODECollider *first;
+    const csOPCODECollider *second;
+    csReversibleTransform firstTransform;
+    csReversibleTransform secondTransform;
+    bool hit;
+    csCollisionPair contact;
+};
+
+/* One mesh on mesh test of a batch */
+struct csCollisionQuery
+{
+    csOPCODECollider *first;
+    csOPCODECollider *second;
+    csReversibleTransform firstTransform;
+    csReversibleTransform secondTransform;
+    /* Only tested when the query before it in the batch missed, so that a chain
+     * of queries stops at its first hit, as a serial search would */
+    bool alternative;
+    /* Optional; no two queries of a batch may share one */
+    csCollisionCache *cache;
+
+    /* Results: whether the meshes touch, and the first pair of triangles that do */
+    bool hit;
+    csCollisionPair contact;
+};
+
+/* Welded triangles and the tree built over them, shared by all the colliders
+ * made from the same geometry (see CSopcodecollider.cpp) */
+struct csCollisionGeometry;
+
 // Low level collision detection using Opcode library.
 class csOPCODECollider
 {
   private:
-    /* does what it says.  Takes our mesh_polygon vector and turns it into
-     * a linear list of vertexes that we reference in collision trees
-     * radius is set in here as well
-     */
+    /* does what it says.  Takes our mesh_polygon vector, welds it into a list
+     * of distinct vertices and an index list of triangles, and builds the
+     * collision tree, unless a collider with the same geometry already did */
     void GeometryInitialize(const std::vector<mesh_polygon> &polygons);
 
-    /* callback used to return vertex points when requested from opcode*/
-    static void MeshCallback(uint32_t triangle_index, VertexPointers &triangle, void *user_data);
-
-    /* returns face of mesh where ray collided */
+    /* returns face of mesh where ray collided, user_data is the csCollisionContext */
     static void RayCallback(const CollisionFace &, void *);
 
-    /* Radius around unit using center of unit and furthest part of unit */
-    float radius;
+    std::shared_ptr<csCollisionGeometry> geometry;
 
-    /* Array of Point's corresponding to vertices of triangles given by mesh_polygon */
-    Point *vertholder;
+    /* Distinct vertices of the mesh, and 3 indices into them per triangle */
+    const Point *vertholder;
+    const uint32_t *indices;
 
-    /* OPCODE interfaces. */
+    /* OPCODE interfaces, owned by the geometry. */
     Model *m_pCollisionModel;
-    MeshInterface opcMeshInt;
-    BVTCache ColCache;
-    CollisionFace collFace;
-    /* Collider type: Tree - Used primarily for mesh on mesh collisions */
-    AABBTreeCollider TreeCollider;
-
-    /* Collider type: Ray - used to check if a ray collided with the tree collider above */
-    RayCollider rCollider;
 
     /* We have to copy our Points to csVector3's because opcode likes Point
      * and VS likes Vector.  */
-    void CopyCollisionPairs(csOPCODECollider *col1, csOPCODECollider *col2);
+    static void CopyCollisionPairs(csCollisionContext &context, csOPCODECollider *col1, csOPCODECollider *col2);
+
+    /* The context used by the calls that don't take one */
+    static csCollisionContext &MainContext();
 
   public:
     csOPCODECollider(const std::vector<mesh_polygon> &polygons);
@@ -109,12 +173,27 @@ class csOPCODECollider
 
     /* Collides the bolt or beam with this collider, returning true if it occurred */
     bool rayCollide(const Ray &boltbeam, Vector &norm, float &distance);
+    bool rayCollide(const Ray &boltbeam, Vector &norm, float &distance, csCollisionContext &context);
 
     /* Collides the argument collider with this collider, returning true if it occurred */
     bool Collide(csOPCODECollider &pOtherCollider, const csReversibleTransform *pThisTransform = 0,
                  const csReversibleTransform *pOtherTransform = 0);
-
-    /* Returns the pair array, as of 0.5 this is a global static var
+    bool Collide(csOPCODECollider &pOtherCollider, const csReversibleTransform *pThisTransform,
+                 const csReversibleTransform *pOtherTransform, csCollisionContext &context,
+                 BVTCache *coherence = nullptr);
+
+    /* Same as Collide with a context, but answers from cache when neither collider
+     * moved since it was filled, and keeps it up to date otherwise.  Returns
+     * whether there is a contact, which is then stored in contact */
+    bool Collide(csOPCODECollider &pOtherCollider, const csReversibleTransform &thisTransform,
+                 const csReversibleTransform &otherTransform, csCollisionContext &context, csCollisionCache &cache,
+                 csCollisionPair &contact);
+
+    /* Resolves every query of the batch, using up to threads threads (the calling
+     * one included).  The results are the same as testing the queries one by one */
+    static void CollideBatch(std::vector<csCollisionQuery> &queries, unsigned int threads);
+
+    /* Returns the pair array of the sim thread's context.
      * The pair array contains the vertices that have collided as returned
      * by the last collision.   This is concatenated, meaning, if it's not
      * cleared by the client code, the collisions just get pushed onto the
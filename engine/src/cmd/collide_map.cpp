@@ -141,6 +141,7 @@ template <int location_index> class UpdateBackpointers
 
 void CollideArray::flatten()
 {
+    ++generation;
     sorted.resize(count);
     max_radius.resize(count);
     size_t len = unsorted.size();
@@ -228,6 +229,7 @@ void CollideArray::flatten(CollideArray &hint)
 {
     if (location_index == Unit::UNIT_ONLY)
     {
+        ++generation;
         sorted.resize(count);
         for_each(toflattenhints.begin(), toflattenhints.end(), resizezero());
         toflattenhints.resize(count + 1);
@@ -248,6 +250,7 @@ CollideArray::iterator CollideArray::insert(const Collidable &newKey, iterator h
     if (this->begin() == this->end())
     {
         count += 1;
+        ++generation;
         this->unsorted.push_back(newKey);
         this->toflattenhints.resize(2);
         this->sorted.push_back(newKey);
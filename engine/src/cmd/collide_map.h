@@ -124,6 +124,9 @@ class CollideArray
     ResizableArray unsorted;
     std::vector<std::list<CollidableBackref>> toflattenhints;
     unsigned int count;
+    // Bumped whenever sorted is rebuilt; iterators into it, and the keys and positions behind them,
+    // stay put as long as it does not change (erase only zeroes the radius in place)
+    unsigned int generation;
     void UpdateBoltInfo(iterator iter, Collidable::CollideRef ref);
     void flatten();
     void flatten(CollideArray &example); // maybe it has some xtra bolts
@@ -142,7 +145,7 @@ class CollideArray
     iterator lower_bound(const Collidable &);
     void erase(iterator iter);
     void checkSet();
-    CollideArray(unsigned int location_index) : toflattenhints(1), count(0)
+    CollideArray(unsigned int location_index) : toflattenhints(1), count(0), generation(0)
     {
         this->location_index = location_index;
     }
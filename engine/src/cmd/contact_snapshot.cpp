@@ -0,0 +1,94 @@
+#include "contact_snapshot.h"
+#include "configxml.h"
+#include "vs_globals.h"
+#include "xml_support.h"
+
+#include <unordered_map>
+
+// Never destroyed: units may still be deleted during static destruction
+typedef std::unordered_map<const Unit *, ContactSnapshot> SnapshotMap;
+static SnapshotMap &snapshots = *new SnapshotMap;
+
+// Same walk as findObjectsFromPosition from a location in the sorted array, culled at reach on
+// both sides and keeping only the units
+void ContactSnapshot::Record(CollideMap *cm, CollideMap::iterator location, float reach)
+{
+    this->cm = cm;
+    this->generation = cm->generation;
+    this->location = location;
+    this->reach = reach;
+    contacts.clear();
+    QVector thispos = (*location)->GetPosition();
+    float thisrad = fabs((*location)->radius);
+    // A little wider than asked, so that the rounding in the locators' culls never reaches past it
+    double startkey = (*location)->getKey();
+    double window = (double)reach + 1.0;
+    CollideMap::iterator cmbegin = cm->begin();
+    CollideMap::iterator cmend = cm->end();
+    CollideMap::iterator tless = location;
+    CollideMap::iterator tmore = location + 1;
+    bool workA = tless != cmbegin;
+    bool workB = true;
+    if (workA)
+        --tless;
+    while (workA || workB)
+    {
+        if (workA && startkey - window <= (*tless)->getKey())
+        {
+            float rad = (*tless)->radius;
+            if (rad > 0)
+            {
+                Contact contact = {tless, (float)(((*tless)->GetPosition() - thispos).Magnitude() - rad - thisrad),
+                                   false};
+                contacts.push_back(contact);
+            }
+            if (tless != cmbegin)
+                tless--;
+            else
+                workA = false;
+        }
+        else
+        {
+            workA = false;
+        }
+        if (workB && tmore != cmend && startkey + window >= (*tmore)->getKey())
+        {
+            float rad = (*tmore)->radius;
+            if (rad > 0)
+            {
+                Contact contact = {tmore, (float)(((*tmore)->GetPosition() - thispos).Magnitude() - rad - thisrad),
+                                   true};
+                contacts.push_back(contact);
+            }
+            tmore++;
+        }
+        else
+        {
+            workB = false;
+        }
+    }
+}
+
+const ContactSnapshot *ContactSnapshot::Get(CollideMap *cm, const Unit *un, float reach)
+{
+    static bool shared = XMLSupport::parse_bool(vs_config->getVariable("AI", "shared_contact_snapshot", "true"));
+    CollideMap::iterator location = un->location[Unit::UNIT_ONLY];
+    // Units added since the last flatten still sit in the hint lists, where keys move
+    if (!shared || is_null(location) || !cm->Iterable(location))
+        return nullptr;
+    ContactSnapshot &snapshot = snapshots[un];
+    if (snapshot.cm != cm || snapshot.generation != cm->generation || snapshot.location != location ||
+        snapshot.reach < reach)
+    {
+        // Keep the widest search any caller made, so the next frame records once for all of them
+        if (snapshot.cm == cm && snapshot.reach > reach)
+            reach = snapshot.reach;
+        snapshot.Record(cm, location, reach);
+    }
+    return &snapshot;
+}
+
+void ContactSnapshot::Forget(const Unit *un)
+{
+    snapshots.erase(un);
+}
@@ -0,0 +1,69 @@
+#ifndef _CMD_CONTACT_SNAPSHOT_H_
+#define _CMD_CONTACT_SNAPSHOT_H_
+
+#include "unit_find.h"
+#include <vector>
+
+/**
+ * The units around one unit in the collide map, in the order the findObjects walk meets them
+ * and with the distances it would compute. The radar, the player's HUD and FireAt all walk the
+ * map outwards from the same ship, often several times in a frame; the first of them records
+ * the walk and the others replay it.
+ *
+ * A snapshot holds until the map is flattened again, the unit moves to another map entry or a
+ * wider search than the recorded one is asked for. Units erased from the map since are skipped
+ * on replay, so a replay hands the locator exactly what findObjects would.
+ */
+class ContactSnapshot
+{
+    struct Contact
+    {
+        CollideMap::iterator iter;
+        float distance;
+        bool more; // on the tmore side of the walk
+    };
+    CollideMap *cm;
+    unsigned int generation;
+    CollideMap::iterator location;
+    float reach;
+    std::vector<Contact> contacts;
+
+    void Record(CollideMap *cm, CollideMap::iterator location, float reach);
+    /// nullptr when un cannot be looked up from a snapshot in cm
+    static const ContactSnapshot *Get(CollideMap *cm, const Unit *un, float reach);
+
+  public:
+    ContactSnapshot() : cm(nullptr), generation(0), location(nullptr), reach(0)
+    {
+    }
+    /// Same as findObjects(cm, un->location[Unit::UNIT_ONLY], check)
+    template <class T> static void Find(CollideMap *cm, const Unit *un, UnitWithinRangeLocator<T> *check);
+    /// Drops the snapshot of a unit being deleted
+    static void Forget(const Unit *un);
+};
+
+template <class T> void ContactSnapshot::Find(CollideMap *cm, const Unit *un, UnitWithinRangeLocator<T> *check)
+{
+    const ContactSnapshot *snapshot = Get(cm, un, check->radius + check->maxUnitRadius);
+    if (!snapshot)
+    {
+        findObjects(cm, un->location[Unit::UNIT_ONLY], check);
+        return;
+    }
+    check->init(cm, snapshot->location);
+    bool workA = true;
+    bool workB = true;
+    for (size_t i = 0; i < snapshot->contacts.size() && (workA || workB); ++i)
+    {
+        const Contact &contact = snapshot->contacts[i];
+        bool &work = contact.more ? workB : workA;
+        if (!work)
+            continue;
+        if (contact.more ? check->cullmore(contact.iter) : check->cullless(contact.iter))
+            work = false;
+        else if ((*contact.iter)->radius > 0 && !check->acquire(contact.distance, contact.iter))
+            work = false;
+    }
+}
+
+#endif
@@ -335,6 +335,12 @@ struct UnitImages
     bool cloakglass;
     /// if the unit is a wormhole
     bool forcejump;
+    /// if the unit is a planet, this contains the long-name 'mars-station'
+    std::string fullname;
+    /// not used yet
+    StringPool::Reference target_fgid[3];
+    /// Changes whenever the upgrades on the ship change; no two units share one
+    unsigned int configstamp;
     float UpgradeVolume;
     float CargoVolume;      /// mass just makes you turn worse
     float equipment_volume; // this one should be more general--might want to apply it to radioactive goods, passengers,
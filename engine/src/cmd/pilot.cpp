@@ -3,9 +3,11 @@
 #include "cmd/unit_util.h"
 #include "configxml.h"
 #include "faction_generic.h"
+#include "savegame.h"
 #include "unit_generic.h"
 #include "universe_util.h"
 
+#include <math.h>
 #include <vector>
 
 Pilot::Pilot(int faction)
@@ -86,6 +88,67 @@ void Pilot::DoHit(Unit *parent, void *aggressor, int faction)
         }
     }
 }
+// Faction names and the ship modifiers of factions.xml do not change once the factions are loaded
+static bool isPirateFaction(int faction)
+{
+    static std::vector<signed char> pirates;
+    if ((size_t)faction >= pirates.size())
+        pirates.resize(faction + 1, -1);
+    if (pirates[faction] < 0)
+        pirates[faction] = FactionUtil::GetFactionName(faction).find("pirates") != std::string::npos;
+    return pirates[faction];
+}
+
+// Keyed by the address of the pooled name string. The cache holds a reference to each name it
+// knows, so the address stays unique to that name for as long as the entry exists.
+struct ShipRelationModifiers
+{
+    bool built;
+    std::vector<StringPool::Reference> names;
+    vsUMap<const std::string *, float> modifiers;
+    ShipRelationModifiers() : built(false)
+    {
+    }
+};
+
+static float shipRelationModifier(int faction, const Unit *target)
+{
+    static std::vector<ShipRelationModifiers> cache;
+    if ((size_t)faction >= cache.size())
+        cache.resize(faction + 1);
+    ShipRelationModifiers &entry = cache[faction];
+    if (!entry.built)
+    {
+        const MapStringFloat &byname = factions[faction]->ship_relation_modifier;
+        entry.names.reserve(byname.size());
+        for (MapStringFloat::const_iterator i = byname.begin(); i != byname.end(); ++i)
+        {
+            entry.names.push_back(StringPool::Reference(i->first));
+            entry.modifiers[&entry.names.back().get()] = i->second;
+        }
+        entry.built = true;
+    }
+    if (entry.modifiers.empty())
+        return 0;
+    vsUMap<const std::string *, float>::const_iterator i = entry.modifiers.find(&target->name.get());
+    return i == entry.modifiers.end() ? 0 : i->second;
+}
+
+// The modifier lives in the save data, which only changes through the save data functions
+static float fgRelationModifier(int cp, Flightgroup *fg)
+{
+    unsigned int generation = SaveGame::getMissionDataGeneration();
+    if (fg->relation_generation != generation || fg->relation_modifiers.size() != _Universe->numPlayers())
+    {
+        fg->relation_modifiers.assign(_Universe->numPlayers(), NAN);
+        fg->relation_generation = generation;
+    }
+    float &modifier = fg->relation_modifiers[cp];
+    if (isnan(modifier))
+        modifier = UniverseUtil::getFGRelationModifier(cp, fg->name);
+    return modifier;
+}
+
 float Pilot::getAnger(const Unit *parent, const Unit *target) const
 {
     relationmap::const_iterator iter = effective_relationship.find(target);
@@ -94,7 +157,7 @@ float Pilot::getAnger(const Unit *parent, const Unit *target) const
         rel = iter->second;
     if (_Universe->isPlayerStarship(target))
     {
-        if (FactionUtil::GetFactionName(faction).find("pirates") != std::string::npos)
+        if (isPirateFaction(faction))
         {
             static unsigned int cachedCargoNum = 0;
             static bool good = true;
@@ -120,12 +183,7 @@ float Pilot::getAnger(const Unit *parent, const Unit *target) const
             }
         }
     }
-    {
-        int fac = faction;
-        MapStringFloat::iterator mapiter = factions[fac]->ship_relation_modifier.find(target->name);
-        if (mapiter != factions[fac]->ship_relation_modifier.end())
-            rel += (*mapiter).second;
-    }
+    rel += shipRelationModifier(faction, target);
     {
         int parent_cp = _Universe->whichPlayerStarship(parent);
         int target_cp = _Universe->whichPlayerStarship(target);
@@ -133,14 +191,14 @@ float Pilot::getAnger(const Unit *parent, const Unit *target) const
         {
             Flightgroup *fg = target->getFlightgroup();
             if (fg)
-                rel += UniverseUtil::getFGRelationModifier(parent_cp, fg->name);
+                rel += fgRelationModifier(parent_cp, fg);
         }
         if (target_cp != -1)
         {
             //... do we count it both ways? else?
             Flightgroup *fg = parent->getFlightgroup();
             if (fg)
-                rel += UniverseUtil::getFGRelationModifier(target_cp, fg->name);
+                rel += fgRelationModifier(target_cp, fg);
         }
     }
 
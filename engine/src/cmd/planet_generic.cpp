@@ -390,7 +390,7 @@ void Planet::InitPlanet(QVector x, QVector y, float vely, const Vector &rotvel,
     // name = "Planet - ";
     // name += textname;
     name = fullname;
-    this->fullname = name;
+    pImage->fullname = name;
     this->radius = radius;
     this->gravity = gravity;
     static float densityOfRock = XMLSupport::parse_float(vs_config->getVariable("physics", "density_of_rock", "3"));
@@ -29,7 +29,7 @@ float getSaveData(int whichcp, const string &key, unsigned int num)
     {
         return 0;
     }
-    vector<float> *ans = &(_Universe->AccessCockpit(whichcp)->savegame->getMissionData(key));
+    const vector<float> *ans = &(_Universe->AccessCockpit(whichcp)->savegame->readMissionData(key));
     if (num >= ans->size())
     {
         return 0;
@@ -44,7 +44,7 @@ const vector<float> &getSaveData(int whichcp, const string &key)
     {
         return empty;
     }
-    return _Universe->AccessCockpit(whichcp)->savegame->getMissionData(key);
+    return _Universe->AccessCockpit(whichcp)->savegame->readMissionData(key);
 }
 
 string getSaveString(int whichcp, const string &key, unsigned int num)
@@ -53,7 +53,7 @@ string getSaveString(int whichcp, const string &key, unsigned int num)
     {
         return "";
     }
-    vector<std::string> *ans = &(_Universe->AccessCockpit(whichcp)->savegame->getMissionStringData(key));
+    const vector<std::string> *ans = &(_Universe->AccessCockpit(whichcp)->savegame->readMissionStringData(key));
     if (num >= ans->size())
     {
         return "";
@@ -83,6 +83,7 @@ unsigned int pushSaveData(int whichcp, const string &key, float val)
         return 0;
     }
     vector<float> *ans = &((_Universe->AccessCockpit(whichcp)->savegame->getMissionData(key)));
+    SaveGame::touchMissionData();
 
     ans->push_back(val);
     return ans->size() - 1;
@@ -95,6 +96,7 @@ unsigned int eraseSaveData(int whichcp, const string &key, unsigned int index)
         return 0;
     }
     vector<float> *ans = &((_Universe->AccessCockpit(whichcp)->savegame->getMissionData(key)));
+    SaveGame::touchMissionData();
     if (index < ans->size())
     {
 
@@ -110,6 +112,7 @@ unsigned int clearSaveData(int whichcp, const string &key)
         return 0;
     }
     vector<float> *ans = &((_Universe->AccessCockpit(whichcp)->savegame->getMissionData(key)));
+    SaveGame::touchMissionData();
     int ret = ans->size();
     if (!ret)
     {
@@ -153,6 +156,7 @@ void putSaveData(int whichcp, const string &key, unsigned int num, float val)
         return;
     }
     vector<float> *ans = &((_Universe->AccessCockpit(whichcp)->savegame->getMissionData(key)));
+    SaveGame::touchMissionData();
     if (num < ans->size())
     {
 
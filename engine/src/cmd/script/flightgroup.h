@@ -30,6 +30,9 @@ class Flightgroup
     int32_t nr_ships_left;
     int32_t nr_waves_left;
     vsUMap<std::string, std::string> ordermap;
+    // UniverseUtil::getFGRelationModifier per cockpit, NaN until asked for; see Pilot::getAnger
+    std::vector<float> relation_modifiers;
+    unsigned int relation_generation;
     // std::vector<class varInst *> *orderlist;
     // removes a ship from the flightgroup below
     void Decrement(Unit *trashed)
@@ -50,6 +53,7 @@ class Flightgroup
         nr_waves_left = nr_ships_left = nr_ships = flightgroup_nr = 0;
         leader_decision = -1;
         squadLogo = nullptr;
+        relation_generation = 0;
     }
     void Init(Flightgroup *fg, const std::string &name, const std::string &type, const std::string &faction,
               const std::string &order, int32_t num_ships, int32_t num_waves, Mission *mis)
@@ -59,6 +63,7 @@ class Flightgroup
         {
             new_fg = true;
             this->name = name;
+            this->relation_generation = 0;
             this->directive = "b";
             this->faction = faction;
         }
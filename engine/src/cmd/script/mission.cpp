@@ -44,6 +44,7 @@
 #include "mission.h"
 #include "python/python_class.h"
 #include "savegame.h"
+#include "xml_support.h"
 #include <assert.h>
 
 /* *********************************************************** */
@@ -76,6 +77,9 @@ void Mission::ConstructMission(const char *configfile, const std::string &script
     player_num = 0;
     briefing = nullptr;
     runtime.pymissions = nullptr;
+    director.everyframe = false;
+    director.sitout = 0;
+    director.waited = 0;
     nextpythonmission = nullptr;
     if (script.length() > 0)
     {
@@ -140,6 +144,7 @@ void Mission::initMission(bool loadscripts)
     }
     checkMission(top, loadscripts);
     mission_name = getVariable("mission_name", "");
+    director.everyframe = XMLSupport::parse_bool(getVariable("director_every_frame", "false"));
 }
 
 /* *********************************************************** */
@@ -644,7 +649,7 @@ void Mission::DirectorInitgame()
     }
 }
 
-void Mission::DirectorLoop()
+void Mission::DirectorDefer()
 {
     double oldgametime = gametime;
     gametime += SIMULATION_ATOM; // elapsed;
@@ -655,8 +660,14 @@ void Mission::DirectorLoop()
             gametime = SIMULATION_ATOM;
         }
     }
+}
+
+void Mission::DirectorLoop()
+{
+    DirectorDefer();
     try
     {
+        PYTHON_TIME("mission", mission_name.c_str(), nullptr);
         BriefingLoop();
         if (runtime.pymissions)
         {
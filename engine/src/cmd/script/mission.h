@@ -163,6 +163,8 @@ class Mission
     void GetOrigin(QVector &pos, string &planetname);
 
     void DirectorLoop();
+    /// Advances the game clock as DirectorLoop does, for a frame the scripts sit out
+    void DirectorDefer();
     void DirectorInitgame();
     void DirectorShipDestroyed(Unit *unit);
 
@@ -194,6 +196,13 @@ class Mission
     {
         PythonMissionBaseClass *pymissions;
     } runtime;
+    /// Scheduling of the director loop under python/director_budget_ms
+    struct DirectorSlot
+    {
+        bool everyframe;     // mission variable director_every_frame: never deferred
+        unsigned int sitout; // frames left to sit out after overrunning the budget
+        unsigned int waited; // frames since the scripts last ran
+    } director;
 
   private:
     friend void UnpickleMission(std::string pickled);
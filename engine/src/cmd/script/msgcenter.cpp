@@ -35,7 +35,9 @@
 #include <unistd.h>
 #endif
 
+#include "configxml.h"
 #include "vegastrike.h"
+#include "vs_globals.h"
 #include "xml_support.h"
 #include <expat.h>
 
@@ -46,70 +48,124 @@
 #include "msgcenter.h"
 #include <algorithm>
 
+MessageCenter::MessageCenter() : nextseq(0)
+{
+    capacity = XMLSupport::parse_int(vs_config->getVariable("general", "message_history", "1000"));
+    walk.valid = false;
+}
+
 void MessageCenter::add(string from, string to, string message, double delay)
 {
-    gameMessage msg;
+    Entry entry;
 
-    msg.from = from;
-    msg.to = to;
-    msg.message = message;
+    entry.message.from = from;
+    entry.message.to = to;
+    entry.message.message = message;
 
-    msg.time = mission->getGametime() + delay;
+    entry.message.time = mission->getGametime() + delay;
+    entry.seq = nextseq++;
 
-    messages.push_back(msg);
+    std::unordered_map<std::string, unsigned int>::iterator id = ids.find(to);
+    if (id == ids.end())
+    {
+        id = ids.insert(std::make_pair(to, (unsigned int)recipients.size())).first;
+        recipients.push_back(Recipient());
+        recipients.back().head = 0;
+    }
+    Recipient &r = recipients[id->second];
+    if (!capacity || r.ring.size() < capacity)
+    {
+        r.ring.push_back(entry);
+    }
+    else
+    {
+        r.ring[r.head] = entry;
+        r.head = (r.head + 1) % r.ring.size();
+    }
 }
-void MessageCenter::clear(const std::vector<std::string> &who, const std::vector<std::string> &whoNOT)
+
+void MessageCenter::select(const std::vector<std::string> &who, const std::vector<std::string> &whoNOT,
+                           std::vector<unsigned int> &selected) const
 {
-    if (who.empty() && whoNOT.empty())
+    selected.clear();
+    if (who.empty())
     {
-        messages.clear();
+        for (std::unordered_map<std::string, unsigned int>::const_iterator it = ids.begin(); it != ids.end(); ++it)
+            if (std::find(whoNOT.begin(), whoNOT.end(), it->first) == whoNOT.end())
+                selected.push_back(it->second);
+        return;
     }
-    for (int i = messages.size() - 1; i >= 0; i--)
+    for (size_t i = 0; i < who.size(); i++)
     {
-        if (std::find(whoNOT.begin(), whoNOT.end(), messages[i].to.get()) == whoNOT.end() &&
-            (who.empty() || std::find(who.begin(), who.end(), messages[i].to.get()) != who.end()))
-        {
-            messages.erase(messages.begin() + i);
-        }
+        std::unordered_map<std::string, unsigned int>::const_iterator it = ids.find(who[i]);
+        if (it != ids.end() && std::find(whoNOT.begin(), whoNOT.end(), who[i]) == whoNOT.end() &&
+            std::find(selected.begin(), selected.end(), it->second) == selected.end())
+            selected.push_back(it->second);
+    }
+}
+
+const MessageCenter::Entry *MessageCenter::newest(const Recipient &r, size_t n)
+{
+    size_t size = r.ring.size();
+    if (n >= size)
+        return nullptr;
+    return &r.ring[(r.head + size - 1 - n) % size];
+}
+
+void MessageCenter::clear(const std::vector<std::string> &who, const std::vector<std::string> &whoNOT)
+{
+    walk.valid = false;
+    std::vector<unsigned int> selected;
+    select(who, whoNOT, selected);
+    for (size_t i = 0; i < selected.size(); i++)
+    {
+        recipients[selected[i]].ring.clear();
+        recipients[selected[i]].head = 0;
     }
 }
+
 bool MessageCenter::last(unsigned int n, gameMessage &m, const std::vector<std::string> &who,
                          const std::vector<std::string> &whoNOT)
 {
-    if (who.empty() && whoNOT.empty())
+    if (!walk.valid || walk.seq != nextseq || n < walk.passed || walk.who != who || walk.whoNOT != whoNOT)
     {
-        int size = messages.size();
-
-        int index = size - 1 - n;
-        if (index >= 0)
-        {
-            m = messages[index];
-            return true;
-        }
-        else
-        {
+        walk.valid = true;
+        walk.seq = nextseq;
+        walk.who = who;
+        walk.whoNOT = whoNOT;
+        select(who, whoNOT, walk.selected);
+        walk.taken.assign(walk.selected.size(), 0);
+        walk.passed = 0;
+    }
+    if (walk.selected.size() == 1)
+    {
+        const Entry *entry = newest(recipients[walk.selected[0]], n);
+        if (!entry)
             return false;
-        }
+        m = entry->message;
+        return true;
     }
-    else
+    // Take the newest of the rings' heads until the n-th
+    for (;;)
     {
-        int j = 0;
-        int i = 0;
-        for (i = messages.size() - 1; i >= 0; i--)
+        const Entry *best = nullptr;
+        size_t bestk = 0;
+        for (size_t k = 0; k < walk.selected.size(); k++)
         {
-            if (std::find(whoNOT.begin(), whoNOT.end(), messages[i].to.get()) == whoNOT.end() &&
-                (who.empty() || std::find(who.begin(), who.end(), messages[i].to.get()) != who.end()))
+            const Entry *entry = newest(recipients[walk.selected[k]], walk.taken[k]);
+            if (entry && (!best || entry->seq > best->seq))
             {
-                if (j == (int)n)
-                {
-                    break;
-                }
-                j++;
+                best = entry;
+                bestk = k;
             }
         }
-        if (i < 0)
+        if (!best)
             return false;
-        m = messages[i];
-        return true;
+        ++walk.taken[bestk];
+        if (walk.passed++ == n)
+        {
+            m = best->message;
+            return true;
+        }
     }
 }
@@ -51,6 +51,7 @@
 //#include "vegastrike.h"
 
 #include "SharedPool.h"
+#include <unordered_map>
 
 class gameMessage
 {
@@ -59,15 +60,53 @@ class gameMessage
     double time;
 };
 
+/*
+ * The messages are kept per recipient, each in a ring of the last general/message_history of
+ * them (all of them when 0). Asking for the n-th last message to one recipient is a lookup in
+ * its ring; asking across recipients merges the rings by arrival, and carries on from the
+ * previous call when the callers walk the messages one by one, as they all do.
+ */
 class MessageCenter
 {
   public:
+    MessageCenter();
+    /// The n-th last message (0 is the newest) to any of who (anyone when empty) and none of whoNOT
     bool last(unsigned int n, gameMessage &m, const std::vector<std::string> &who = std::vector<std::string>(),
               const std::vector<std::string> &whoNOT = std::vector<std::string>());
     void add(string from, string to, string message, double delay = 0.0);
     void clear(const std::vector<std::string> &who = std::vector<std::string>(),
                const std::vector<std::string> &whoNOT = std::vector<std::string>());
-    vector<gameMessage> messages;
+
+  private:
+    struct Entry
+    {
+        gameMessage message;
+        unsigned long seq; // arrival order over all recipients
+    };
+    struct Recipient
+    {
+        std::vector<Entry> ring;
+        size_t head; // oldest entry once the ring is full
+    };
+    // The selection and progress of the last last() across recipients
+    struct Walk
+    {
+        bool valid;
+        unsigned long seq; // nextseq when it was taken
+        std::vector<std::string> who, whoNOT;
+        std::vector<unsigned int> selected;
+        std::vector<size_t> taken; // per selected recipient, the entries already passed
+        unsigned int passed;
+    };
+    std::unordered_map<std::string, unsigned int> ids;
+    std::vector<Recipient> recipients;
+    unsigned long nextseq;
+    size_t capacity;
+    Walk walk;
+
+    void select(const std::vector<std::string> &who, const std::vector<std::string> &whoNOT,
+                std::vector<unsigned int> &selected) const;
+    static const Entry *newest(const Recipient &r, size_t n);
 };
 
 #endif //_MSGCENTER_H_
@@ -16,6 +16,7 @@
 #include "hashtable.h"
 
 #include "configxml.h"
+#include "profiler.h"
 #include "vs_globals.h"
 #include "vsfilesystem.h"
 #include <string>
@@ -152,53 +153,43 @@ bool Unit::Inside(const QVector &target, const float radius, Vector &normal, flo
     return false;
 }
 
-bool Unit::InsideCollideTree(Unit *smaller, QVector &bigpos, Vector &bigNormal, QVector &smallpos, Vector &smallNormal,
-                             bool bigasteroid, bool smallasteroid)
+/*
+ * Appends the mesh tests InsideCollideTree makes for bigger and smaller, in the order it makes
+ * them: the two units themselves, then the subunits of the bigger one, then those of the smaller.
+ * The first of them that hits is the collision.
+ */
+static void gatherCollideTreeQueries(Unit *bigger, Unit *smaller, bool bigasteroid, bool smallasteroid,
+                                     std::vector<csCollisionQuery> &queries,
+                                     std::vector<std::pair<Unit *, Unit *>> &queryunits, CollisionCache *cache)
 {
-    if (smaller->colTrees == nullptr || this->colTrees == nullptr)
-        return false;
-    if (hull < 0)
-        return false;
-    if (smaller->colTrees->usingColTree() == false || this->colTrees->usingColTree() == false)
-        return false;
-    csOPCODECollider::ResetCollisionPairs();
-    Unit *bigger = this;
-
-    csReversibleTransform bigtransform(bigger->cumulative_transformation_matrix);
-    csReversibleTransform smalltransform(smaller->cumulative_transformation_matrix);
-    smalltransform.SetO2TTranslation(
-        csVector3(smaller->cumulative_transformation_matrix.p - bigger->cumulative_transformation_matrix.p));
-    bigtransform.SetO2TTranslation(csVector3(0, 0, 0));
-    // we're only gonna lerp the positions for speed here... gahh!
+    if (smaller->colTrees == nullptr || bigger->colTrees == nullptr)
+        return;
+    if (bigger->hull < 0)
+        return;
+    if (smaller->colTrees->usingColTree() == false || bigger->colTrees->usingColTree() == false)
+        return;
 
     // Check for shield collisions here prior to checking for mesh on mesh or ray collisions below.
     csOPCODECollider *tmpCol = smaller->colTrees->colTree(smaller, bigger->GetWarpVelocity());
-    if (tmpCol && (tmpCol->Collide(*bigger->colTrees->colTree(bigger, smaller->GetWarpVelocity()), &smalltransform,
-                                   &bigtransform)))
+    if (tmpCol)
     {
-        csCollisionPair *mycollide = csOPCODECollider::GetCollisions();
-        unsigned int numHits = csOPCODECollider::GetCollisionPairCount();
-        if (numHits)
-        {
-            smallpos.Set((mycollide[0].a1.x + mycollide[0].b1.x + mycollide[0].c1.x) / 3.0f,
-                         (mycollide[0].a1.y + mycollide[0].b1.y + mycollide[0].c1.y) / 3.0f,
-                         (mycollide[0].a1.z + mycollide[0].b1.z + mycollide[0].c1.z) / 3.0f);
-            smallpos = Transform(smaller->cumulative_transformation_matrix, smallpos);
-            bigpos.Set((mycollide[0].a2.x + mycollide[0].b2.x + mycollide[0].c2.x) / 3.0f,
-                       (mycollide[0].a2.y + mycollide[0].b2.y + mycollide[0].c2.y) / 3.0f,
-                       (mycollide[0].a2.z + mycollide[0].b2.z + mycollide[0].c2.z) / 3.0f);
-            bigpos = Transform(bigger->cumulative_transformation_matrix, bigpos);
-            csVector3 sn, bn;
-            sn.Cross(mycollide[0].b1 - mycollide[0].a1, mycollide[0].c1 - mycollide[0].a1);
-            bn.Cross(mycollide[0].b2 - mycollide[0].a2, mycollide[0].c2 - mycollide[0].a2);
-            sn.Normalize();
-            bn.Normalize();
-            smallNormal.Set(sn.x, sn.y, sn.z);
-            bigNormal.Set(bn.x, bn.y, bn.z);
-            smallNormal = TransformNormal(smaller->cumulative_transformation_matrix, smallNormal);
-            bigNormal = TransformNormal(bigger->cumulative_transformation_matrix, bigNormal);
-            return true;
-        }
+        csReversibleTransform bigtransform(bigger->cumulative_transformation_matrix);
+        csReversibleTransform smalltransform(smaller->cumulative_transformation_matrix);
+        smalltransform.SetO2TTranslation(
+            csVector3(smaller->cumulative_transformation_matrix.p - bigger->cumulative_transformation_matrix.p));
+        bigtransform.SetO2TTranslation(csVector3(0, 0, 0));
+        // we're only gonna lerp the positions for speed here... gahh!
+
+        csCollisionQuery query = csCollisionQuery();
+        query.first = tmpCol;
+        query.second = bigger->colTrees->colTree(bigger, smaller->GetWarpVelocity());
+        query.firstTransform = smalltransform;
+        query.secondTransform = bigtransform;
+        query.alternative = true;
+        query.cache = cache ? cache->Get(bigger, smaller) : nullptr;
+        query.hit = false;
+        queries.push_back(query);
+        queryunits.push_back(std::make_pair(bigger, smaller));
     }
     static float rsizelim =
         XMLSupport::parse_float(vs_config->getVariable("physics", "smallest_subunit_to_collide", ".2"));
@@ -218,9 +209,8 @@ bool Unit::InsideCollideTree(Unit *smaller, QVector &bigpos, Vector &bigNormal,
             }
             if ((un->Position() - smaller->Position()).Magnitude() <= subrad + rad)
             {
-                if ((un->InsideCollideTree(smaller, bigpos, bigNormal, smallpos, smallNormal, bigtype == ASTEROIDPTR,
-                                           smalltype == ASTEROIDPTR)))
-                    return true;
+                gatherCollideTreeQueries(un, smaller, bigtype == ASTEROIDPTR, smalltype == ASTEROIDPTR, queries,
+                                         queryunits, cache);
             }
         }
     }
@@ -236,17 +226,190 @@ bool Unit::InsideCollideTree(Unit *smaller, QVector &bigpos, Vector &bigNormal,
                 break;
             if ((un->Position() - bigger->Position()).Magnitude() <= subrad + rad)
             {
-                if ((bigger->InsideCollideTree(un, bigpos, bigNormal, smallpos, smallNormal, bigtype == ASTEROIDPTR,
-                                               smalltype == ASTEROIDPTR)))
-                    return true;
+                gatherCollideTreeQueries(bigger, un, bigtype == ASTEROIDPTR, smalltype == ASTEROIDPTR, queries,
+                                         queryunits, cache);
             }
         }
     }
     // FIXME
     // doesn't check all i*j options of subunits vs subunits
+}
+
+// Turns the first pair of touching triangles into world space contact points and normals
+static void contactPoints(const csCollisionPair &contact, Unit *bigger, Unit *smaller, QVector &bigpos,
+                          Vector &bigNormal, QVector &smallpos, Vector &smallNormal)
+{
+    smallpos.Set((contact.a1.x + contact.b1.x + contact.c1.x) / 3.0f,
+                 (contact.a1.y + contact.b1.y + contact.c1.y) / 3.0f,
+                 (contact.a1.z + contact.b1.z + contact.c1.z) / 3.0f);
+    smallpos = Transform(smaller->cumulative_transformation_matrix, smallpos);
+    bigpos.Set((contact.a2.x + contact.b2.x + contact.c2.x) / 3.0f, (contact.a2.y + contact.b2.y + contact.c2.y) / 3.0f,
+               (contact.a2.z + contact.b2.z + contact.c2.z) / 3.0f);
+    bigpos = Transform(bigger->cumulative_transformation_matrix, bigpos);
+    csVector3 sn, bn;
+    sn.Cross(contact.b1 - contact.a1, contact.c1 - contact.a1);
+    bn.Cross(contact.b2 - contact.a2, contact.c2 - contact.a2);
+    sn.Normalize();
+    bn.Normalize();
+    smallNormal.Set(sn.x, sn.y, sn.z);
+    bigNormal.Set(bn.x, bn.y, bn.z);
+    smallNormal = TransformNormal(smaller->cumulative_transformation_matrix, smallNormal);
+    bigNormal = TransformNormal(bigger->cumulative_transformation_matrix, bigNormal);
+}
+
+bool Unit::InsideCollideTree(Unit *smaller, QVector &bigpos, Vector &bigNormal, QVector &smallpos, Vector &smallNormal,
+                             bool bigasteroid, bool smallasteroid)
+{
+    std::vector<csCollisionQuery> queries;
+    std::vector<std::pair<Unit *, Unit *>> queryunits;
+    StarSystem *ss = _Universe->activeStarSystem();
+    gatherCollideTreeQueries(this, smaller, bigasteroid, smallasteroid, queries, queryunits,
+                             ss ? ss->collision_cache : nullptr);
+    // All the queries form one chain, so this stops at the first hit
+    csOPCODECollider::CollideBatch(queries, 1);
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        if (queries[i].hit)
+        {
+            contactPoints(queries[i].contact, queryunits[i].first, queryunits[i].second, bigpos, bigNormal, smallpos,
+                          smallNormal);
+            return true;
+        }
+    }
     return false;
 }
 
+struct CollisionCache::Entry
+{
+    csCollisionCache cache;
+    unsigned int lastused;
+};
+
+CollisionCache::CollisionCache() : frame(0)
+{
+}
+
+CollisionCache::~CollisionCache()
+{
+}
+
+csCollisionCache *CollisionCache::Get(const Unit *bigger, const Unit *smaller)
+{
+    std::unique_ptr<Entry> &entry = entries[std::make_pair(bigger, smaller)];
+    if (!entry)
+        entry.reset(new Entry);
+    entry->lastused = frame;
+    return &entry->cache;
+}
+
+void CollisionCache::NextFrame()
+{
+    // Entries of dead units go away the same way; a unit allocated at the address of a dead one
+    // can at worst inherit a hint that the colliders or transforms don't match
+    static unsigned int keepframes =
+        XMLSupport::parse_int(vs_config->getVariable("physics", "collision_cache_frames", "30"));
+    ++frame;
+    for (auto i = entries.begin(); i != entries.end();)
+    {
+        if (frame - i->second->lastused > keepframes)
+            i = entries.erase(i);
+        else
+            ++i;
+    }
+}
+
+static CollisionBatch *active_batch = nullptr;
+
+CollisionBatch::CollisionBatch(unsigned int threads) : threads(threads), active(threads > 1 && !active_batch)
+{
+    if (active)
+        active_batch = this;
+}
+
+CollisionBatch::~CollisionBatch()
+{
+    Resolve();
+}
+
+CollisionBatch *CollisionBatch::Active()
+{
+    return active_batch;
+}
+
+void CollisionBatch::Defer(Unit *bigger, Unit *smaller, bool usecoltree)
+{
+    Pending p;
+    p.bigger = bigger;
+    p.smaller = smaller;
+    p.usecoltree = usecoltree;
+    p.simulation_atom = SIMULATION_ATOM;
+    p.firstquery = queries.size();
+    if (usecoltree)
+    {
+        StarSystem *ss = _Universe->activeStarSystem();
+        gatherCollideTreeQueries(bigger, smaller, false, false, queries, queryunits,
+                                 ss ? ss->collision_cache : nullptr);
+    }
+    p.endquery = queries.size();
+    // A pair can be found twice in a frame (once from each unit); its cached state may only be used by one
+    // query of the batch, as they might run at the same time
+    for (size_t i = p.firstquery; i < p.endquery; ++i)
+        if (queries[i].cache && !claimed.insert(queries[i].cache).second)
+            queries[i].cache = nullptr;
+    // Each pair's queries are a chain of their own
+    if (p.endquery > p.firstquery)
+        queries[p.firstquery].alternative = false;
+    pending.push_back(p);
+}
+
+void CollisionBatch::Resolve()
+{
+    if (!active)
+        return;
+    active = false;
+    active_batch = nullptr;
+    csOPCODECollider::CollideBatch(queries, threads);
+    float backup = SIMULATION_ATOM;
+    for (size_t i = 0; i < pending.size(); ++i)
+    {
+        Unit *bigger = pending[i].bigger;
+        Unit *smaller = pending[i].smaller;
+        // An earlier reaction of this batch may have killed one of them
+        if (bigger->Killed() || smaller->Killed())
+            continue;
+        SIMULATION_ATOM = pending[i].simulation_atom;
+        if (pending[i].usecoltree)
+        {
+            for (size_t q = pending[i].firstquery; q < pending[i].endquery; ++q)
+            {
+                if (queries[q].hit)
+                {
+                    QVector bigpos, smallpos;
+                    Vector bigNormal, smallNormal;
+                    contactPoints(queries[q].contact, queryunits[q].first, queryunits[q].second, bigpos, bigNormal,
+                                  smallpos, smallNormal);
+                    if (!bigger->isDocked(smaller) && !smaller->isDocked(bigger))
+                        bigger->reactToCollision(smaller, bigpos, bigNormal, smallpos, smallNormal, 10);
+                    break;
+                }
+            }
+        }
+        else
+        {
+            Vector normal(-1, -1, -1);
+            float dist = 0.0;
+            if (bigger->Inside(smaller->Position(), smaller->rSize(), normal, dist))
+                if (!bigger->isDocked(smaller) && !smaller->isDocked(bigger))
+                    bigger->reactToCollision(smaller, bigger->Position(), normal, smaller->Position(), -normal, dist);
+        }
+    }
+    SIMULATION_ATOM = backup;
+    pending.clear();
+    claimed.clear();
+    queries.clear();
+    queryunits.clear();
+}
+
 inline float mysqr(float a)
 {
     return a * a;
@@ -269,12 +432,11 @@ bool Unit::Collide(Unit *target)
         return false;
     if (targetisUnit == ASTEROIDPTR && thisisUnit == ASTEROIDPTR)
         return false;
-    std::multimap<Unit *, Unit *> *last_collisions = &_Universe->activeStarSystem()->last_collisions;
-    last_collisions->insert(std::pair<Unit *, Unit *>(this, target));
     // unit v unit? use point sampling?
     if ((this->DockedOrDocking() & (DOCKED_INSIDE | DOCKED)) || (target->DockedOrDocking() & (DOCKED_INSIDE | DOCKED)))
         return false;
     // now do some serious checks
+    PROFILE_COUNT(PairsTested, 1);
     Unit *bigger;
     Unit *smaller;
     if (radial_size < target->radial_size)
@@ -290,6 +452,11 @@ bool Unit::Collide(Unit *target)
     bool usecoltree = (this->colTrees && target->colTrees) ? this->colTrees->colTree(this, Vector(0, 0, 0)) &&
                                                                  target->colTrees->colTree(this, Vector(0, 0, 0))
                                                            : false;
+    if (CollisionBatch *batch = CollisionBatch::Active())
+    {
+        batch->Defer(bigger, smaller, usecoltree);
+        return false;
+    }
     if (usecoltree)
     {
         QVector bigpos, smallpos;
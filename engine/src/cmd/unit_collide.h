@@ -8,8 +8,10 @@
 #include "linecollide.h"
 #include <algorithm>
 #include <assert.h>
+#include <memory>
 #include <set>
 #include <stdio.h>
+#include <unordered_map>
 #include <vector>
 #define COLLIDETABLESIZE sizeof(CTSIZ)
 #define COLLIDETABLEACCURACY sizeof(CTACCURACY)
@@ -280,6 +282,71 @@ class CollideTable
 };
 
 class csOPCODECollider;
+struct csCollisionQuery;
+struct csCollisionCache;
+
+/**
+ * Narrowphase state of every pair of units (or subunits) whose meshes were tested recently: the
+ * last triangles that touched, which are tried first, and the last result, which is reused as long
+ * as neither unit moves. Pairs in lasting contact, like docked ships or ships grinding against an
+ * asteroid, then cost next to nothing per frame. Entries unused for a while are dropped.
+ */
+class CollisionCache
+{
+    struct PairHash
+    {
+        size_t operator()(const std::pair<const Unit *, const Unit *> &p) const
+        {
+            return std::hash<const Unit *>()(p.first) * 31 + std::hash<const Unit *>()(p.second);
+        }
+    };
+    struct Entry;
+    std::unordered_map<std::pair<const Unit *, const Unit *>, std::unique_ptr<Entry>, PairHash> entries;
+    unsigned int frame;
+
+  public:
+    CollisionCache();
+    ~CollisionCache();
+    /// The state of the pair, created if needed; stays valid until the next call to NextFrame
+    csCollisionCache *Get(const Unit *bigger, const Unit *smaller);
+    /// Starts a physics frame, dropping the pairs that have not been tested for some time
+    void NextFrame();
+};
+
+/**
+ * While a CollisionBatch is active, Unit::Collide only does the cheap checks and queues the mesh
+ * tests of the pairs it is given. Resolve() then runs all of them on up to the given number of
+ * threads, and applies the reactions on the calling thread, in the order the pairs were queued.
+ * The only difference with colliding one pair at a time is that a reaction no longer influences
+ * the pairs found after it in the same physics frame.
+ */
+class CollisionBatch
+{
+    struct Pending
+    {
+        Unit *bigger;
+        Unit *smaller;
+        bool usecoltree;
+        float simulation_atom; // reactions depend on the atom of the unit being simulated
+        size_t firstquery;
+        size_t endquery;
+    };
+    std::vector<Pending> pending;
+    std::vector<csCollisionQuery> queries;
+    std::vector<std::pair<Unit *, Unit *>> queryunits; // bigger and smaller unit of every query
+    std::set<csCollisionCache *> claimed;
+    unsigned int threads;
+    bool active;
+
+  public:
+    /// Only becomes active with more than one thread; otherwise Unit::Collide works as usual
+    explicit CollisionBatch(unsigned int threads);
+    ~CollisionBatch();
+    static CollisionBatch *Active();
+    void Defer(Unit *bigger, Unit *smaller, bool usecoltree);
+    void Resolve();
+};
+
 const unsigned int collideTreesMaxTrees = 16;
 struct collideTrees
 {
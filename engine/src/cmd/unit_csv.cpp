@@ -1036,7 +1036,7 @@ void Unit::LoadRow(CSVRow &row, string modification, string *netxml)
         table->SetupOptimizer(keys, LOADROW_OPTIMIZER);
     }
     // begin the geometry (and things that depend on stats)
-    fullname = OPTIM_GET(row, table, Name);
+    pImage->fullname = OPTIM_GET(row, table, Name);
     if ((tmpstr = OPTIM_GET(row, table, Hud_image)).length() != 0)
     {
         std::string fac = FactionUtil::GetFaction(faction);
@@ -1501,17 +1501,8 @@ void Unit::LoadRow(CSVRow &row, string modification, string *netxml)
             {
                 csrc = getCollideTree(Vector(1, 1, 1), xml.rapidmesh ? &polies : nullptr);
             }
+            // The scaled trees are made on demand by collideTrees::colTree
             this->colTrees = new collideTrees(collideTreeHash, csrc, colShield);
-            if (xml.rapidmesh && xml.hasColTree)
-            {
-                // if we have a special rapid mesh we need to generate things now
-                for (unsigned int i = 1; i < collideTreesMaxTrees; ++i)
-                    if (!this->colTrees->rapidColliders[i])
-                    {
-                        unsigned int which = 1 << i;
-                        this->colTrees->rapidColliders[i] = getCollideTree(Vector(1, 1, which), &polies);
-                    }
-            }
             if (xml.rapidmesh)
             {
                 delete xml.rapidmesh;
@@ -1563,16 +1554,9 @@ void Unit::WriteUnit(const char *modifications)
         }
         std::string savedir = modifications;
         VSFileSystem::CreateDirectoryHome(VSFileSystem::savedunitpath + "/" + savedir);
-        VSFile f;
-        VSError err = f.OpenCreateWrite(savedir + "/" + name + ".csv", UnitFile);
-        if (err > Ok)
-        {
-            fprintf(stderr, "!!! ERROR : Writing saved unit file : %s\n", f.GetFullPath().c_str());
-            return;
-        }
-        std::string towrite = WriteUnitString();
-        f.Write(towrite.c_str(), towrite.length());
-        f.Close();
+        std::string filename = savedir + "/" + name + ".csv";
+        if (!QueueSaveFileWrite(filename, UnitFile, std::make_shared<const std::string>(WriteUnitString())))
+            fprintf(stderr, "!!! ERROR : Writing saved unit file : %s\n", filename.c_str());
     }
     else
     {
@@ -1833,7 +1817,7 @@ string Unit::WriteUnitString()
             }
         }
         fprintf(stderr, "Failed to locate base mesh for %s %s %s\n", csvRow.get().c_str(), name.get().c_str(),
-                fullname.c_str());
+                pImage->fullname.c_str());
     }
     else
     {
@@ -1849,13 +1833,13 @@ void UpdateMasterPartList(Unit *ret)
 {
     for (unsigned int i = 0; i < _Universe->numPlayers(); ++i)
     {
-        Cockpit *cp = _Universe->AccessCockpit(i);
-        std::vector<std::string> *addedcargoname = &cp->savegame->getMissionStringData("master_part_list_content");
-        std::vector<std::string> *addedcargocat = &cp->savegame->getMissionStringData("master_part_list_category");
-        std::vector<std::string> *addedcargovol = &cp->savegame->getMissionStringData("master_part_list_volume");
-        std::vector<std::string> *addedcargoprice = &cp->savegame->getMissionStringData("master_part_list_price");
-        std::vector<std::string> *addedcargomass = &cp->savegame->getMissionStringData("master_part_list_mass");
-        std::vector<std::string> *addedcargodesc = &cp->savegame->getMissionStringData("master_part_list_description");
+        const SaveGame *savegame = _Universe->AccessCockpit(i)->savegame;
+        const std::vector<std::string> *addedcargoname = &savegame->readMissionStringData("master_part_list_content");
+        const std::vector<std::string> *addedcargocat = &savegame->readMissionStringData("master_part_list_category");
+        const std::vector<std::string> *addedcargovol = &savegame->readMissionStringData("master_part_list_volume");
+        const std::vector<std::string> *addedcargoprice = &savegame->readMissionStringData("master_part_list_price");
+        const std::vector<std::string> *addedcargomass = &savegame->readMissionStringData("master_part_list_mass");
+        const std::vector<std::string> *addedcargodesc = &savegame->readMissionStringData("master_part_list_description");
         for (unsigned int j = 0; j < addedcargoname->size(); ++j)
         {
             Cargo carg;
@@ -3,6 +3,7 @@
 #include "unit_generic.h"
 #include "aldrv/audiolib.h"
 #include "beam.h"
+#include "contact_snapshot.h"
 #include "cmd/ai/aggressive.h"
 #include "cmd/ai/communication.h"
 #include "cmd/ai/fire.h"
@@ -847,6 +848,7 @@ Unit::~Unit()
         pMeshAnimation = nullptr;
     }
 
+    ContactSnapshot::Forget(this);
     free(pImage->cockpit_damage);
     if ((!killed))
         VSFileSystem::vs_fprintf(stderr, "Assumed exit on unit %s(if not quitting, report error)\n",
@@ -977,7 +979,6 @@ void Unit::ZeroAll()
     energy = 0;
     maxwarpenergy = 0;
     warpenergy = 0;
-    // target_fgid has a constructor
     aistate = nullptr;
     // CollideInfo has a constructor
     colTrees = nullptr;
@@ -990,6 +991,8 @@ void Unit::ZeroAll()
     pMeshAnimation = nullptr;
 }
 
+static unsigned int lastconfigstamp = 0;
+
 void Unit::Init()
 {
     this->schedule_priority = Unit::scheduleDefault;
@@ -1041,6 +1044,7 @@ void Unit::Init()
     pImage->cloakglass = false;
     pImage->CargoVolume = 0;
     pImage->UpgradeVolume = 0;
+    pImage->configstamp = ++lastconfigstamp;
     this->HeatSink = 0;
 
     pImage->unitwriter = nullptr;
@@ -1292,7 +1296,7 @@ void Unit::Init(const char *filename, bool SubU, int faction, std::string unitMo
         }
         meshdata.clear();
         meshdata.push_back(nullptr);
-        this->fullname = filename;
+        pImage->fullname = filename;
         this->name = string("LOAD_FAILED");
         calculate_extent(false);
         radial_size = 1;
@@ -1600,7 +1604,7 @@ const string Unit::getFgID()
     }
     else
     {
-        return fullname;
+        return pImage->fullname;
     }
 }
 
@@ -2094,9 +2098,9 @@ float Unit::getRelation(const Unit *targ) const
 
 void Unit::setTargetFg(string primary, string secondary, string tertiary)
 {
-    target_fgid[0] = primary;
-    target_fgid[1] = secondary;
-    target_fgid[2] = tertiary;
+    pImage->target_fgid[0] = primary;
+    pImage->target_fgid[1] = secondary;
+    pImage->target_fgid[2] = tertiary;
 
     ReTargetFg(0);
 }
@@ -4930,7 +4934,7 @@ void Unit::Kill(bool erasefromsave, bool quitting)
     if (ucref == 0)
     {
         VSFileSystem::vs_dprintf(3, "UNIT DELETION QUEUED: %s %s (file %s, addr 0x%08x)\n", name.get().c_str(),
-                                 fullname.c_str(), filename.get().c_str(), this);
+                                 pImage->fullname.c_str(), filename.get().c_str(), this);
         Unitdeletequeue.push_back(this);
         if (flightgroup)
             if (flightgroup->leader.GetUnit() == this)
@@ -7382,6 +7386,8 @@ bool Unit::UpAndDownGrade(const Unit *up, const Unit *templ, int mountoffset, in
                           const Unit *downgradelimit, bool force_change_on_nothing, bool gen_downgrade_list)
 {
     percentage = 0;
+    if (touchme)
+        pImage->configstamp = ++lastconfigstamp;
 
     static bool csv_cell_null_check =
         XMLSupport::parse_bool(vs_config->getVariable("data", "empty_cell_check", "true"));
@@ -8061,6 +8067,7 @@ int Unit::RepairCost()
 
 int Unit::RepairUpgrade()
 {
+    pImage->configstamp = ++lastconfigstamp;
     vector<Cargo> savedCargo;
     savedCargo.swap(pImage->cargo);
     vector<Mount> savedWeap;
@@ -8186,6 +8193,7 @@ extern bool isWeapon(std::string name);
 bool Unit::RepairUpgradeCargo(Cargo *item, Unit *baseUnit, float *credits)
 {
     assert((item != nullptr) | !"Unit::RepairUpgradeCargo got a null item."); // added by chuck_starchaser
+    pImage->configstamp = ++lastconfigstamp;
     double itemPrice = baseUnit ? baseUnit->PriceCargo(item->content) : item->price;
     if (isWeapon(item->category))
     {
@@ -8406,7 +8414,7 @@ vector<CargoColor> &Unit::FilterDowngradeList(vector<CargoColor> &mylist, bool d
     return mylist;
 }
 
-vector<CargoColor> &Unit::FilterUpgradeList(vector<CargoColor> &mylist)
+vector<CargoColor> &Unit::FilterUpgradePrices(vector<CargoColor> &mylist)
 {
     static bool filtercargoprice =
         XMLSupport::parse_bool(vs_config->getVariable("cargo", "filter_expensive_cargo", "false"));
@@ -8422,6 +8430,12 @@ vector<CargoColor> &Unit::FilterUpgradeList(vector<CargoColor> &mylist)
                 }
         }
     }
+    return mylist;
+}
+
+vector<CargoColor> &Unit::FilterUpgradeList(vector<CargoColor> &mylist)
+{
+    FilterUpgradePrices(mylist);
     return FilterDowngradeList(mylist, false);
 }
 
@@ -50,6 +50,7 @@ void UncheckUnit(class Unit *un);
 #include "gfx/matrix.h"
 #include "gfx/quaternion.h"
 #include "gldrv/gfxlib_struct.h"
+#include "object_pool.h"
 #include "script/flightgroup.h"
 #include "star_system_generic.h"
 #include "vsfilesystem.h"
@@ -215,7 +216,128 @@ struct PlanetaryOrbitData;
 
 class Unit
 {
+  public:
+    // Units come and go in bursts during battles; every Unit type, missiles included, has a pool
+    POOLED_ALLOCATION("Unit")
+
+    /*
+     **************************************************************************************
+     **** PER FRAME STATE                                                               ***
+     **************************************************************************************
+     */
+    // What the simulation queue, physics and collision touch for every unit on every frame is
+    // declared here, ahead of everything else, so that it shares cache lines. This is only an
+    // ordering: the rest of Unit is still in the same allocation. The "AI" and "Physics" profiler
+    // zones in StarSystem::UpdateUnitPhysics are where a change here shows up.
+
+  public:
+    // The number of frames ahead this was put in the simulation queue
+    unsigned int sim_atom_multiplier;
+    // The number of frames ahead this is predicted to be scheduled in the next scheduling round
+    unsigned int predicted_priority;
+    // When will physical simulation occur
+    unsigned int cur_sim_queue_slot;
+    // Used with subunit scheduling, to avoid the complex ickiness of having to synchronize scattered slots
+    unsigned int last_processed_sqs;
+    // Does this unit require special scheduling?
+    enum schedulepriorityenum
+    {
+        scheduleDefault,
+        scheduleAField,
+        scheduleRoid
+    } schedule_priority;
+    // Whether or not to schedule subunits for deferred physics processing - if not, they're processed at the same time
+    // the parent unit is being processed
+    bool do_subunit_scheduling;
+    // Should we resolve forces on this unit (is it free to fly or in orbit)
+    bool resolveforces;
+    unsigned char docked;
+    int faction;
+    // The owner of this unit. This may not collide with owner or units owned by owner. Do not dereference (may be dead
+    // pointer)
+    void *owner; // void ensures that it won't be referenced by accident
+    // the star system I'm in
+    StarSystem *activeStarSystem;
+    Order *aistate;
+    CollideMap::iterator location[2];
+    struct collideTrees *colTrees;
+    // The previous state in last physics frame to interpolate within
+    Transformation prev_physical_state;
+    // The state of the current physics frame to interpolate within
+    Transformation curr_physical_state;
+    // The cumulative (incl subunits parents' transformation)
+    Matrix cumulative_transformation_matrix;
+    // The cumulative (incl subunits parents' transformation)
+    Transformation cumulative_transformation;
+    // The velocity this unit has in World Space
+    Vector cumulative_velocity;
+    // The force applied from outside accrued over the whole physics frame
+    Vector NetForce;
+    // The force applied by internal objects (thrusters)
+    Vector NetLocalForce;
+    // The torque applied from outside objects
+    Vector NetTorque;
+    // The torque applied from internal objects
+    Vector NetLocalTorque;
+    // the current velocities in LOCAL space (not world space)
+    Vector AngularVelocity;
+    Vector Velocity;
+    // positive for the multiplier applied to nearby spec starships (1 = planetary/inert effects) 0 is default (no
+    // effect), -X means 0 but able to be enabled
+    float specInterdiction;
+    // mass of this unit (may change with cargo)
+    float Mass;
+    //-1 is not available... ranges between 0 32767 for "how invisible" unit currently is (32768... -32768) being
+    // visible)
+    int cloaking; // short fix
+    // the minimum cloaking value...
+    int cloakmin; // short fix
+    // How big is this unit
+    float radial_size;
+    // The structual integ of the current unit
+    float hull;
+    // current energy
+    float energy;
+    class graphic_options
+    {
+      public:
+        unsigned SubUnit : 1;
+        unsigned RecurseIntoSubUnitsOnCollision : 1;
+        unsigned missilelock : 1;
+        unsigned FaceCamera : 1;
+        unsigned Animating : 1;
+        unsigned InWarp : 1;
+        unsigned WarpRamping : 1;
+        unsigned unused1 : 1;
+        unsigned NoDamageParticles : 1;
+        unsigned specInterdictionOnline : 1;
+        unsigned char NumAnimationPoints;
+        float WarpFieldStrength;
+        float RampCounter;
+        float MinWarpMultiplier;
+        float MaxWarpMultiplier;
+        graphic_options();
+    } graphicOptions;
+
   protected:
+    // fuel of this unit
+    float fuel;
+    // Moment of intertia of this unit
+    float Momentofinertia;
+    Vector SavedAccel;
+    Vector SavedAngAccel;
+    // how much the energy recharges per second
+    float recharge;
+    // maximum energy
+    float maxenergy;
+    float maxwarpenergy; // short fix
+    // current energy
+    float warpenergy; // short fix
+    Nebula *nebula;
+    // Is dead already?
+    bool killed;
+    unsigned char invisible; // 1 means turn off glow, 2 means turn off ship
+
     // How many lists are referencing us
     int ucref;
     StringPool::Reference csvRow;
@@ -329,26 +451,6 @@ class Unit
     bool inertialmode;
     char turretstatus;
     bool autopilotactive;
-    class graphic_options
-    {
-      public:
-        unsigned SubUnit : 1;
-        unsigned RecurseIntoSubUnitsOnCollision : 1;
-        unsigned missilelock : 1;
-        unsigned FaceCamera : 1;
-        unsigned Animating : 1;
-        unsigned InWarp : 1;
-        unsigned WarpRamping : 1;
-        unsigned unused1 : 1;
-        unsigned NoDamageParticles : 1;
-        unsigned specInterdictionOnline : 1;
-        unsigned char NumAnimationPoints;
-        float WarpFieldStrength;
-        float RampCounter;
-        float MinWarpMultiplier;
-        float MaxWarpMultiplier;
-        graphic_options();
-    } graphicOptions;
     bool isSubUnit() const
     {
         return graphicOptions.SubUnit ? true : false;
@@ -427,7 +529,6 @@ class Unit
   protected:
     unsigned char attack_preference;
     unsigned char unit_role;
-    Nebula *nebula;
     // The orbit needs to have access to the velocity directly to disobey physics laws to precalculate orbits
     friend class PlanetaryOrbit;
     friend class ContinuousTerrain;
@@ -453,8 +554,6 @@ class Unit
     // Shouldn't do anything here - but needed by Python
     class Cockpit *GetVelocityDifficultyMult(float &) const;
 
-    // the star system I'm in
-    StarSystem *activeStarSystem;
     // Takes out of the collide table for this system.
     void RemoveFromSystem();
     void RequestPhysics(); // Requeues the unit so that it is simulated ASAP
@@ -710,70 +809,15 @@ class Unit
     bool AutoPilotToErrorMessage(const Unit *un, bool automaticenergyrealloc, std::string &failuremessage,
                                  int recursive_level = 2);
     bool AutoPilotTo(Unit *un, bool automaticenergyrealloc);
-    // The owner of this unit. This may not collide with owner or units owned by owner. Do not dereference (may be dead
-    // pointer)
-    void *owner; // void ensures that it won't be referenced by accident
-                 // The number of frames ahead this was put in the simulation queue
-    unsigned int sim_atom_multiplier;
-    // The number of frames ahead this is predicted to be scheduled in the next scheduling round
-    unsigned int predicted_priority;
-    // The previous state in last physics frame to interpolate within
-    Transformation prev_physical_state;
-    // The state of the current physics frame to interpolate within
-    Transformation curr_physical_state;
-    // When will physical simulation occur
-    unsigned int cur_sim_queue_slot;
-    // Used with subunit scheduling, to avoid the complex ickiness of having to synchronize scattered slots
-    unsigned int last_processed_sqs;
-    // Whether or not to schedule subunits for deferred physics processing - if not, they're processed at the same time
-    // the parent unit is being processed
-    bool do_subunit_scheduling;
-    // Does this unit require special scheduling?
-    enum schedulepriorityenum
-    {
-        scheduleDefault,
-        scheduleAField,
-        scheduleRoid
-    } schedule_priority;
-    // number of meshes (each with separate texture) this unit has
-    // The cumulative (incl subunits parents' transformation)
-    Matrix cumulative_transformation_matrix;
-    // The cumulative (incl subunits parents' transformation)
-    Transformation cumulative_transformation;
-    // The velocity this unit has in World Space
-    Vector cumulative_velocity;
-    // The force applied from outside accrued over the whole physics frame
-    Vector NetForce;
-    // The force applied by internal objects (thrusters)
-    Vector NetLocalForce;
-    // The torque applied from outside objects
-    Vector NetTorque;
-    // The torque applied from internal objects
-    Vector NetLocalTorque;
-    // the current velocities in LOCAL space (not world space)
-    Vector AngularVelocity;
-    Vector Velocity;
     // The image that will appear on those screens of units targetting this unit
     UnitImages<void> *pImage;
-    // positive for the multiplier applied to nearby spec starships (1 = planetary/inert effects) 0 is default (no
-    // effect), -X means 0 but able to be enabled
-    float specInterdiction;
-    // mass of this unit (may change with cargo)
-    float Mass;
     float HeatSink;
 
   protected:
     // are shields tight to the hull.  zero means bubble
     float shieldtight;
-    // fuel of this unit
-    float fuel;
     float afterburnenergy; // short fix
     int afterburntype;     // 0--energy, 1--fuel
-                       //-1 means it is off. -2 means it doesn't exist. otherwise it's engaged to destination (positive
-                       // number) Moment of intertia of this unit
-    float Momentofinertia;
-    Vector SavedAccel;
-    Vector SavedAngAccel;
 
   public:
     class Limits
@@ -804,17 +848,8 @@ class Unit
         {
         }
     } limits;
-    //-1 is not available... ranges between 0 32767 for "how invisible" unit currently is (32768... -32768) being
-    // visible)
-    int cloaking; // short fix
-                  // the minimum cloaking value...
-    int cloakmin; // short fix
-                  // How big is this unit
-    float radial_size;
 
   protected:
-    // Is dead already?
-    bool killed;
     // Should not be drawn
     enum INVIS
     {
@@ -823,10 +858,9 @@ class Unit
         INVISUNIT = 0x2,
         INVISCAMERA = 0x4
     };
-    unsigned char invisible; // 1 means turn off glow, 2 means turn off ship
-                             // corners of object
 
   public:
+    // corners of object
     Vector corner_min, corner_max;
     Vector LocalCoordinates(const Unit *un) const
     {
@@ -891,8 +925,6 @@ class Unit
     void DecreaseWarpEnergy(bool insystem, float time = 1.0f);
     void IncreaseWarpEnergy(bool insystem, float time = 1.0f);
     bool RefillWarpEnergy();
-    // Should we resolve forces on this unit (is it free to fly or in orbit)
-    bool resolveforces;
     // What's the size of this unit
     float rSize() const
     {
@@ -1088,10 +1120,6 @@ class Unit
     // Armor and shield structures
     Armor armor;
     Shield shield;
-    // The structual integ of the current unit
-    float hull;
-    // current energy
-    float energy;
 
   protected:
     // Activates all guns of that size
@@ -1103,17 +1131,8 @@ class Unit
     float maxhull;
     // The radar limits (range, cone range, etc)
     // the current order
-    // how much the energy recharges per second
-    float recharge;
 
-    // maximum energy
-    float maxenergy;
-    // maximum energy
-    float maxwarpenergy; // short fix
-                         // current energy
-    float
-        warpenergy; // short fix
-                    // applies damage from the given pnt to the shield, and returns % damage applied and applies lighitn
+    // applies damage from the given pnt to the shield, and returns % damage applied and applies lighitn
     virtual float DealDamageToShield(const Vector &pnt, float &Damage);
     // If the shields are up from this position
     bool ShieldUp(const Vector &) const;
@@ -1165,10 +1184,6 @@ class Unit
      **************************************************************************************
      */
 
-  protected:
-    // not used yet
-    StringPool::Reference target_fgid[3];
-
   public:
     bool InRange(const Unit *target, bool cone = true, bool cap = true) const
     {
@@ -1258,7 +1273,6 @@ class Unit
     class csOPCODECollider *getCollideTree(const Vector &scale = Vector(1, 1, 1),
                                            std::vector<struct mesh_polygon> * = nullptr);
     // Because accessing in daughter classes member function from Unit * instances
-    Order *aistate;
     Order *getAIState() const
     {
         return aistate;
@@ -1309,8 +1323,6 @@ class Unit
         NUM_COLLIDE_MAPS = 2
     };
     // location[0] is for units only, location[1] is for units + bolts
-    CollideMap::iterator location[2];
-    struct collideTrees *colTrees;
     // Sets the parent to be this unit. Unit never dereferenced for this operation
     void SetCollisionParent(Unit *name);
     // won't collide with ownery
@@ -1375,7 +1387,6 @@ class Unit
      */
 
   public:
-    unsigned char docked;
     enum DOCKENUM
     {
         NOT_DOCKED = 0x0,
@@ -1418,7 +1429,6 @@ class Unit
   public:
     void SetFg(Flightgroup *fg, int fg_snumber);
     // The faction of this unit
-    int faction;
     void SetFaction(int faction);
     // get the flightgroup description
     Flightgroup *getFlightgroup() const
@@ -1435,6 +1445,13 @@ class Unit
     // Changed next two lines from struct CargoColor to class CargoColor to fit line 70 declaration
     std::vector<class CargoColor> &FilterDowngradeList(std::vector<class CargoColor> &mylist, bool downgrade = true);
     std::vector<class CargoColor> &FilterUpgradeList(std::vector<class CargoColor> &mylist);
+    /// The part of FilterUpgradeList that looks at the player's credits rather than the ship
+    std::vector<class CargoColor> &FilterUpgradePrices(std::vector<class CargoColor> &mylist);
+    /// Upgrade and downgrade checks give the same answers as long as this stays the same
+    unsigned int ConfigStamp() const
+    {
+        return pImage->configstamp;
+    }
 
     bool IsBase() const;
 
@@ -1459,18 +1476,14 @@ class Unit
   private:
     unsigned char tractorability_flags;
 
-  protected:
-    // if the unit is a planet, this contains the long-name 'mars-station'
-    std::string fullname;
-
   public:
     void setFullname(std::string name)
     {
-        fullname = name;
+        pImage->fullname = name;
     }
     const string &getFullname() const
     {
-        return fullname;
+        return pImage->fullname;
     }
 
     const string &getFilename() const
@@ -2136,14 +2136,8 @@ void Unit::LoadXML(VSFileSystem::VSFile &f, const char *modifications, string *x
         csOPCODECollider *csrc = nullptr;
         if (xml->hasColTree)
             csrc = getCollideTree(Vector(1, 1, 1), xml->rapidmesh ? &polies : nullptr);
+        // The scaled trees are made on demand by collideTrees::colTree
         this->colTrees = new collideTrees(collideTreeHash, csrc, colShield);
-        if (xml->rapidmesh && xml->hasColTree) // if we have a speciaal rapid mesh we need to generate things now
-            for (unsigned int i = 1; i < collideTreesMaxTrees; ++i)
-                if (!this->colTrees->rapidColliders[i])
-                {
-                    unsigned int which = 1 << i;
-                    this->colTrees->rapidColliders[i] = getCollideTree(Vector(which, which, which), &polies);
-                }
     }
     if (xml->rapidmesh)
         delete xml->rapidmesh;
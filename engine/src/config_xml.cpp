@@ -35,7 +35,9 @@
 #include "in_joystick.h"
 #include "in_kb_data.h"
 #include "main_loop.h" //for CockpitKeys
+#include "profiler.h"
 #include "python/python_compile.h"
+#include "python/python_time.h"
 #include "vegastrike.h"
 #include "xml_support.h"
 #include <assert.h>
@@ -90,6 +92,25 @@ void doScreenshot(const KBData &, KBSTATE a)
         screenshotkey = true;
 }
 
+void toggleProfiler(const KBData &, KBSTATE a)
+{
+    if (a == PRESS)
+        Profiler::setEnabled(!Profiler::isEnabled());
+}
+
+void dumpPythonTime(const KBData &, KBSTATE a)
+{
+    if (a != PRESS)
+        return;
+    static std::string file = vs_config->getVariable("python", "time_report_file", "python_time.txt");
+    std::string path = VSFileSystem::homedir + "/" + file;
+    PythonTime::logSummary();
+    if (PythonTime::writeReport(path))
+        VSFileSystem::vs_fprintf(stderr, "Python time report written to %s\n", path.c_str());
+    else
+        VSFileSystem::vs_fprintf(stderr, "Could not write %s\n", path.c_str());
+}
+
 void incvol(const KBData &, KBSTATE a)
 {
 #ifdef HAVE_AL
@@ -625,6 +646,8 @@ CommandMap initGlobalCommandMap()
     commandMap["StartKey"] = FlyByKeyboard::StartKey;
     commandMap["StopKey"] = FlyByKeyboard::StopKey;
     commandMap["Screenshot"] = doScreenshot;
+    commandMap["ToggleProfiler"] = toggleProfiler;
+    commandMap["DumpPythonTime"] = dumpPythonTime;
     commandMap["UpKey"] = FlyByKeyboard::UpKey;
     commandMap["DownKey"] = FlyByKeyboard::DownKey;
     commandMap["LeftKey"] = FlyByKeyboard::LeftKey;
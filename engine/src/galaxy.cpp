@@ -1,6 +1,7 @@
 #include "cmd/script/mission.h"
 #include "configxml.h"
 #include "galaxy_gen.h"
+#include "galaxy_graph.h"
 #include "galaxy_xml.h"
 #include "lin_time.h"
 #include "star_system_generic.h"
@@ -12,7 +13,6 @@
 #include "options.h"
 
 #include <algorithm>
-#include <deque>
 #include <map>
 #include <string>
 #include <vector>
@@ -206,10 +206,9 @@ const vector<string> &ParseDestinations(const string &value)
     return rv;
 }
 
-void MakeStarSystem(string file, Galaxy *galaxy, string origin, int32_t forcerandom)
+static void GetStarSystemInfo(const string &file, Galaxy *galaxy, const string &origin, SystemInfo &si)
 {
     SystemInfo Ave;
-    SystemInfo si;
     AvgSystems(GetSystemMin(galaxy), GetSystemMax(galaxy), Ave);
     // Do we really need this duplicate code... or can we use GetSystemXProp()
     si.sector = getStarSystemSector(file);
@@ -266,9 +265,22 @@ void MakeStarSystem(string file, Galaxy *galaxy, string origin, int32_t forceran
         GetSystemXProp(galaxy, "unknown_sector", "maxlimit", maxlimit);
         clampSystem(si, minlimit, maxlimit);
     }
+}
+
+void MakeStarSystem(string file, Galaxy *galaxy, string origin, int32_t forcerandom)
+{
+    SystemInfo si;
+    GetStarSystemInfo(file, galaxy, origin, si);
     generateStarSystem(si);
 }
 
+void PregenerateStarSystem(string file, Galaxy *galaxy, string origin)
+{
+    SystemInfo si;
+    GetStarSystemInfo(file, galaxy, origin, si);
+    pregenerateStarSystem(si);
+}
+
 std::string Universe::getGalaxyProperty(const std::string &sys, const std::string &prop)
 {
     string sector = getStarSystemSector(sys);
@@ -291,63 +303,24 @@ const vector<std::string> &Universe::getAdjacentStarSystems(const std::string &f
     return ParseDestinations(galaxy->getVariable(sector, name, "jumps", ""));
 }
 
-void Universe::getJumpPath(const std::string &from, const std::string &to, vector<std::string> &path) const
+GalaxyGraph &Universe::getGalaxyGraph() const
 {
-    map<string, uint32_t> visited;
-    vector<const string *> origin;
-    deque<const string *> open;
-
-    // seed with starting point
-    visited[from] = 0;
-    origin.push_back(nullptr);
-    open.push_back(&from);
-
-    // Textbook BFS search
-    while (!open.empty())
-    {
-        const string *system = open.front();
-        open.pop_front();
-
-        const vector<std::string> &adjacent = getAdjacentStarSystems(*system);
-        for (vector<std::string>::const_iterator i = adjacent.begin(); i != adjacent.end(); ++i)
-        {
-            map<string, unsigned int>::const_iterator velem = visited.find(*i);
-            if (velem == visited.end())
-            {
-                visited[*i] = origin.size();
-                origin.push_back(system);
-                velem = visited.find(*i);
-
-                if (*i == to)
-                {
-                    // finished we are
-                    open.clear();
-                    break;
-                }
-                else
-                {
-                    open.push_back(&velem->first);
-                }
-            }
-        }
-    }
+    if (!galaxy_graph)
+        galaxy_graph.reset(new GalaxyGraph(*galaxy));
+    return *galaxy_graph;
+}
 
-    // Backtrack to get a reverse path
+void Universe::getJumpPath(const std::string &from, const std::string &to, vector<std::string> &path) const
+{
     path.clear();
-    map<string, uint32_t>::const_iterator velem = visited.find(to);
-    while (velem != visited.end())
+    if (from == to)
     {
-        path.push_back(velem->first);
-        if (origin[velem->second] == nullptr)
-        {
-            velem = visited.end();
-        }
-        else
-        {
-            velem = visited.find(*origin[velem->second]);
-        }
+        path.push_back(from);
+        return;
     }
-
-    // Reverse to get the straight path
-    reverse(path.begin(), path.end());
+    const GalaxyGraph &graph = getGalaxyGraph();
+    vector<GalaxyGraph::SystemId> route;
+    graph.route(graph.find(from), graph.find(to), route);
+    for (size_t i = 0; i < route.size(); ++i)
+        path.push_back(graph.name(route[i]));
 }
@@ -1,9 +1,17 @@
 #include "macosx_math.h"
+#include <algorithm>
 #include <assert.h>
+#include <condition_variable>
+#include <deque>
+#include <map>
 #include <math.h>
+#include <memory>
+#include <mutex>
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string>
+#include <thread>
 #include <time.h>
 #include <vector>
 
@@ -33,11 +41,6 @@ using namespace VSFileSystem;
 using std::string;
 using std::vector;
 
-static VSRandom starsysrandom(time(nullptr));
-static void seedrand(uint64_t seed)
-{
-    starsysrandom = VSRandom(seed);
-}
 static int32_t stringhash(const string &key)
 {
     uint32_t k = 0;
@@ -46,11 +49,6 @@ static int32_t stringhash(const string &key)
     return k;
 }
 
-static uint32_t ssrand()
-{
-    return starsysrandom.rand();
-}
-
 static string GetWrapXY(string cname, int32_t &wrapx, int32_t &wrapy)
 {
     string wrap = cname;
@@ -79,35 +77,8 @@ float mmax(float a, float b)
 {
     return (a > b) ? a : b;
 }
-
-int32_t rnd(int32_t lower, int32_t upper)
-{
-    if (upper > lower)
-        return lower + ssrand() % (upper - lower);
-    else
-        return lower;
-}
 const char nada[1] = "";
-string getGenericName(vector<string> &s)
-{
-    if (s.empty())
-    {
-        return string(nada);
-    }
-    return s[rnd(0, s.size())];
-}
 
-string getRandName(vector<string> &s)
-{
-    if (s.empty())
-    {
-        return string(nada);
-    }
-    uint32_t i = rnd(0, s.size());
-    string k = s[i];
-    s.erase(s.begin() + i);
-    return k;
-}
 struct Color
 {
     float r, g, b, a;
@@ -237,43 +208,10 @@ class Vector
     }
 };
 
-float grand()
-{
-    return float(ssrand()) / VS_RAND_MAX;
-}
-vector<Color> lights;
-VSFile f;
-int xmllevel;
-
-static void Tab()
-{
-    for (int i = 0; i < xmllevel; i++)
-        f.Fprintf("\t");
-}
-
 float difffunc(float inputdiffuse)
 {
     return sqrt(((inputdiffuse)));
 }
-void WriteLight(unsigned int i)
-{
-    float ambient = (lights[i].r + lights[i].g + lights[i].b);
-
-    ambient *= game_options.AmbientLightFactor;
-    Tab();
-    f.Fprintf("<Light>\n");
-    xmllevel++;
-    Tab();
-    f.Fprintf("<ambient red=\"%f\" green=\"%f\" blue=\"%f\"/>\n", ambient, ambient, ambient);
-    Tab();
-    f.Fprintf("<diffuse red=\"%f\" green=\"%f\" blue=\"%f\"/>\n", difffunc(lights[i].r), difffunc(lights[i].g),
-              difffunc(lights[i].b));
-    Tab();
-    f.Fprintf("<specular red=\"%f\" green=\"%f\" blue=\"%f\"/>\n", lights[i].nr, lights[i].ng, lights[i].nb);
-    xmllevel--;
-    Tab();
-    f.Fprintf("</Light>\n");
-}
 struct GradColor
 {
     float minrad;
@@ -287,29 +225,9 @@ const int32_t STAR = 0;
 const int32_t PLANET = 1;
 const int32_t MOON = 2;
 const int32_t JUMP = 3;
-// begin global variables
-
-vector<string> starentities;
-vector<string> jumps;
-vector<string> gradtex;
-vector<string> naturalphenomena;
-vector<string> starbases;
-uint32_t numstarbases;
-uint32_t numnaturalphenomena;
-uint32_t numstarentities;
-vector<string> background;
-vector<string> names;
-vector<string> rings;
 const float moonofmoonprob = .01;
-string systemname;
-vector<float> radii;
 const float minspeed = .001;
 const float maxspeed = 8;
-vector<float> starradius;
-string faction;
-vector<GradColor> colorGradiant;
-float compactness = 2;
-float jumpcompactness = 2;
 
 struct PlanetInfo
 {
@@ -335,38 +253,235 @@ struct StarInfo
     {
     }
 };
-vector<StarInfo> stars;
-unsigned int planetoffset, staroffset, moonlevel;
-
-void ResetGlobalVariables()
-{
-    xmllevel = 0;
-    lights.clear();
-    gradtex.clear();
-    naturalphenomena.clear();
-    starbases.clear();
-    starentities.clear();
-    numstarentities = 0;
-    numstarbases = 0;
-    numnaturalphenomena = 0;
-    background.clear();
-    stars.clear();
-    planetoffset = 0;
-    staroffset = 0;
-    moonlevel = 0;
-    names.clear();
-    jumps.clear();
-    rings.clear();
-    systemname.erase();
-    starradius.clear();
-    faction.erase();
-    colorGradiant.clear();
-    compactness = 2;
-    jumpcompactness = 2;
-    radii.clear();
-}
-
-void readColorGrads(vector<string> &entity, const char *file)
+
+/// Everything a generator draws from disk, read up front on the main thread (VSFile is not thread safe)
+struct SystemLists
+{
+    vector<string> gradtex;
+    vector<GradColor> colorGradiant;
+    vector<string> starbases;
+    vector<string> background;
+    vector<string> naturalphenomena;
+    vector<string> rings;
+    vector<string> names;
+    string jumpfile;
+};
+
+/*
+ * Builds the description of one star system, the tree of elements its system file would hold. All
+ * the state of a generation lives in the generator, so several systems can be generated at once on
+ * different threads.
+ */
+class Generator
+{
+  public:
+    Generator(const SystemInfo &si, const SystemLists &lists, const GalaxyXML::Galaxy *galaxy);
+    /// Only for the star colors, which do not need a system
+    Generator(const SystemLists &lists, uint32_t seed);
+    SystemElement generate();
+    Color StarColor(float radius, uint32_t &entityindex);
+
+  private:
+    const GalaxyXML::Galaxy *galaxy;
+    VSRandom starsysrandom;
+    SystemElement system;
+    vector<SystemElement *> current; // the open elements, innermost last
+    vector<Color> lights;
+    vector<string> starentities;
+    vector<string> jumps;
+    vector<string> gradtex;
+    vector<string> naturalphenomena;
+    vector<string> starbases;
+    uint32_t numstarbases;
+    uint32_t numnaturalphenomena;
+    uint32_t numstarentities;
+    vector<string> background;
+    vector<string> names;
+    vector<string> rings;
+    string systemname;
+    vector<float> radii;
+    vector<float> starradius;
+    string faction;
+    vector<GradColor> colorGradiant;
+    float compactness;
+    float jumpcompactness;
+    string jumpfile;
+    vector<StarInfo> stars;
+    unsigned int planetoffset, staroffset, moonlevel;
+
+    uint32_t ssrand()
+    {
+        return starsysrandom.rand();
+    }
+    int32_t rnd(int32_t lower, int32_t upper);
+    string getGenericName(vector<string> &s);
+    string getRandName(vector<string> &s);
+    float grand();
+    void beginElement(const char *name);
+    void attribute(const char *name, const string &value);
+    void attribute(const char *name, double value);
+    void attribute(const char *name, int32_t value);
+    void orbit(const Vector &r, const Vector &s);
+    void position(const Vector &center);
+    void endElement();
+    void WriteLight(unsigned int i);
+    float getcolor(float c, float var);
+    GradColor whichGradColor(float r, uint32_t &j);
+    float LengthOfYear(Vector r, Vector s);
+    void CreateLight(uint32_t i);
+    Vector generateCenter(float minradii, bool jumppoint);
+    float makeRS(Vector &r, Vector &s, float minradii, bool jumppoint);
+    void Updateradii(float orbitsize, float thisplanetradius);
+    Vector generateAndUpdateRS(Vector &r, Vector &s, float thisplanetradius, bool jumppoint);
+    void WriteUnit(const string &tag, const string &name, const string &filename, const Vector &r, const Vector &s,
+                   const Vector &center, const string &nebfile, const string &destination, bool withfaction,
+                   float thisloy = 0);
+    void MakeSmallUnit();
+    void MakeJump(float radius, bool forceRS = false, Vector R = Vector(0, 0, 0), Vector S = Vector(0, 0, 0),
+                  Vector center = Vector(0, 0, 0), float thisloy = 0);
+    void MakeBigUnit(int callingentitytype, string name = string(), float orbitalradius = 0);
+    void MakePlanet(float radius, int32_t entitytype, string texturename, string unitname, string technique,
+                    int32_t texturenum, int32_t numberofjumps, int32_t numberofstarbases);
+    void MakeRing(const string &file, const Vector &r, const Vector &s, double inner_rad, double outer_rad,
+                  int32_t wrapx, int32_t wrapy);
+    void MakeJumps(float callingradius, int callingentitytype, int numberofjumps);
+    void MakeMoons(float callingradius, int callingentitytype);
+    void beginStar();
+    void endStar();
+    void CreateStar();
+    void CreateFirstStar();
+    void CreatePrimaries();
+    void CreateStarSystem();
+    void readplanetentity(vector<StarInfo> &starinfos, string planetlist, unsigned int numstars);
+    int32_t pushDown(int32_t val);
+    int32_t pushDownTowardsMean(int32_t mean, int32_t val);
+    int32_t pushTowardsMean(int32_t mean, int32_t val);
+};
+
+Generator::Generator(const SystemLists &lists, uint32_t seed)
+    : galaxy(nullptr), starsysrandom(seed), numstarbases(0), numnaturalphenomena(0), numstarentities(0),
+      colorGradiant(lists.colorGradiant), compactness(2), jumpcompactness(2), planetoffset(0), staroffset(0),
+      moonlevel(0)
+{
+}
+
+int32_t Generator::rnd(int32_t lower, int32_t upper)
+{
+    if (upper > lower)
+        return lower + ssrand() % (upper - lower);
+    else
+        return lower;
+}
+string Generator::getGenericName(vector<string> &s)
+{
+    if (s.empty())
+    {
+        return string(nada);
+    }
+    return s[rnd(0, s.size())];
+}
+
+string Generator::getRandName(vector<string> &s)
+{
+    if (s.empty())
+    {
+        return string(nada);
+    }
+    uint32_t i = rnd(0, s.size());
+    string k = s[i];
+    s.erase(s.begin() + i);
+    return k;
+}
+float Generator::grand()
+{
+    return float(ssrand()) / VS_RAND_MAX;
+}
+
+void Generator::beginElement(const char *name)
+{
+    SystemElement *parent = current.empty() ? nullptr : current.back();
+    if (!parent)
+    {
+        system = SystemElement();
+        current.push_back(&system);
+    }
+    else
+    {
+        // parent cannot get other children while this one is open, so the pointer stays good
+        parent->children.push_back(SystemElement());
+        current.push_back(&parent->children.back());
+    }
+    current.back()->name = name;
+}
+
+void Generator::attribute(const char *name, const string &value)
+{
+    vector<string> &attributes = current.back()->attributes;
+    attributes.push_back(name);
+    attributes.push_back(value);
+}
+
+// Numbers are written the way the system files have always had them
+void Generator::attribute(const char *name, double value)
+{
+    char buffer[512];
+    snprintf(buffer, sizeof(buffer), "%f", value);
+    attribute(name, string(buffer));
+}
+
+void Generator::attribute(const char *name, int32_t value)
+{
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "%d", value);
+    attribute(name, string(buffer));
+}
+
+void Generator::orbit(const Vector &r, const Vector &s)
+{
+    attribute("ri", r.i);
+    attribute("rj", r.j);
+    attribute("rk", r.k);
+    attribute("si", s.i);
+    attribute("sj", s.j);
+    attribute("sk", s.k);
+}
+
+void Generator::position(const Vector &center)
+{
+    attribute("x", center.i);
+    attribute("y", center.j);
+    attribute("z", center.k);
+}
+
+void Generator::endElement()
+{
+    current.pop_back();
+}
+
+void Generator::WriteLight(unsigned int i)
+{
+    float ambient = (lights[i].r + lights[i].g + lights[i].b);
+
+    ambient *= game_options.AmbientLightFactor;
+    beginElement("Light");
+    beginElement("ambient");
+    attribute("red", ambient);
+    attribute("green", ambient);
+    attribute("blue", ambient);
+    endElement();
+    beginElement("diffuse");
+    attribute("red", difffunc(lights[i].r));
+    attribute("green", difffunc(lights[i].g));
+    attribute("blue", difffunc(lights[i].b));
+    endElement();
+    beginElement("specular");
+    attribute("red", lights[i].nr);
+    attribute("green", lights[i].ng);
+    attribute("blue", lights[i].nb);
+    endElement();
+    endElement();
+}
+void readColorGrads(vector<string> &entity, vector<GradColor> &colorGradiant, const char *file)
 {
     VSFile f;
     VSError err = f.OpenReadOnly(file, UniverseFile);
@@ -397,6 +512,15 @@ void readColorGrads(vector<string> &entity, const char *file)
     f.Close();
 }
 
+static SystemLists starColorLists(const char *file)
+{
+    SystemLists lists;
+    readColorGrads(lists.gradtex, lists.colorGradiant, file);
+    if (lists.colorGradiant.empty())
+        readColorGrads(lists.gradtex, lists.colorGradiant, "stars.txt");
+    return lists;
+}
+
 float clamp01(float a)
 {
     if (a > 1)
@@ -405,29 +529,26 @@ float clamp01(float a)
         a = 0;
     return a;
 }
-float getcolor(float c, float var)
+float Generator::getcolor(float c, float var)
 {
     return clamp01(c - var + 2 * var * grand());
 }
-GradColor whichGradColor(float r, uint32_t &j)
+// The lists always hold at least one gradient: readColorGrads falls back to a white star
+GradColor Generator::whichGradColor(float r, uint32_t &j)
 {
-    if (colorGradiant.empty())
-    {
-        vector<string> entity;
-        string fullpath = "stars.txt";
-        readColorGrads(entity, fullpath.c_str());
-    }
-
     for (size_t i = 1; i < colorGradiant.size(); i++)
     {
         if (colorGradiant[i].minrad > r)
         {
+            j = i - 1;
             return colorGradiant[i - 1];
         }
     }
+    j = colorGradiant.size() - 1;
+    return colorGradiant.back();
 }
 
-Color StarColor(float radius, uint32_t &entityindex)
+Color Generator::StarColor(float radius, uint32_t &entityindex)
 {
     GradColor gc = whichGradColor(radius, entityindex);
     float r = getcolor(gc.r, gc.variance);
@@ -437,18 +558,19 @@ Color StarColor(float radius, uint32_t &entityindex)
 }
 GFXColor getStarColorFromRadius(float radius)
 {
+    static Generator colors(starColorLists("stars.txt"), time(nullptr));
     uint32_t myint = 0;
-    Color tmp = StarColor(radius * game_options.StarRadiusScale, myint);
+    Color tmp = colors.StarColor(radius * game_options.StarRadiusScale, myint);
     return GFXColor(tmp.r, tmp.g, tmp.b, 1);
 }
-float LengthOfYear(Vector r, Vector s)
+float Generator::LengthOfYear(Vector r, Vector s)
 {
     float a = 2 * M_PI * mmax(r.Mag(), s.Mag());
     float speed = minspeed + (maxspeed - minspeed) * grand();
     return a / speed;
 }
 
-void CreateLight(uint32_t i)
+void Generator::CreateLight(uint32_t i)
 {
     if (i == 0)
     {
@@ -492,7 +614,7 @@ void CreateLight(uint32_t i)
     WriteLight(i);
 }
 
-Vector generateCenter(float minradii, bool jumppoint)
+Vector Generator::generateCenter(float minradii, bool jumppoint)
 {
     Vector r;
     float tmpcompactness = compactness;
@@ -510,7 +632,7 @@ Vector generateCenter(float minradii, bool jumppoint)
     r.k = (i & 4) ? -r.k : r.k;
     return r;
 }
-float makeRS(Vector &r, Vector &s, float minradii, bool jumppoint)
+float Generator::makeRS(Vector &r, Vector &s, float minradii, bool jumppoint)
 {
     r = Vector(grand(), grand(), grand());
     int32_t i = (rnd(0, 8));
@@ -566,7 +688,7 @@ float makeRS(Vector &r, Vector &s, float minradii, bool jumppoint)
     return mmax(rm, sm);
 }
 
-void Updateradii(float orbitsize, float thisplanetradius)
+void Generator::Updateradii(float orbitsize, float thisplanetradius)
 {
 #ifdef HUGE_SYSTEMS
     orbitsize += thisplanetradius;
@@ -574,7 +696,7 @@ void Updateradii(float orbitsize, float thisplanetradius)
 #endif
 }
 
-Vector generateAndUpdateRS(Vector &r, Vector &s, float thisplanetradius, bool jumppoint)
+Vector Generator::generateAndUpdateRS(Vector &r, Vector &s, float thisplanetradius, bool jumppoint)
 {
     if (radii.empty())
     {
@@ -609,31 +731,33 @@ vector<string> parseBigUnit(const string &input)
     return ans;
 }
 
-void WriteUnit(const string &tag, const string &name, const string &filename, const Vector &r, const Vector &s,
-               const Vector &center, const string &nebfile, const string &destination, bool faction, float thisloy = 0)
+void Generator::WriteUnit(const string &tag, const string &name, const string &filename, const Vector &r,
+                          const Vector &s, const Vector &center, const string &nebfile, const string &destination,
+                          bool withfaction, float thisloy)
 {
-    Tab();
-    f.Fprintf("<%s name=\"%s\" file=\"%s\" ", tag.c_str(), name.c_str(), filename.c_str());
+    beginElement(tag.c_str());
+    attribute("name", name);
+    attribute("file", filename);
     if (nebfile.length() > 0)
     {
-        f.Fprintf("nebfile=\"%s\" ", nebfile.c_str());
+        attribute("nebfile", nebfile);
     }
-    f.Fprintf("ri=\"%f\" rj=\"%f\" rk=\"%f\" si=\"%f\" sj=\"%f\" sk=\"%f\" ", r.i, r.j, r.k, s.i, s.j, s.k);
-    f.Fprintf("x=\"%f\" y=\"%f\" z=\"%f\" ", center.i, center.j, center.k);
+    orbit(r, s);
+    position(center);
     float loy = LengthOfYear(r, s);
     if (loy || thisloy)
     {
-        f.Fprintf("year= \"%f\" ", thisloy ? thisloy : loy);
+        attribute("year", thisloy ? thisloy : loy);
     }
     if (destination.length())
     {
-        f.Fprintf("destination=\"%s\" ", destination.c_str());
+        attribute("destination", destination);
     }
-    else if (faction)
+    else if (withfaction)
     {
-        f.Fprintf("faction=\"%s\" ", StarSystemGent::faction.c_str());
+        attribute("faction", faction);
     }
-    f.Fprintf("/>\n");
+    endElement();
 }
 string getJumpTo(const string &s)
 {
@@ -723,7 +847,7 @@ string AnalyzeType(string &input, string &nebfile, float &radius)
     }
     return retval;
 }
-void MakeSmallUnit()
+void Generator::MakeSmallUnit()
 {
     Vector R, S;
 
@@ -756,8 +880,7 @@ void MakeSmallUnit()
     WriteUnit(type, "", nam, R, S, center, nebfile, s, true);
 }
 
-void MakeJump(float radius, bool forceRS = false, Vector R = Vector(0, 0, 0), Vector S = Vector(0, 0, 0),
-              Vector center = Vector(0, 0, 0), float thisloy = 0)
+void Generator::MakeJump(float radius, bool forceRS, Vector R, Vector S, Vector center, float thisloy)
 {
     string s = getRandName(jumps);
     if (s.length() == 0)
@@ -781,33 +904,33 @@ void MakeJump(float radius, bool forceRS = false, Vector R = Vector(0, 0, 0), Ve
     {
         *(thisname.begin() + 8) = toupper(*(thisname.begin() + 8));
     }
-    Tab();
-    // backwards compatibility
-    static bool usePNGFilename = (VSFileSystem::LookForFile("jump.png", VSFileSystem::TextureFile) <= VSFileSystem::Ok);
-    static const char *jumpFilename = usePNGFilename ? "jump.png" : "jump.texture";
-    f.Fprintf("<Jump name=\"%s\" file=\"%s\" ", thisname.c_str(), jumpFilename);
-    f.Fprintf("ri=\"%f\" rj=\"%f\" rk=\"%f\" si=\"%f\" sj=\"%f\" sk=\"%f\" ", RR.i, RR.j, RR.k, SS.i, SS.j, SS.k);
-    f.Fprintf("radius=\"%f\" ", radius);
-    f.Fprintf("x=\"%f\" y=\"%f\" z=\"%f\" ", center.i, center.j, center.k);
+    beginElement("Jump");
+    attribute("name", thisname);
+    attribute("file", jumpfile);
+    orbit(RR, SS);
+    attribute("radius", radius);
+    position(center);
     float loy = LengthOfYear(RR, SS);
     float temprandom = .1 * fmod(loy, 10); // use this so as not to alter state here
     if (loy || thisloy)
     {
-        f.Fprintf("year= \"%f\" ", thisloy ? thisloy : loy);
+        attribute("year", thisloy ? thisloy : loy);
         temprandom = grand();
         loy = 864 * temprandom;
         if (loy)
         {
-            f.Fprintf("day=\"%f\" ", loy);
+            attribute("day", loy);
         }
     }
-    f.Fprintf("alpha=\"ONE ONE\" destination=\"%s\" faction=\"%s\" />\n", getJumpTo(s).c_str(),
-              StarSystemGent::faction.c_str());
+    attribute("alpha", "ONE ONE");
+    attribute("destination", getJumpTo(s));
+    attribute("faction", faction);
+    endElement();
 
     /// writes out some pretty planet tags
 }
 
-void MakeBigUnit(int callingentitytype, string name = string(), float orbitalradius = 0)
+void Generator::MakeBigUnit(int callingentitytype, string name, float orbitalradius)
 {
     vector<string> fullname;
     if (name.length() == 0)
@@ -880,10 +1003,8 @@ void MakeBigUnit(int callingentitytype, string name = string(), float orbitalrad
         }
     }
 }
-void MakeMoons(float callingradius, int32_t callingentitytype);
-void MakeJumps(float callingradius, int32_t callingentitytype, int32_t numberofjumps);
-void MakePlanet(float radius, int32_t entitytype, string texturename, string unitname, string technique,
-                int32_t texturenum, int32_t numberofjumps, int32_t numberofstarbases)
+void Generator::MakePlanet(float radius, int32_t entitytype, string texturename, string unitname, string technique,
+                           int32_t texturenum, int32_t numberofjumps, int32_t numberofstarbases)
 {
     if (entitytype == JUMP)
     {
@@ -898,8 +1019,7 @@ void MakePlanet(float radius, int32_t entitytype, string texturename, string uni
     Vector center = generateAndUpdateRS(RR, SS, radius, false);
     string thisname;
     thisname = getRandName(names);
-    Tab();
-    string atmosphere = _Universe->getGalaxy()->getPlanetVariable(texturename, "atmosphere", "false");
+    string atmosphere = galaxy->getPlanetVariable(texturename, "atmosphere", "false");
     if (atmosphere == "false")
     {
         atmosphere = "";
@@ -909,7 +1029,7 @@ void MakePlanet(float radius, int32_t entitytype, string texturename, string uni
         atmosphere = game_options.DefaultAtmosphereTexture;
     }
     string cname;
-    string planetlites = _Universe->getGalaxy()->getPlanetVariable(texturename, "lights", "");
+    string planetlites = galaxy->getPlanetVariable(texturename, "lights", "");
     if (!planetlites.empty())
     {
         planetlites = ' ' + planetlites;
@@ -920,31 +1040,39 @@ void MakePlanet(float radius, int32_t entitytype, string texturename, string uni
         uint32_t randomnum = rnd(0, lites.size() - 1);
         cname = planetlites.substr(lites[randomnum] + 1, lites[randomnum + 1]);
     }
-    f.Fprintf("<Planet name=\"%s\" file=\"%s\" unit=\"%s\" ", thisname.c_str(), texturename.c_str(), unitname.c_str());
+    beginElement("Planet");
+    attribute("name", thisname);
+    attribute("file", texturename);
+    attribute("unit", unitname);
     if (!technique.empty())
     {
-        f.Fprintf("technique=\"%s\" ", technique.c_str());
+        attribute("technique", technique);
     }
     if (texturename.find_first_of('|') != string::npos)
     {
-        f.Fprintf("Red=\"0\" Green=\"0\" Blue=\"0\" DRed=\"0.87\" DGreen=\"0.87\" DBlue=\"0.87\" SRed=\"0.85\" "
-                  "SGreen=\"0.85\" SBlue=\"0.85\" ");
-    }
-    f.Fprintf("ri=\"%f\" rj=\"%f\" rk=\"%f\" si=\"%f\" sj=\"%f\" sk=\"%f\" ", RR.i, RR.j, RR.k, SS.i, SS.j, SS.k);
-    f.Fprintf("radius=\"%f\" ", radius);
-    f.Fprintf("x=\"%f\" y=\"%f\" z=\"%f\" ", center.i, center.j, center.k);
+        attribute("Red", "0");
+        attribute("Green", "0");
+        attribute("Blue", "0");
+        attribute("DRed", "0.87");
+        attribute("DGreen", "0.87");
+        attribute("DBlue", "0.87");
+        attribute("SRed", "0.85");
+        attribute("SGreen", "0.85");
+        attribute("SBlue", "0.85");
+    }
+    orbit(RR, SS);
+    attribute("radius", radius);
+    position(center);
     float loy = LengthOfYear(RR, SS);
     float temprandom = .1 * fmod(loy, 10); // use this so as not to alter state here
     if (loy)
     {
-        f.Fprintf("year= \"%f\" ", loy);
+        attribute("year", loy);
         temprandom = grand();
         loy = 864 * temprandom;
         if (loy)
-            f.Fprintf("day=\"%f\" ", loy);
+            attribute("day", loy);
     }
-    f.Fprintf(">\n");
-    xmllevel++;
     if (!cname.empty())
     {
         int32_t wrapx = 1;
@@ -955,8 +1083,11 @@ void MakePlanet(float radius, int32_t entitytype, string texturename, string uni
         {
             cname.replace(t, 1, texturenum == 0 ? "" : XMLSupport::tostring(texturenum));
         }
-        Tab();
-        f.Fprintf("<CityLights file=\"%s\" wrapx=\"%d\" wrapy=\"%d\"/>\n", cname.c_str(), wrapx, wrapy);
+        beginElement("CityLights");
+        attribute("file", cname);
+        attribute("wrapx", wrapx);
+        attribute("wrapy", wrapy);
+        endElement();
     }
     if ((entitytype == PLANET && temprandom < game_options.AtmosphereProbability) && (!atmosphere.empty()))
     {
@@ -968,9 +1099,11 @@ void MakePlanet(float radius, int32_t entitytype, string texturename, string uni
                 float fograd = radius * 1.007;
                 if (.007 * radius > 2500.0)
                     fograd = radius + 2500.0;
-                Tab();
-                f.Fprintf("<Atmosphere file=\"%s\" alpha=\"SRCALPHA INVSRCALPHA\" radius=\"%f\"/>\n",
-                          atmosphere.c_str(), fograd);
+                beginElement("Atmosphere");
+                attribute("file", atmosphere);
+                attribute("alpha", "SRCALPHA INVSRCALPHA");
+                attribute("radius", fograd);
+                endElement();
             }
             float r = .9, g = .9, b = 1, a = 1;
             float dr = .9, dg = .9, db = 1, da = 1;
@@ -996,22 +1129,30 @@ void MakePlanet(float radius, int32_t entitytype, string texturename, string uni
 | **************************************************************************************** |
 \*----------------------------------------------------------------------------------------*/
 
-            Tab();
-            f.Fprintf("<Fog>\n");
-            xmllevel++;
-            Tab();
-            f.Fprintf("<FogElement file=\"atmXatm.bfxm\" ScaleAtmosphereHeight=\"1.0\"  red=\"%f\" blue=\"%f\" "
-                      "green=\"%f\" alpha=\"%f\" dired=\"%f\" diblue=\"%f\" digreen=\"%f\" dialpha=\"%f\" "
-                      "concavity=\".3\" focus=\".6\" minalpha=\"0\" maxalpha=\"0.7\"/>\n",
-                      r, g, b, a, dr, dg, db, da);
-            Tab();
-            f.Fprintf("<FogElement file=\"atmXhalo.bfxm\" ScaleAtmosphereHeight=\"1.0\"  red=\"%f\" blue=\"%f\" "
-                      "green=\"%f\" alpha=\"%f\" dired=\"%f\" diblue=\"%f\" digreen=\"%f\" dialpha=\"%f\" "
-                      "concavity=\"1\" focus=\".6\" minalpha=\"0\" maxalpha=\"0.7\"/>\n",
-                      r, g, b, a, dr, dg, db, da);
-            xmllevel--;
-            Tab();
-            f.Fprintf("</Fog>\n");
+            beginElement("Fog");
+            const char *fogfiles[] = {"atmXatm.bfxm", "atmXhalo.bfxm"};
+            const char *concavities[] = {".3", "1"};
+            for (int i = 0; i < 2; ++i)
+            {
+                // green and blue have always gone out under each other's names
+                beginElement("FogElement");
+                attribute("file", fogfiles[i]);
+                attribute("ScaleAtmosphereHeight", "1.0");
+                attribute("red", r);
+                attribute("blue", g);
+                attribute("green", b);
+                attribute("alpha", a);
+                attribute("dired", dr);
+                attribute("diblue", dg);
+                attribute("digreen", db);
+                attribute("dialpha", da);
+                attribute("concavity", concavities[i]);
+                attribute("focus", ".6");
+                attribute("minalpha", "0");
+                attribute("maxalpha", "0.7");
+                endElement();
+            }
+            endElement();
         }
     }
     // FIRME: need scaling of radius based on planet type.
@@ -1050,10 +1191,7 @@ void MakePlanet(float radius, int32_t entitytype, string texturename, string uni
             }
             if (ringrand < (1 - game_options.DoubleRingProbability))
             {
-                Tab();
-                f.Fprintf("<Ring file=\"%s\" ri=\"%f\" rj=\"%f\" rk=\"%f\" si=\"%f\" sj=\"%f\" sk=\"%f\" "
-                          "innerradius=\"%f\" outerradius=\"%f\" wrapx=\"%d\" wrapy=\"%d\" />\n",
-                          ringname.c_str(), r.i, r.j, r.k, s.i, s.j, s.k, inner_rad, outer_rad, wrapx, wrapy);
+                MakeRing(ringname, r, s, inner_rad, outer_rad, wrapx, wrapy);
             }
             if (ringrand < game_options.DoubleRingProbability ||
                 ringrand >= (game_options.RingProbability - game_options.DoubleRingProbability))
@@ -1063,10 +1201,7 @@ void MakePlanet(float radius, int32_t entitytype, string texturename, string uni
                     outer_rad *
                     (1 + .1 * (game_options.SecondRingDifference + game_options.SecondRingDifference * movable));
                 outer_rad = inner_rad * (game_options.OuterRingRadius * movable);
-                Tab();
-                f.Fprintf("<Ring file=\"%s\" ri=\"%f\" rj=\"%f\" rk=\"%f\" si=\"%f\" sj=\"%f\" sk=\"%f\" "
-                          "innerradius=\"%f\" outerradius=\"%f\" wrapx=\"%d\" wrapy=\"%d\" />\n",
-                          ringname.c_str(), r.i, r.j, r.k, s.i, s.j, s.k, inner_rad, outer_rad, wrapx, wrapy);
+                MakeRing(ringname, r, s, inner_rad, outer_rad, wrapx, wrapy);
             }
         }
     }
@@ -1081,21 +1216,32 @@ void MakePlanet(float radius, int32_t entitytype, string texturename, string uni
     MakeJumps(100 + grand() * 300, entitytype, numberofjumps);
     moonlevel--;
     radii.pop_back();
-    xmllevel--;
-    Tab();
-    f.Fprintf("</Planet>\n");
+    endElement();
 
     // writes out some pretty planet tags
 }
 
-void MakeJumps(float callingradius, int callingentitytype, int numberofjumps)
+void Generator::MakeRing(const string &file, const Vector &r, const Vector &s, double inner_rad, double outer_rad,
+                         int32_t wrapx, int32_t wrapy)
+{
+    beginElement("Ring");
+    attribute("file", file);
+    orbit(r, s);
+    attribute("innerradius", inner_rad);
+    attribute("outerradius", outer_rad);
+    attribute("wrapx", wrapx);
+    attribute("wrapy", wrapy);
+    endElement();
+}
+
+void Generator::MakeJumps(float callingradius, int callingentitytype, int numberofjumps)
 {
     for (int i = 0; i < numberofjumps; i++)
     {
         MakeJump((.5 + .5 * grand()) * callingradius);
     }
 }
-void MakeMoons(float callingradius, int callingentitytype)
+void Generator::MakeMoons(float callingradius, int callingentitytype)
 {
     while (planetoffset < stars[staroffset].planets.size() &&
            stars[staroffset].planets[planetoffset].moonlevel == moonlevel)
@@ -1105,7 +1251,7 @@ void MakeMoons(float callingradius, int callingentitytype)
                    infos.unitname, infos.technique, infos.num, infos.numjumps, infos.numstarbases);
     }
 }
-void beginStar()
+void Generator::beginStar()
 {
     float radius = starradius[staroffset];
     Vector r, s;
@@ -1116,38 +1262,60 @@ void beginStar()
 
     char b[3] = " A";
     b[1] += staroffset;
-    Tab();
-    f.Fprintf("<Planet name=\"%s%s\" file=\"%s\" ", systemname.c_str(), b, starentities[staroffset].c_str());
-    f.Fprintf("ri=\"%f\" rj=\"%f\" rk=\"%f\" si=\"%f\" sj=\"%f\" sk=\"%f\" ", r.i, r.j, r.k, s.i, s.j, s.k);
+    const Color &light = lights[staroffset];
+    beginElement("Planet");
+    attribute("name", systemname + b);
+    attribute("file", starentities[staroffset]);
+    orbit(r, s);
+    attribute("radius", radius);
     if (staroffset != 0)
     {
-        f.Fprintf("radius=\"%f\" x=\"%f\" y=\"%f\" z=\"%f\" ", radius, center.i, center.j, center.k);
+        position(center);
     }
     else
     {
-        f.Fprintf("radius=\"%f\" x=\"0\" y=\"0\" z=\"0\" ", radius);
+        attribute("x", "0");
+        attribute("y", "0");
+        attribute("z", "0");
     }
     float loy = LengthOfYear(r, s);
     if (loy)
     {
-        f.Fprintf("year= \"%f\" ", loy);
+        attribute("year", loy);
         loy *= grand();
         if (loy)
-            f.Fprintf("day=\"%f\" ", loy);
-    }
-    f.Fprintf(" Red=\"%f\" Green=\"%f\" Blue=\"%f\" ReflectNoLight=\"true\" light=\"%d\">\n", lights[staroffset].r,
-              lights[staroffset].g, lights[staroffset].b, staroffset);
-    f.Fprintf(
-        "<fog>\n\t<FogElement file=\"atmXatm.bfxm\" ScaleAtmosphereHeight=\".900\" red=\"%f\" blue=\"%f\" green=\"%f\" "
-        "alpha=\"1.0\" dired=\"%f\" diblue=\"%f\" digreen=\"%f\" dialpha=\"1\" concavity=\".3\" focus=\".6\" "
-        "minalpha=\".7\" maxalpha=\"1\"/>\n\t<FogElement file=\"atmXhalo.bfxm\" ScaleAtmosphereHeight=\".9000\" "
-        "red=\"%f\" blue=\"%f\" green=\"%f\" alpha=\"1.0\" dired=\"%f\" diblue=\"%f\" digreen=\"%f\" dialpha=\"1\" "
-        "concavity=\".3\" focus=\".6\" minalpha=\".7\" maxalpha=\"1\"/>\n</fog>\n",
-        lights[staroffset].r, lights[staroffset].g, lights[staroffset].b, lights[staroffset].r, lights[staroffset].g,
-        lights[staroffset].b, lights[staroffset].r, lights[staroffset].g, lights[staroffset].b, lights[staroffset].r,
-        lights[staroffset].g, lights[staroffset].b);
+            attribute("day", loy);
+    }
+    attribute("Red", light.r);
+    attribute("Green", light.g);
+    attribute("Blue", light.b);
+    attribute("ReflectNoLight", "true");
+    attribute("light", (int32_t)staroffset);
+    beginElement("fog");
+    const char *fogfiles[] = {"atmXatm.bfxm", "atmXhalo.bfxm"};
+    const char *heights[] = {".900", ".9000"};
+    for (int f = 0; f < 2; ++f)
+    {
+        // green and blue have always gone out under each other's names
+        beginElement("FogElement");
+        attribute("file", fogfiles[f]);
+        attribute("ScaleAtmosphereHeight", heights[f]);
+        attribute("red", light.r);
+        attribute("blue", light.g);
+        attribute("green", light.b);
+        attribute("alpha", "1.0");
+        attribute("dired", light.r);
+        attribute("diblue", light.g);
+        attribute("digreen", light.b);
+        attribute("dialpha", "1");
+        attribute("concavity", ".3");
+        attribute("focus", ".6");
+        attribute("minalpha", ".7");
+        attribute("maxalpha", "1");
+        endElement();
+    }
+    endElement();
     radii.push_back(1.5 * radius);
-    xmllevel++;
     uint32_t numu;
     if (numstarentities)
     {
@@ -1180,19 +1348,17 @@ void beginStar()
     staroffset++;
 }
 
-void endStar()
+void Generator::endStar()
 {
     radii.pop_back();
-    xmllevel--;
-    Tab();
-    f.Fprintf("</Planet>\n");
+    endElement();
 }
-void CreateStar()
+void Generator::CreateStar()
 {
     beginStar();
     endStar();
 }
-void CreateFirstStar()
+void Generator::CreateFirstStar()
 {
     beginStar();
     while (staroffset < numstarentities)
@@ -1210,7 +1376,7 @@ void CreateFirstStar()
     endStar();
 }
 
-void CreatePrimaries()
+void Generator::CreatePrimaries()
 {
 
     for (size_t i = 0; i < numstarentities || i == 0; i++)
@@ -1220,19 +1386,15 @@ void CreatePrimaries()
     CreateFirstStar();
 }
 
-void CreateStarSystem()
+void Generator::CreateStarSystem()
 {
     assert(!starradius.empty());
     assert(starradius[0]);
-    xmllevel = 0;
-    Tab();
-    f.Fprintf("<?xml version=\"1.0\" ?>\n<system name=\"%s\" background=\"%s\">\n", systemname.c_str(),
-              getRandName(background).c_str());
-    xmllevel++;
+    beginElement("system");
+    attribute("name", systemname);
+    attribute("background", getRandName(background));
     CreatePrimaries();
-    xmllevel--;
-    Tab();
-    f.Fprintf("</system>\n");
+    endElement();
 }
 
 void readentity(vector<string> &entity, const char *filename)
@@ -1325,7 +1487,9 @@ void readnames(vector<string> &entity, const char *filename)
     f.Close();
 }
 
-void readplanetentity(vector<StarInfo> &starinfos, string planetlist, unsigned int numstars)
+namespace StarSystemGent
+{
+void Generator::readplanetentity(vector<StarInfo> &starinfos, string planetlist, unsigned int numstars)
 {
     if (numstars < 1)
     {
@@ -1361,8 +1525,6 @@ void readplanetentity(vector<StarInfo> &starinfos, string planetlist, unsigned i
         starinfos[u % numstars].planets.push_back(PlanetInfo());
         starinfos[u % numstars].planets.back().moonlevel = nummoon;
         {
-            GalaxyXML::Galaxy *galaxy = _Universe->getGalaxy();
-
             static const string numtag("#num#");
             static const string empty;
             static const string::size_type numlen = numtag.length();
@@ -1477,7 +1639,7 @@ void readplanetentity(vector<StarInfo> &starinfos, string planetlist, unsigned i
     }
 }
 
-static int32_t pushDown(int32_t val)
+int32_t Generator::pushDown(int32_t val)
 {
     while (grand() > (1 / val))
     {
@@ -1485,12 +1647,12 @@ static int32_t pushDown(int32_t val)
     }
     return val;
 }
-static int32_t pushDownTowardsMean(int32_t mean, int32_t val)
+int32_t Generator::pushDownTowardsMean(int32_t mean, int32_t val)
 {
     int32_t delta = mean - 1;
     return delta + pushDown(val - delta);
 }
-static int32_t pushTowardsMean(int32_t mean, int32_t val)
+int32_t Generator::pushTowardsMean(int32_t mean, int32_t val)
 {
     if (!game_options.PushValuesToMean)
     {
@@ -1503,22 +1665,13 @@ static int32_t pushTowardsMean(int32_t mean, int32_t val)
     return pushDownTowardsMean(mean, val);
 }
 
-void generateStarSystem(SystemInfo &si)
+Generator::Generator(const SystemInfo &si, const SystemLists &lists, const GalaxyXML::Galaxy *galaxy)
+    : galaxy(galaxy), starsysrandom(si.seed ? si.seed : stringhash(si.sector + '/' + si.name)), jumps(si.jumps), gradtex(lists.gradtex), naturalphenomena(lists.naturalphenomena), starbases(lists.starbases),
+      background(lists.background), names(lists.names), rings(lists.rings), systemname(si.name), faction(si.faction),
+      colorGradiant(lists.colorGradiant), compactness(si.compactness * game_options.CompactnessScale),
+      jumpcompactness(si.compactness * game_options.JumpCompactnessScale), jumpfile(lists.jumpfile), planetoffset(0),
+      staroffset(0), moonlevel(0)
 {
-    ResetGlobalVariables();
-    si.sunradius *= game_options.StarRadiusScale;
-    systemname = si.name;
-
-    compactness = si.compactness * game_options.CompactnessScale;
-    jumpcompactness = si.compactness * game_options.JumpCompactnessScale;
-    if (si.seed)
-    {
-        seedrand(si.seed);
-    }
-    else
-    {
-        seedrand(stringhash(si.sector + '/' + si.name));
-    }
     VSFileSystem::vs_fprintf(stderr, "star %d, natural %d, bases %d", si.numstars, si.numun1, si.numun2);
     int32_t nat = pushTowardsMean(game_options.MeanNaturalPhenomena, si.numun1);
     numnaturalphenomena = nat > si.numun1 ? si.numun1 : nat;
@@ -1528,43 +1681,278 @@ void generateStarSystem(SystemInfo &si)
     numstarentities = si.numstars;
     VSFileSystem::vs_fprintf(stderr, "star %d, natural %d, bases %d", numstarentities, numnaturalphenomena,
                              numstarbases);
-    starradius.push_back(si.sunradius);
-    readColorGrads(gradtex, (si.stars).c_str());
+    starradius.push_back(si.sunradius * game_options.StarRadiusScale);
+
+    readplanetentity(stars, si.planetlist, numstarentities);
+}
 
-    readentity(starbases, (si.smallun).c_str());
-    readentity(background, (si.backgrounds).c_str());
-    if (background.empty())
+SystemElement Generator::generate()
+{
+    CreateStarSystem();
+    return std::move(system);
+}
+
+// The lists are shared by most systems of a galaxy, so each file is only read once
+static const vector<string> &cachedEntity(const string &file, bool namelist = false)
+{
+    static std::map<string, vector<string>> entities;
+    static std::map<string, vector<string>> namelists;
+    std::map<string, vector<string>> &cache = namelist ? namelists : entities;
+    std::map<string, vector<string>>::iterator it = cache.find(file);
+    if (it == cache.end())
+    {
+        it = cache.insert(std::make_pair(file, vector<string>())).first;
+        if (namelist)
+            readnames(it->second, file.c_str());
+        else
+            readentity(it->second, file.c_str());
+    }
+    return it->second;
+}
+
+static SystemLists loadLists(const SystemInfo &si)
+{
+    static std::map<string, SystemLists> colors;
+    std::map<string, SystemLists>::iterator stars = colors.find(si.stars);
+    if (stars == colors.end())
+        stars = colors.insert(std::make_pair(si.stars, starColorLists(si.stars.c_str()))).first;
+    SystemLists lists = stars->second;
+    lists.starbases = cachedEntity(si.smallun);
+    lists.background = cachedEntity(si.backgrounds);
+    if (lists.background.empty())
     {
-        background.push_back(si.backgrounds);
+        lists.background.push_back(si.backgrounds);
     }
     if (si.nebulae)
     {
-        readentity(naturalphenomena, (si.nebulaelist).c_str());
+        const vector<string> &nebulae = cachedEntity(si.nebulaelist);
+        lists.naturalphenomena.insert(lists.naturalphenomena.end(), nebulae.begin(), nebulae.end());
     }
     if (si.asteroids)
     {
-        readentity(naturalphenomena, (si.asteroidslist).c_str());
+        const vector<string> &asteroids = cachedEntity(si.asteroidslist);
+        lists.naturalphenomena.insert(lists.naturalphenomena.end(), asteroids.begin(), asteroids.end());
     }
-    for (size_t i = 0; i < si.jumps.size(); i++)
-    {
-        jumps.push_back(si.jumps[i]);
+    lists.rings = cachedEntity(si.ringlist);
+    lists.names = cachedEntity(si.names, true);
+    // backwards compatibility
+    static bool usePNGFilename = (VSFileSystem::LookForFile("jump.png", VSFileSystem::TextureFile) <= VSFileSystem::Ok);
+    lists.jumpfile = usePNGFilename ? "jump.png" : "jump.texture";
+    return lists;
+}
+} // namespace StarSystemGent
+
+/*
+ * Systems next to the player are generated ahead of time by background threads. Each job owns a
+ * Generator and its lists, so the only shared state is the galaxy, which nothing writes to while a
+ * game is running (Universe::Init cancels the jobs before replacing it).
+ * Finished descriptions wait here for generateStarSystem, which hands them on to StarSystem::LoadXML.
+ * Whether the system already has a file is found out by the job too, so the main thread does not
+ * look for the files of all the systems next to the player.
+ */
+namespace
+{
+struct PregeneratedSystem
+{
+    enum State
+    {
+        Queued,
+        Running,
+        Done
+    };
+    State state;
+    SystemInfo si;
+    SystemLists lists;
+    const GalaxyXML::Galaxy *galaxy;
+    SystemElement system; // no name when the system has a file and was not generated
+};
+
+std::mutex pregen_mutex;
+std::condition_variable pregen_ready;
+std::condition_variable pregen_done;
+std::deque<PregeneratedSystem *> pregen_queue;
+std::map<string, std::unique_ptr<PregeneratedSystem>> pregenerated; // by file name
+int pregen_running = 0;
+
+// Descriptions generated for StarSystem::LoadXML but not loaded yet; main thread only
+std::map<string, SystemElement> generated;
+
+void pregenerateLoop()
+{
+    std::unique_lock<std::mutex> lock(pregen_mutex);
+    for (;;)
+    {
+        pregen_ready.wait(lock, [] { return !pregen_queue.empty(); });
+        PregeneratedSystem *job = pregen_queue.front();
+        pregen_queue.pop_front();
+        job->state = PregeneratedSystem::Running;
+        ++pregen_running;
+        lock.unlock();
+
+        SystemElement system;
+        if (!PlainFileExists(job->si.filename, SystemFile))
+            system = Generator(job->si, job->lists, job->galaxy).generate();
+
+        lock.lock();
+        job->system = std::move(system);
+        job->lists = SystemLists();
+        job->state = PregeneratedSystem::Done;
+        --pregen_running;
+        pregen_done.notify_all();
     }
-    faction = si.faction;
+}
 
-    readplanetentity(stars, si.planetlist, numstarentities);
+int pregenerateThreads()
+{
+    static int threads =
+        XMLSupport::parse_int(vs_config->getVariable("general", "pregenerate_system_threads", "1"));
+    return threads;
+}
 
-    readentity(rings, (si.ringlist).c_str());
-    readnames(names, (si.names).c_str());
+// Takes the pregenerated description of si if it was made from the same jumps
+bool takePregenerated(const SystemInfo &si, SystemElement &system)
+{
+    std::unique_lock<std::mutex> lock(pregen_mutex);
+    std::map<string, std::unique_ptr<PregeneratedSystem>>::iterator it = pregenerated.find(si.filename);
+    if (it == pregenerated.end())
+        return false;
+    PregeneratedSystem *job = it->second.get();
+    if (job->state == PregeneratedSystem::Queued)
+    {
+        // Not started: generating it right here is no slower than waiting for it
+        pregen_queue.erase(std::find(pregen_queue.begin(), pregen_queue.end(), job));
+        pregenerated.erase(it);
+        return false;
+    }
+    pregen_done.wait(lock, [job] { return job->state == PregeneratedSystem::Done; });
+    bool usable = job->si.jumps == si.jumps && !job->system.name.empty();
+    if (usable)
+        system = std::move(job->system);
+    pregenerated.erase(it);
+    return usable;
+}
+} // namespace
 
-    CreateDirectoryHome(VSFileSystem::sharedsectors + "/" + VSFileSystem::universe_name + "/" + si.sector);
+void pregenerateStarSystem(const SystemInfo &si)
+{
+    int threads = pregenerateThreads();
+    if (threads <= 0)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(pregen_mutex);
+        if (pregenerated.count(si.filename))
+            return;
+    }
+    // Everything read from disk is read now, on the main thread
+    std::unique_ptr<PregeneratedSystem> job(new PregeneratedSystem);
+    job->state = PregeneratedSystem::Queued;
+    job->si = si;
+    job->lists = loadLists(si);
+    job->galaxy = _Universe->getGalaxy();
+    static bool started = false;
+    if (!started)
+    {
+        started = true;
+        for (int i = 0; i < threads; ++i)
+            std::thread(pregenerateLoop).detach();
+    }
+    {
+        std::lock_guard<std::mutex> lock(pregen_mutex);
+        pregen_queue.push_back(job.get());
+        pregenerated[si.filename] = std::move(job);
+    }
+    pregen_ready.notify_one();
+}
 
-    VSError err = f.OpenCreateWrite(si.filename, SystemFile);
-    if (err <= Ok)
+static void writeElement(const SystemElement &element, int level, string &out)
+{
+    out.append(level, '\t');
+    out += '<';
+    out += element.name;
+    for (size_t i = 0; i + 1 < element.attributes.size(); i += 2)
+    {
+        out += ' ';
+        out += element.attributes[i];
+        out += "=\"";
+        for (string::const_iterator c = element.attributes[i + 1].begin(); c != element.attributes[i + 1].end(); ++c)
+        {
+            switch (*c)
+            {
+            case '&':
+                out += "&amp;";
+                break;
+            case '<':
+                out += "&lt;";
+                break;
+            case '"':
+                out += "&quot;";
+                break;
+            default:
+                out += *c;
+            }
+        }
+        out += '"';
+    }
+    if (element.children.empty())
     {
-        CreateStarSystem();
-        f.Close();
+        out += "/>\n";
+        return;
+    }
+    out += ">\n";
+    for (size_t i = 0; i < element.children.size(); ++i)
+        writeElement(element.children[i], level + 1, out);
+    out.append(level, '\t');
+    out += "</";
+    out += element.name;
+    out += ">\n";
+}
+
+string writeSystemXML(const SystemElement &system)
+{
+    string out = "<?xml version=\"1.0\" ?>\n";
+    writeElement(system, 0, out);
+    return out;
+}
+
+void cancelPregeneration()
+{
+    std::unique_lock<std::mutex> lock(pregen_mutex);
+    pregen_queue.clear();
+    pregen_done.wait(lock, [] { return pregen_running == 0; });
+    pregenerated.clear();
+    generated.clear();
+}
+
+bool takeGeneratedStarSystem(const string &file, SystemElement &system)
+{
+    std::map<string, SystemElement>::iterator it = generated.find(file);
+    if (it == generated.end())
+        return false;
+    system = std::move(it->second);
+    generated.erase(it);
+    return true;
+}
+
+void generateStarSystem(SystemInfo &si)
+{
+    static bool write_generated =
+        XMLSupport::parse_bool(vs_config->getVariable("general", "write_generated_systems", "true"));
+    SystemElement system;
+    if (!takePregenerated(si, system))
+        system = Generator(si, loadLists(si), _Universe->getGalaxy()).generate();
+    if (write_generated)
+    {
+        // Only a cache for later visits: the system is loaded from memory this time
+        CreateDirectoryHome(VSFileSystem::sharedsectors + "/" + VSFileSystem::universe_name + "/" + si.sector);
+        VSFile f;
+        VSError err = f.OpenCreateWrite(si.filename, SystemFile);
+        if (err <= Ok)
+        {
+            f.Write(writeSystemXML(system));
+            f.Close();
+        }
     }
-    ResetGlobalVariables(); // deallocate any unused memory in vectors.
+    generated[si.filename] = std::move(system);
 }
 #ifdef CONSOLE_APP
 int main(int argc, char **argv)
@@ -32,6 +32,14 @@ struct SystemInfo
     bool force;
 };
 
+/// One element of a generated system, as StarSystem::LoadXML takes it: the tree the system file would hold
+struct SystemElement
+{
+    string name;
+    vector<string> attributes; ///< name, value, name, value...
+    vector<SystemElement> children;
+};
+
 /// appends .system
 std::string getStarSystemFileName(const std::string &input);
 /// finds the name after all / characters and capitalizes the first letter
@@ -40,5 +48,14 @@ std::string getStarSystemName(const std::string &in);
 std::string getStarSystemSector(const std::string &in);
 string getUniversePath();
 void readnames(vector<string> &entity, const char *filename);
+/// generates the system into memory, for StarSystem::LoadXML, and (general/write_generated_systems) into its file
 void generateStarSystem(SystemInfo &si);
+/// has a background thread generate the system, so that generateStarSystem finds it ready
+void pregenerateStarSystem(const SystemInfo &si);
+/// drops all pregenerated systems, waiting for those being generated; call before the galaxy goes away
+void cancelPregeneration();
+/// hands over the description generateStarSystem made for file; false if there is none
+bool takeGeneratedStarSystem(const string &file, SystemElement &system);
+/// the text of the system file for a generated system
+string writeSystemXML(const SystemElement &system);
 #endif
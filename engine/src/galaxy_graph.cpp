@@ -0,0 +1,247 @@
+#include "galaxy_graph.h"
+#include "configxml.h"
+#include "faction_generic.h"
+#include "galaxy_xml.h"
+#include "lin_time.h"
+#include "universe_generic.h"
+#include "universe_util.h"
+#include "vs_globals.h"
+#include "xml_support.h"
+
+#include <algorithm>
+#include <float.h>
+#include <functional>
+#include <queue>
+
+using namespace GalaxyXML;
+using std::string;
+using std::vector;
+
+extern const vector<string> &ParseDestinations(const string &value);
+
+// Same fallbacks as Universe::getGalaxyProperty
+static const string &galaxyProperty(const Galaxy &galaxy, const string &sector, const string &name,
+                                    const string &prop)
+{
+    static const string empty;
+    return galaxy.getVariable(
+        sector, name, prop, galaxy.getVariable(sector, prop, galaxy.getVariable("unknown_sector", "min", prop, empty)));
+}
+
+static double routeExpiry()
+{
+    static double expiry = XMLSupport::parse_float(vs_config->getVariable("AI", "route_cache_seconds", "60"));
+    return expiry;
+}
+
+GalaxyGraph::GalaxyGraph(Galaxy &galaxy) : factionssynced(0), usecount(0)
+{
+    vector<vector<string>> jumplists;
+    SubHeirarchy &sectors = galaxy.getHeirarchy();
+    for (SubHeirarchy::iterator sector = sectors.begin(); sector != sectors.end(); ++sector)
+    {
+        if (sector->first == "<planets>")
+            continue;
+        SubHeirarchy &systems = sector->second.getHeirarchy();
+        for (SubHeirarchy::iterator system = systems.begin(); system != systems.end(); ++system)
+        {
+            string name = sector->first + "/" + system->first;
+            if (ids.count(name))
+                continue;
+            ids[name] = names.size();
+            names.push_back(name);
+            jumplists.push_back(ParseDestinations(galaxy.getVariable(sector->first, system->first, "jumps", "")));
+        }
+    }
+    // Jumps may lead to systems the galaxy has no entry for; they get an id (and no links) as well
+    offsets.reserve(names.size() + 1);
+    offsets.push_back(0);
+    for (size_t i = 0; i < jumplists.size(); ++i)
+    {
+        for (size_t j = 0; j < jumplists[i].size(); ++j)
+        {
+            const string &dest = jumplists[i][j];
+            std::unordered_map<string, SystemId>::const_iterator it = ids.find(dest);
+            if (it == ids.end())
+            {
+                it = ids.insert(std::make_pair(dest, (SystemId)names.size())).first;
+                names.push_back(dest);
+            }
+            links.push_back(it->second);
+        }
+        offsets.push_back(links.size());
+    }
+    offsets.resize(names.size() + 1, links.size());
+
+    positions.resize(names.size());
+    haspositions.resize(names.size(), false);
+    factions.resize(names.size(), -1);
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        string sector = getStarSystemSector(names[i]);
+        string name = getStarSystemName(names[i]);
+        const string &xyz = galaxyProperty(galaxy, sector, name, "xyz");
+        QVector &pos = positions[i];
+        haspositions[i] = xyz.size() && sscanf(xyz.c_str(), "%lf %lf %lf", &pos.i, &pos.j, &pos.k) >= 3;
+        const string &faction = galaxyProperty(galaxy, sector, name, "faction");
+        if (faction.size())
+            factions[i] = FactionUtil::GetFactionIndex(faction);
+    }
+}
+
+GalaxyGraph::SystemId GalaxyGraph::find(const string &system) const
+{
+    std::unordered_map<string, SystemId>::const_iterator it = ids.find(system);
+    return it == ids.end() ? NoSystem : it->second;
+}
+
+bool GalaxyGraph::getPosition(SystemId system, QVector &pos) const
+{
+    if (!haspositions[system])
+        return false;
+    pos = positions[system];
+    return true;
+}
+
+void GalaxyGraph::setFaction(SystemId system, int faction)
+{
+    if (factions[system] == faction)
+        return;
+    factions[system] = faction;
+    trees.erase(std::remove_if(trees.begin(), trees.end(), [](const Tree &t) { return t.faction >= 0; }),
+                trees.end());
+}
+
+// Takeovers live in the save game; pick them up now and then rather than on every route
+void GalaxyGraph::syncFactions() const
+{
+    factionssynced = getNewTime();
+    if (!_Universe || _Universe->numPlayers() == 0)
+        return;
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        string faction = UniverseUtil::GetGalaxyFaction(names[i]);
+        factions[i] = faction.size() ? FactionUtil::GetFactionIndex(faction) : -1;
+    }
+}
+
+void GalaxyGraph::buildTree(Tree &tree) const
+{
+    tree.prev.assign(names.size(), NoSystem);
+    tree.jumps.assign(names.size(), -1);
+    tree.jumps[tree.source] = 0;
+    tree.built = getNewTime();
+    if (tree.faction < 0)
+    {
+        vector<SystemId> frontier;
+        frontier.reserve(names.size());
+        frontier.push_back(tree.source);
+        for (size_t head = 0; head < frontier.size(); ++head)
+        {
+            SystemId system = frontier[head];
+            for (const SystemId *adj = beginAdjacent(system); adj != endAdjacent(system); ++adj)
+            {
+                if (tree.jumps[*adj] < 0)
+                {
+                    tree.jumps[*adj] = tree.jumps[system] + 1;
+                    tree.prev[*adj] = system;
+                    frontier.push_back(*adj);
+                }
+            }
+        }
+        return;
+    }
+    static float hostile_cost =
+        XMLSupport::parse_float(vs_config->getVariable("AI", "hostile_system_jump_cost", "4"));
+    typedef std::pair<float, SystemId> Open;
+    vector<float> cost(names.size(), FLT_MAX);
+    std::priority_queue<Open, vector<Open>, std::greater<Open>> open;
+    cost[tree.source] = 0;
+    open.push(Open(0, tree.source));
+    while (!open.empty())
+    {
+        Open top = open.top();
+        open.pop();
+        SystemId system = top.second;
+        if (top.first > cost[system])
+            continue;
+        for (const SystemId *adj = beginAdjacent(system); adj != endAdjacent(system); ++adj)
+        {
+            float step = 1;
+            if (factions[*adj] >= 0)
+                step += hostile_cost * std::max(0.0f, -FactionUtil::GetIntRelation(factions[*adj], tree.faction));
+            if (top.first + step < cost[*adj])
+            {
+                cost[*adj] = top.first + step;
+                tree.jumps[*adj] = tree.jumps[system] + 1;
+                tree.prev[*adj] = system;
+                open.push(Open(cost[*adj], *adj));
+            }
+        }
+    }
+}
+
+const GalaxyGraph::Tree &GalaxyGraph::getTree(SystemId source, int faction) const
+{
+    static size_t cache_size = XMLSupport::parse_int(vs_config->getVariable("AI", "route_cache_size", "16"));
+    double now = getNewTime();
+    if (faction >= 0 && now - factionssynced > routeExpiry())
+        syncFactions();
+    Tree *tree = nullptr;
+    for (size_t i = 0; i < trees.size() && !tree; ++i)
+        if (trees[i].source == source && trees[i].faction == faction)
+            tree = &trees[i];
+    if (tree && faction >= 0 && now - tree->built > routeExpiry())
+    {
+        // Relations drift during the game
+        buildTree(*tree);
+    }
+    else if (!tree)
+    {
+        if (trees.size() < std::max<size_t>(cache_size, 1))
+        {
+            trees.push_back(Tree());
+            tree = &trees.back();
+        }
+        else
+        {
+            tree = &trees[0];
+            for (size_t i = 1; i < trees.size(); ++i)
+                if (trees[i].lastused < tree->lastused)
+                    tree = &trees[i];
+        }
+        tree->source = source;
+        tree->faction = faction;
+        buildTree(*tree);
+    }
+    tree->lastused = ++usecount;
+    return *tree;
+}
+
+bool GalaxyGraph::route(SystemId from, SystemId to, vector<SystemId> &path, int faction) const
+{
+    path.clear();
+    if (from == NoSystem || to == NoSystem)
+        return false;
+    if (from == to)
+    {
+        path.push_back(from);
+        return true;
+    }
+    const Tree &tree = getTree(from, faction);
+    if (tree.jumps[to] < 0)
+        return false;
+    path.resize(tree.jumps[to] + 1);
+    for (SystemId system = to, i = tree.jumps[to]; i >= 0; system = tree.prev[system], --i)
+        path[i] = system;
+    return true;
+}
+
+int GalaxyGraph::jumps(SystemId from, SystemId to, int faction) const
+{
+    if (from == NoSystem || to == NoSystem)
+        return -1;
+    if (from == to)
+        return 0;
+    return getTree(from, faction).jumps[to];
+}
@@ -0,0 +1,102 @@
+#ifndef GALAXY_GRAPH_H_
+#define GALAXY_GRAPH_H_
+
+#include "gfx/vec.h"
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace GalaxyXML
+{
+class Galaxy;
+}
+
+/*
+ * The jump network of the galaxy, compiled once from the string keyed galaxy tree.
+ * Every system ("sector/name") gets a dense integer id and the jumps are kept in CSR form:
+ * the neighbours of system s are links[offsets[s]] .. links[offsets[s+1]-1], in the order of
+ * its "jumps" variable. Route queries only ever touch these arrays.
+ *
+ * Routes come from single source shortest path trees, which are cached per (source, faction)
+ * so that a second plot from the same system, or the next AI asking for the same trip, is a
+ * walk back along the tree.
+ */
+class GalaxyGraph
+{
+  public:
+    typedef int32_t SystemId;
+    static const SystemId NoSystem = -1;
+
+    explicit GalaxyGraph(GalaxyXML::Galaxy &galaxy);
+
+    size_t size() const
+    {
+        return names.size();
+    }
+    /// NoSystem when the galaxy does not know the system
+    SystemId find(const std::string &system) const;
+    const std::string &name(SystemId system) const
+    {
+        return names[system];
+    }
+    const SystemId *beginAdjacent(SystemId system) const
+    {
+        return links.data() + offsets[system];
+    }
+    const SystemId *endAdjacent(SystemId system) const
+    {
+        return links.data() + offsets[system + 1];
+    }
+    unsigned numAdjacent(SystemId system) const
+    {
+        return offsets[system + 1] - offsets[system];
+    }
+    /// The "xyz" galaxy property, false when the system has none
+    bool getPosition(SystemId system, QVector &pos) const;
+    /// Faction index owning the system, -1 when unknown
+    int getFaction(SystemId system) const
+    {
+        return factions[system];
+    }
+    /// For systems taken over during the game; drops the routes that depended on the old owner
+    void setFaction(SystemId system, int faction);
+
+    /*
+     * Fewest jumps from one system to the other, both ends included.
+     * With a faction >= 0 every jump into a system costs one plus AI/hostile_system_jump_cost
+     * times how much the owner of that system dislikes the faction, so ships route around
+     * hostile space when a short detour exists.
+     * Returns false, with an empty path, when to cannot be reached.
+     */
+    bool route(SystemId from, SystemId to, std::vector<SystemId> &path, int faction = -1) const;
+    /// Number of jumps on the route, -1 when unreachable
+    int jumps(SystemId from, SystemId to, int faction = -1) const;
+
+  private:
+    struct Tree
+    {
+        SystemId source;
+        int faction;
+        double built;
+        unsigned lastused;
+        std::vector<SystemId> prev; // NoSystem for the source and for unreachable systems
+        std::vector<int> jumps;     // -1 when unreachable
+    };
+    const Tree &getTree(SystemId source, int faction) const;
+    void buildTree(Tree &tree) const;
+    void syncFactions() const;
+
+    std::vector<std::string> names;
+    std::unordered_map<std::string, SystemId> ids;
+    std::vector<uint32_t> offsets;
+    std::vector<SystemId> links;
+    std::vector<QVector> positions;
+    std::vector<bool> haspositions;
+    mutable std::vector<int> factions;
+    mutable double factionssynced;
+    mutable std::vector<Tree> trees;
+    mutable unsigned usecount;
+};
+
+#endif
@@ -16,6 +16,7 @@
 #include "lin_time.h"
 #include "main_loop.h"
 #include "options.h"
+#include "savegame.h"
 #include "universe_util.h"
 #include "vegastrike.h"
 
@@ -450,6 +451,7 @@ bool GameMenu::processMainMenuButton(const EventCommandId &command, Control *con
 
 bool GameMenu::processExitGameButton(const EventCommandId &command, Control *control)
 {
+    WaitForSaveFileWrites();
     winsys_exit(0);
     return true;
 }
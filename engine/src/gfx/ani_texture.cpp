@@ -2,6 +2,7 @@
 #include "../gldrv/gl_globals.h"
 #include "aldrv/audiolib.h"
 #include "cmd/unit_generic.h"
+#include "configxml.h"
 #include "lin_time.h"
 #include "vegastrike.h"
 #include "vs_globals.h"
@@ -326,6 +327,10 @@ void AnimatedTexture::UpdateAllFrame()
         {
             ani->setTime(ani->curTime() + elapsed);
         }
+        if (ani->vidMode)
+        {
+            ani->Prefetch();
+        }
     }
 }
 
@@ -445,6 +450,8 @@ Texture *AnimatedTexture::Clone()
     {
         *retval = *this;
     }
+    // The decodes in flight belong to this texture
+    retval->prefetched.clear();
     if (vidSource)
     {
         retval->name = -1;
@@ -477,6 +484,7 @@ AnimatedTexture::AnimatedTexture()
 void AnimatedTexture::Destroy()
 {
     anis.erase(this);
+    DropPrefetched();
     if (vidSource)
     {
         delete vidSource;
@@ -770,6 +778,7 @@ void AnimatedTexture::LoadAni(VSFileSystem::VSFile &f, int32_t stage, enum FILTE
     {
         wrapper_file_path = f.GetFilename();
         wrapper_file_type = f.GetType();
+        wrapper_location = VSFileSystem::FileLocation(f);
     }
     original = nullptr;
     loadSuccess = true;
@@ -780,6 +789,161 @@ void AnimatedTexture::LoadAni(VSFileSystem::VSFile &f, int32_t stage, enum FILTE
     setTime(curtime);
 }
 
+static int32_t parseFrame(const string &line, char *file, char *alp, char *opt)
+{
+    int32_t numgets = sscanf(line.c_str(), "%s %s %[^\r\n]", file, alp, opt);
+    if ((numgets < 2) || (strcmp(alp, "-") == 0))
+    {
+        alp[0] = '\0';
+    }
+    return numgets;
+}
+
+uint32_t AnimatedTexture::frameAt(double time) const
+{
+    uint32_t frame = (uint32_t)(time / timeperframe);
+    return GetLoop() ? (frame % numframes) : std::min(frame, numframes - 1);
+}
+
+TextureLoader::Job *AnimatedTexture::QueueFrame(uint32_t frame)
+{
+    char file[512] = "white.bmp";
+    char alp[512] = "white.bmp";
+    char opt[512] = "";
+    int32_t numgets = parseFrame(frames[frame], file, alp, opt);
+    if ((alp[0] == '\0') && (numgets != 1))
+    {
+        return nullptr;
+    }
+    if (!g_game.use_videos && !g_game.use_textures)
+    {
+        return nullptr;
+    }
+    // Same alpha map lookup as Texture::Load
+    static bool use_alphamap = XMLSupport::parse_bool(vs_config->getVariable("graphics", "bitmap_alphamap", "true"));
+    string alpha;
+    if (use_alphamap)
+    {
+        alpha = alp;
+        if (numgets == 1)
+        {
+            alpha = file;
+            if (alpha.size() > 3)
+            {
+                alpha.replace(alpha.size() - 3, 3, "alp");
+            }
+        }
+    }
+
+    // Frames are found relative to the wrapper file, see LoadFrame
+    VSFileSystem::FileLocation::Scope lookup(wrapper_location);
+    VSFile *f = new VSFile;
+    VSError err = f->OpenReadOnly(file, TextureFile);
+    VSFile *f2 = nullptr;
+    if ((err <= Ok) && !alpha.empty())
+    {
+        f2 = new VSFile;
+        if (f2->OpenReadOnly(alpha, TextureFile) > Ok)
+        {
+            delete f2;
+            f2 = nullptr;
+        }
+    }
+    if (err > Ok)
+    {
+        delete f;
+        return nullptr;
+    }
+    return TextureLoader::QueueDecode(f, f2);
+}
+
+bool AnimatedTexture::UploadFrame(const VSImage &image, unsigned char *imagedata)
+{
+    // Only a frame just like the one bound can go straight into the existing texture: anything that
+    // would be converted, compressed or downsampled on the way is left to the full Texture::Load
+    Texture *decal = *Decal;
+    bool fits = imagedata && decal->bound && (decal->name != -1) && (image.sizeX == decal->boundSizeX) &&
+                (image.sizeY == decal->boundSizeY) && (image.mode == decal->boundMode) &&
+                ((image.mode == _24BIT) || (image.mode == _24BITRGBA)) &&
+                (image.sizeX <= static_cast<unsigned long>(gl_options.max_texture_dimension)) &&
+                (image.sizeY <= static_cast<unsigned long>(gl_options.max_texture_dimension));
+    if (fits)
+    {
+        GFXTransferSubTexture(imagedata, decal->name, 0, 0, image.sizeX, image.sizeY, decal->image_target);
+    }
+    if (imagedata)
+    {
+        free(imagedata);
+    }
+    if (image.palette)
+    {
+        free(image.palette);
+    }
+    return fits;
+}
+
+void AnimatedTexture::Prefetch()
+{
+    static int32_t lookahead =
+        XMLSupport::parse_int(vs_config->getVariable("graphics", "video_prefetch_frames", "4"));
+    if ((lookahead <= 0) || vidSource || (Decal == nullptr) || (*Decal == nullptr) || !timeperframe ||
+        (numframes > frames.size()))
+    {
+        return;
+    }
+    vector<uint32_t> window;
+    for (int32_t i = 0; i <= lookahead; i++)
+    {
+        window.push_back(frameAt(curtime + i * timeperframe));
+    }
+    // Drop what the animation has gone past, or skipped when the time jumped
+    for (size_t i = 0; i < prefetched.size();)
+    {
+        if (std::find(window.begin(), window.end(), prefetched[i].frame) == window.end())
+        {
+            if (prefetched[i].job)
+            {
+                TextureLoader::CancelDecode(prefetched[i].job);
+            }
+            prefetched.erase(prefetched.begin() + i);
+        }
+        else
+        {
+            i++;
+        }
+    }
+    for (size_t i = 0; i < window.size(); i++)
+    {
+        uint32_t frame = window[i];
+        if ((activebound < numframes) && (frames[frame] == frames[activebound]))
+        {
+            continue;
+        }
+        bool queued = false;
+        for (size_t j = 0; j < prefetched.size() && !queued; j++)
+        {
+            queued = (frames[prefetched[j].frame] == frames[frame]);
+        }
+        if (!queued)
+        {
+            PrefetchedFrame entry = {frame, QueueFrame(frame)};
+            prefetched.push_back(entry);
+        }
+    }
+}
+
+void AnimatedTexture::DropPrefetched()
+{
+    for (size_t i = 0; i < prefetched.size(); i++)
+    {
+        if (prefetched[i].job)
+        {
+            TextureLoader::CancelDecode(prefetched[i].job);
+        }
+    }
+    prefetched.clear();
+}
+
 void AnimatedTexture::LoadFrame(int32_t frame)
 {
     if (!vidMode || (Decal == nullptr) || (*Decal == nullptr))
@@ -794,16 +958,39 @@ void AnimatedTexture::LoadFrame(int32_t frame)
     {
         return;
     }
-    const char *temp = frames[frame].get().c_str();
+    for (size_t i = 0; i < prefetched.size(); ++i)
+    {
+        if (!(frames[prefetched[i].frame] == frames[frame]))
+        {
+            continue;
+        }
+        TextureLoader::Job *job = prefetched[i].job;
+        VSImage image;
+        unsigned char *imagedata = nullptr;
+        if (job && !TextureLoader::TakeDecoded(job, image, imagedata))
+        {
+            // Still decoding: rather show the last frame a bit longer than decode this one twice
+            if (activebound < numframes)
+            {
+                return;
+            }
+            TextureLoader::CancelDecode(job);
+            job = nullptr;
+        }
+        prefetched.erase(prefetched.begin() + i);
+        if (job && UploadFrame(image, imagedata))
+        {
+            original = nullptr;
+            loadSuccess = true;
+            activebound = frame;
+            return;
+        }
+        break;
+    }
     char file[512] = "white.bmp";
     char alp[512] = "white.bmp";
     char opt[512] = "";
-    int32_t numgets = 0;
-    numgets = sscanf(temp, "%s %s %[^\r\n]", file, alp, opt);
-    if ((numgets < 2) || (strcmp(alp, "-") == 0))
-    {
-        alp[0] = '\0';
-    }
+    int32_t numgets = parseFrame(frames[frame], file, alp, opt);
     string addrmodestr = XMLSupport::parse_option_value(opt, "addressMode", "");
     enum ADDRESSMODE addrmode = parseAddressMode(addrmodestr, defaultAddressMode);
 
@@ -814,8 +1001,7 @@ void AnimatedTexture::LoadFrame(int32_t frame)
     gl_options.compression = 0;
 
     // Without this, VSFileSystem won't find the file -- ugly, but it's how it is.
-    VSFile f;
-    VSError err = f.OpenReadOnly(wrapper_file_path, wrapper_file_type);
+    VSFileSystem::FileLocation::Scope lookup(wrapper_location);
 
     // Override mipmaping for video mode - too much overhead in generating the mipmamps.
     enum FILTER ismip2 =
@@ -836,10 +1022,6 @@ void AnimatedTexture::LoadFrame(int32_t frame)
     {
         loadSuccess = false;
     }
-    if (err <= Ok)
-    {
-        f.Close();
-    }
     gl_options.compression = ocompression;
 
     original = nullptr;
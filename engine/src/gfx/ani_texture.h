@@ -2,6 +2,7 @@
 #define __ANI_TEXTURE_H__
 
 #include "aux_texture.h"
+#include "texture_loader.h"
 #include "vid_file.h"
 #include "vsfilesystem.h"
 
@@ -35,6 +36,20 @@ class AnimatedTexture : public Texture
 
     StringPool::Reference wrapper_file_path;
     VSFileSystem::VSFileType wrapper_file_type;
+    VSFileSystem::FileLocation wrapper_location; // where the frames of video mode are looked for
+
+    // Video mode frames coming up next, decoded ahead by the TextureLoader workers
+    struct PrefetchedFrame
+    {
+        uint32_t frame;
+        TextureLoader::Job *job; // null when the frame has to be loaded by LoadFrame itself
+    };
+    vector<PrefetchedFrame> prefetched;
+    uint32_t frameAt(double time) const;
+    TextureLoader::Job *QueueFrame(uint32_t frame);
+    bool UploadFrame(const VSImage &image, unsigned char *imagedata);
+    void Prefetch();
+    void DropPrefetched();
 
     // Options
     enum optionenum
@@ -26,6 +26,7 @@
 #include "hashtable.h"
 #include "in_kb.h"
 #include "main_loop.h"
+#include "texture_loader.h"
 #include "vs_globals.h"
 #include "vsfilesystem.h"
 #include "vsimage.h"
@@ -77,6 +78,7 @@ void Texture::setReference(Texture *other)
     texfilename = other->texfilename;
     data = other->data;
     name = other->name;
+    pending = other->pending;
     bound = other->bound;
     boundSizeX = other->boundSizeX;
     boundSizeY = other->boundSizeY;
@@ -121,6 +123,7 @@ void Texture::InitTexture()
     bound = false;
     original = 0;
     refcount = 0;
+    pending = false;
     name = -1;
     palette = nullptr;
     data = nullptr;
@@ -133,10 +136,13 @@ void Texture::setold()
 {
     //*original = *this;//will be obsoleted in new C++ standard unpredictable results when using string() (and its
     //strangeass copy constructor)
+    // Other textures may have started sharing the entry while it loaded in the background (see
+    // TextureLoader): the entry keeps their count, which already includes this one
+    int refs = original->refcount;
     *original = *this;
     // memcpy (original, this, sizeof (Texture));
     original->original = nullptr;
-    original->refcount++;
+    original->refcount = refs;
 }
 
 const Texture *Texture::Original() const
@@ -161,7 +167,7 @@ Texture *Texture::Clone()
     Texture *target = Original();
     *retval = *target;
     // memcpy (this, target, sizeof (Texture));
-    if (retval->name != -1)
+    if (retval->name != -1 || retval->pending)
     {
         retval->original = target;
         retval->original->refcount++;
@@ -309,7 +315,8 @@ void Texture::Load(const char *FileName, int stage, enum FILTER mipmap, enum TEX
         t[tmp - 2] = 'l';
         t[tmp - 1] = 'p';
     }
-    VSFile f2;
+    // Heap allocated, so they can be handed over to the TextureLoader
+    VSFile *f2 = new VSFile;
     VSError err2 = VSFileSystem::FileNotFound;
     if (t)
     {
@@ -317,7 +324,7 @@ void Texture::Load(const char *FileName, int stage, enum FILTER mipmap, enum TEX
         {
             static bool use_alphamap = parse_bool(vs_config->getVariable("graphics", "bitmap_alphamap", "true"));
             if (use_alphamap)
-                err2 = f2.OpenReadOnly(t, TextureFile);
+                err2 = f2->OpenReadOnly(t, TextureFile);
         }
     }
     if (err2 <= Ok)
@@ -326,17 +333,17 @@ void Texture::Load(const char *FileName, int stage, enum FILTER mipmap, enum TEX
     }
     // this->texfilename = texfilename;
     // strcpy (filename,texfilename.c_str());
-    VSFile f;
+    VSFile *f = new VSFile;
     VSError err; // FIXME err not always initialized before use
     err = Ok;    // FIXME this line added temporarily by chuck_starchaser
     if (FileName)
         if (FileName[0])
-            err = f.OpenReadOnly(FileName, TextureFile);
+            err = f->OpenReadOnly(FileName, TextureFile);
     bool shared = (err == Shared);
     free(t);
     if (err <= Ok && g_game.use_textures == 0 && !force_load)
     {
-        f.Close();
+        f->Close();
         err = Unspecified;
     }
     if (err > Ok)
@@ -344,7 +351,9 @@ void Texture::Load(const char *FileName, int stage, enum FILTER mipmap, enum TEX
         FileNotFound(texfn);
         // VSFileSystem::vs_fprintf (stderr, "\n%s, not found\n",FileName);
         if (err2 <= Ok)
-            f2.Close();
+            f2->Close();
+        delete f;
+        delete f2;
         return;
     }
     if (!nocache)
@@ -352,14 +361,25 @@ void Texture::Load(const char *FileName, int stage, enum FILTER mipmap, enum TEX
         string tempstr;
         modold(texfn, shared, tempstr);
         texfilename = tempstr;
+        if (!main && f->Valid() && TextureLoader::Active())
+        {
+            if (err2 > Ok)
+            {
+                delete f2;
+                f2 = nullptr;
+            }
+            pending = original->pending = true;
+            TextureLoader::Queue(this, f, f2, maxdimension, detailtexture);
+            return;
+        }
     }
     if (texfn.find("white") == string::npos)
         bootstrap_draw("Loading " + string(FileName));
     // strcpy(filename, FileName);
     if (err2 > Ok)
-        data = this->ReadImage(&f, nullptr, true, nullptr);
+        data = this->ReadImage(f, nullptr, true, nullptr);
     else
-        data = this->ReadImage(&f, nullptr, true, &f2);
+        data = this->ReadImage(f, nullptr, true, f2);
     if (data)
     {
         if (mode >= _DXT1 && mode <= _DXT5)
@@ -383,9 +403,11 @@ void Texture::Load(const char *FileName, int stage, enum FILTER mipmap, enum TEX
     {
         FileNotFound(texfilename);
     }
-    f.Close();
-    if (f2.Valid())
-        f2.Close();
+    f->Close();
+    if (f2->Valid())
+        f2->Close();
+    delete f;
+    delete f2;
     // VSFileSystem::vs_fprintf (stderr," Load Success\n");
 }
 
@@ -503,8 +525,73 @@ void Texture::Load(const char *FileNameRGB, const char *FileNameA, int stage, en
     // VSFileSystem::vs_fprintf (stderr,"Load Success\n");
 }
 
+void Texture::FinishLoad(const VSImage &image, unsigned char *imagedata, int maxdimension, GFXBOOL detailtexture)
+{
+    pending = false;
+    if (original)
+        original->pending = false;
+    if (imagedata)
+    {
+        VSImage::operator=(image);
+        data = imagedata;
+        if (mode >= _DXT1 && mode <= _DXT5)
+        {
+            if ((int)data[0] == 0)
+            {
+                detailtexture = NEAREST;
+                ismipmapped = NEAREST;
+            }
+        }
+        Bind(maxdimension, detailtexture);
+        free(data);
+        data = nullptr;
+        if (original)
+            setold();
+    }
+    else if (!original || original->refcount > 1)
+    {
+        // Other textures already share the entry: keep it (as the placeholder) and just remember the failure
+        setbad(texfilename);
+        texHashTable.Delete(texfilename);
+    }
+    else
+    {
+        FileNotFound(texfilename);
+    }
+}
+
+void Texture::RefreshPending()
+{
+    Texture *shared = Original();
+    if (shared != this && !shared->pending)
+    {
+        name = shared->name;
+        bound = shared->bound;
+        boundSizeX = shared->boundSizeX;
+        boundSizeY = shared->boundSizeY;
+        boundMode = shared->boundMode;
+        pending = false;
+    }
+}
+
 Texture::~Texture()
 {
+    if (pending && original && original->pending && original->refcount > 1)
+    {
+        // Other textures share the entry: it finishes the load itself, for them
+        pending = false;
+        setold();
+        original->pending = TextureLoader::Handover(this, original);
+        if (!original->pending)
+            texHashTable.Delete(texfilename);
+    }
+    else if (pending && TextureLoader::Cancel(this))
+    {
+        // Nobody finishes the shared entry anymore: let the next user of this file load it again
+        if (original)
+            original->pending = false;
+        texHashTable.Delete(texfilename);
+    }
     if (original == nullptr)
     {
         /**DEPRECATED
@@ -649,7 +736,10 @@ int Texture::Bind(Texture *other, int maxdimension, GFXBOOL detailtexture)
 
 void Texture::Prioritize(float priority)
 {
-    GFXPrioritizeTexture(name, priority);
+    if (pending)
+        TextureLoader::Prioritize(this, priority);
+    else
+        GFXPrioritizeTexture(name, priority);
 }
 
 static void ActivateWhite(int stage)
@@ -661,6 +751,8 @@ static void ActivateWhite(int stage)
 
 void Texture::MakeActive(int stag, int pass)
 {
+    if (pending)
+        RefreshPending();
     if ((name == -1) || (pass != 0))
     {
         ActivateWhite(stag);
@@ -71,6 +71,8 @@ class Texture : public ::VSImage
 
     /// The number of references on the original data
     int refcount;
+    /// Whether the data is still being loaded in the background (see TextureLoader)
+    bool pending;
 
     /// The target this will go to (cubemap or otherwise)
     enum TEXTURE_TARGET texture_target;
@@ -100,6 +102,11 @@ class Texture : public ::VSImage
 
     /// Transfers this texture to GFX library
     void Transfer(int maxdimension, GFXBOOL detailtexture);
+    /// Binds the image decoded by the TextureLoader, taking over its data
+    void FinishLoad(const VSImage &image, unsigned char *data, int maxdimension, GFXBOOL detailtexture);
+    /// Picks up the data of the shared texture once its background load is done
+    void RefreshPending();
+    friend class TextureLoader;
 
   public:
     /// Binds this texture to the same name as the given texture - for multipart textures
@@ -258,7 +265,7 @@ class Texture : public ::VSImage
     /// If the texture has loaded properly returns true
     virtual bool LoadSuccess()
     {
-        return name >= 0;
+        return name >= 0 || pending;
     }
 
     /// Changes priority of texture
@@ -1300,7 +1300,14 @@ float GameCockpit::LookupUnitStat(int stat, Unit *target)
             return display_in_meters ? value : value * 3.6; // JMS 6/28/05 - converted back to raw meters/second
     }
     case UnitImages<void>::MASSEFFECT: {
-        float basemass = atof(UniverseUtil::LookupUnitStat(target->name, "", "Mass").c_str());
+        // The stock mass only changes with the ship type; skip the unit table lookup otherwise
+        static std::string basemassname;
+        static float basemass = 0;
+        if (basemassname.empty() || basemassname != target->name.get())
+        {
+            basemassname = target->name.get();
+            basemass = atof(UniverseUtil::LookupUnitStat(basemassname, "", "Mass").c_str());
+        }
         if (basemass > 0)
             return 100 * target->Mass / basemass;
         else
@@ -1530,10 +1537,10 @@ void GameCockpit::TriggerEvents(Unit *un)
     } while (0)
 
 #define MODAL_IMAGE_TRIGGER(image, itrigger, btrigger, lastvar)                                                        \
-    MODAL_TRIGGER(#image, btrigger, LookupUnitStat(UnitImages<void>::image, un) == UnitImages<void>::itrigger, lastvar)
+    MODAL_TRIGGER(#image, btrigger, CachedUnitStat(UnitImages<void>::image, un) == UnitImages<void>::itrigger, lastvar)
 
 #define MODAL_RAWIMAGE_TRIGGER(image, itrigger, btrigger, lastvar)                                                     \
-    MODAL_TRIGGER(#image, btrigger, LookupUnitStat(UnitImages<void>::image, un) itrigger, lastvar)
+    MODAL_TRIGGER(#image, btrigger, CachedUnitStat(UnitImages<void>::image, un) itrigger, lastvar)
 
             switch ((int)event)
             {
@@ -1568,7 +1575,7 @@ void GameCockpit::TriggerEvents(Unit *un)
                 MODAL_IMAGE_TRIGGER(CANDOCK_MODAL, AUTOREADY, true, asap_dock_avail);
                 break;
             case ASAP_DOCKING_ENGAGED: {
-                float candock = LookupUnitStat(UnitImages<void>::CANDOCK_MODAL, un);
+                float candock = CachedUnitStat(UnitImages<void>::CANDOCK_MODAL, un);
                 MODAL_TRIGGER("ASAP_DOCKING", true,
                               (un->autopilotactive &&
                                (candock == UnitImages<void>::READY || candock == UnitImages<void>::AUTOREADY)),
@@ -1576,7 +1583,7 @@ void GameCockpit::TriggerEvents(Unit *un)
             }
             break;
             case ASAP_DOCKING_DISENGAGED: {
-                float candock = LookupUnitStat(UnitImages<void>::CANDOCK_MODAL, un);
+                float candock = CachedUnitStat(UnitImages<void>::CANDOCK_MODAL, un);
                 MODAL_TRIGGER("ASAP_DOCKING", false,
                               (un->autopilotactive &&
                                (candock == UnitImages<void>::READY || candock == UnitImages<void>::AUTOREADY)),
@@ -1641,6 +1648,164 @@ void GameCockpit::TriggerEvents(Unit *un)
     }         // for
 }
 
+float GameCockpit::CachedUnitStat(int stat, Unit *target)
+{
+    static double interval =
+        XMLSupport::parse_float(vs_config->getVariable("graphics", "hud", "gauge_update_interval", "0.05"));
+    unsigned int stamp = target ? target->ConfigStamp() : 0;
+    if (gaugeunit != target || gaugestamp != stamp)
+    {
+        ResetGaugeStates();
+        gaugeunit = target;
+        gaugestamp = stamp;
+    }
+    GaugeState &state = gaugestates[stat];
+    double now = getNewTime();
+    if (state.evaluated < 0 || now - state.evaluated >= interval || now < state.evaluated)
+    {
+        state.value = LookupUnitStat(stat, target);
+        state.evaluated = now;
+    }
+    return state.value;
+}
+
+void GameCockpit::ResetGaugeStates()
+{
+    for (int i = 0; i < UnitImages<void>::NUMGAUGES; ++i)
+    {
+        gaugestates[i].evaluated = -1;
+        gaugestates[i].text.clear();
+    }
+    gaugeunit = nullptr;
+    gaugestamp = 0;
+}
+
+const std::string &GameCockpit::GaugeText(int stat, Unit *target)
+{
+    GaugeState &state = gaugestates[stat];
+    float tmp = CachedUnitStat(stat, target);
+    if (state.text.size() && tmp == state.textvalue)
+        return state.text;
+    state.textvalue = tmp;
+    if (stat < UnitImages<void>::AUTOPILOT_MODAL)
+    {
+        char ourchar[64];
+        sprintf(ourchar, "%.0f", tmp);
+        if (stat == UnitImages<void>::KPS)
+        {
+            float c = 300000000.0f;
+            if (tmp > c / 10)
+                sprintf(ourchar, "%.2f C", tmp / c);
+        }
+        if (stat == UnitImages<void>::MASSEFFECT)
+            sprintf(ourchar, "MASS:%.0f%% (base)", tmp);
+        state.text = ourchar;
+        return state.text;
+    }
+    int ivalue = (int)tmp;
+    std::string modename;
+    std::string modevalue;
+    switch (stat)
+    {
+    case UnitImages<void>::AUTOPILOT_MODAL:
+        modename = "AUTO:";
+        break;
+    case UnitImages<void>::SPEC_MODAL:
+        modename = "SPEC:";
+        break;
+    case UnitImages<void>::FLIGHTCOMPUTER_MODAL:
+        modename = "FCMP:";
+        break;
+    case UnitImages<void>::TURRETCONTROL_MODAL:
+        modename = "TCNT:";
+        break;
+    case UnitImages<void>::ECM_MODAL:
+        modename = "ECM :";
+        break;
+    case UnitImages<void>::CLOAK_MODAL:
+        modename = "CLK :";
+        break;
+    case UnitImages<void>::TRAVELMODE_MODAL:
+        modename = "GCNT:";
+        break;
+    case UnitImages<void>::RECIEVINGFIRE_MODAL:
+        modename = "RFIR:";
+        break;
+    case UnitImages<void>::RECEIVINGMISSILES_MODAL:
+        modename = "RMIS:";
+        break;
+    case UnitImages<void>::RECEIVINGMISSILELOCK_MODAL:
+        modename = "RML :";
+        break;
+    case UnitImages<void>::RECEIVINGTARGETLOCK_MODAL:
+        modename = "RTL :";
+        break;
+    case UnitImages<void>::COLLISIONWARNING_MODAL:
+        modename = "COL :";
+        break;
+    case UnitImages<void>::CANJUMP_MODAL:
+        modename = "JUMP:";
+        break;
+    case UnitImages<void>::CANDOCK_MODAL:
+        modename = "DOCK:";
+        break;
+    default:
+        modename = "UNK :";
+    }
+    switch (ivalue)
+    {
+    case UnitImages<void>::OFF:
+        modevalue = "OFF";
+        break;
+    case UnitImages<void>::ON:
+        modevalue = "ON";
+        break;
+    case UnitImages<void>::SWITCHING:
+        modevalue = "<>";
+        break;
+    case UnitImages<void>::ACTIVE:
+        modevalue = "ACTIVE";
+        break;
+    case UnitImages<void>::FAW:
+        modevalue = "FAW";
+        break;
+    case UnitImages<void>::MANEUVER:
+        modevalue = "MANEUVER";
+        break;
+    case UnitImages<void>::TRAVEL:
+        modevalue = "TRAVEL";
+        break;
+    case UnitImages<void>::NOT_APPLICABLE:
+        modevalue = "N / A";
+        break;
+    case UnitImages<void>::READY:
+        modevalue = "READY";
+        break;
+    case UnitImages<void>::NODRIVE:
+        modevalue = "NO DRIVE";
+        break;
+    case UnitImages<void>::TOOFAR:
+        modevalue = "TOO FAR";
+        break;
+    case UnitImages<void>::NOT_ENOUGH_ENERGY:
+        modevalue = "LOW ENERGY";
+        break;
+    case UnitImages<void>::WARNING:
+        modevalue = "WARNING!";
+        break;
+    case UnitImages<void>::NOMINAL:
+        modevalue = " - ";
+        break;
+    case UnitImages<void>::AUTOREADY:
+        modevalue = "AUTO READY";
+        break;
+    default:
+        modevalue = "MALFUNCTION!";
+    }
+    state.text = modename + modevalue;
+    return state.text;
+}
+
 void GameCockpit::DrawGauges(Unit *un)
 {
     int i;
@@ -1648,7 +1813,7 @@ void GameCockpit::DrawGauges(Unit *un)
     {
         if (gauges[i])
         {
-            gauges[i]->Draw(LookupUnitStat(i, un));
+            gauges[i]->Draw(CachedUnitStat(i, un));
             float damage = un->GetImageInformation()
                                .cockpit_damage[(1 + MAXVDUS + i) % (MAXVDUS + 1 + UnitImages<void>::NUMGAUGES)];
             if (gauge_time[i] >= 0)
@@ -1678,7 +1843,7 @@ void GameCockpit::DrawGauges(Unit *un)
     bool automatte = (0 == origbgcol.a);
     if (automatte)
         text->bgcol = GFXColor(0, 0, 0, background_alpha);
-    for (i = UnitImages<void>::KPS; i < UnitImages<void>::AUTOPILOT_MODAL; i++)
+    for (i = UnitImages<void>::KPS; i < UnitImages<void>::NUMGAUGES; i++)
     {
         if (gauges[i])
         {
@@ -1687,140 +1852,9 @@ void GameCockpit::DrawGauges(Unit *un)
             gauges[i]->GetPosition(px, py);
             text->SetCharSize(sx, sy);
             text->SetPos(px, py);
-            float tmp = LookupUnitStat(i, un);
-            float tmp2 = 0;
-            char ourchar[64];
-            sprintf(ourchar, "%.0f", tmp);
-            if (i == UnitImages<void>::KPS)
-            {
-                float c = 300000000.0f;
-                if (tmp > c / 10)
-                {
-                    tmp2 = tmp / c;
-                    sprintf(ourchar, "%.2f C", tmp2);
-                }
-            }
-            if (i == UnitImages<void>::MASSEFFECT)
-                sprintf(ourchar, "MASS:%.0f%% (base)", tmp);
-            GFXColorf(textcol);
-            text->SetSize(2, -2);
-            text->Draw(string(ourchar), 0, false, false, automatte);
-        }
-    }
-    for (i = UnitImages<void>::AUTOPILOT_MODAL; i < UnitImages<void>::NUMGAUGES; i++)
-    {
-        if (gauges[i])
-        {
-            float sx, sy, px, py;
-            gauges[i]->GetSize(sx, sy);
-            gauges[i]->GetPosition(px, py);
-            text->SetCharSize(sx, sy);
-            text->SetPos(px, py);
-            float tmp = LookupUnitStat(i, un);
-            int ivalue = (int)tmp;
-            std::string modename;
-            std::string modevalue;
-            switch (i)
-            {
-            case UnitImages<void>::AUTOPILOT_MODAL:
-                modename = "AUTO:";
-                break;
-            case UnitImages<void>::SPEC_MODAL:
-                modename = "SPEC:";
-                break;
-            case UnitImages<void>::FLIGHTCOMPUTER_MODAL:
-                modename = "FCMP:";
-                break;
-            case UnitImages<void>::TURRETCONTROL_MODAL:
-                modename = "TCNT:";
-                break;
-            case UnitImages<void>::ECM_MODAL:
-                modename = "ECM :";
-                break;
-            case UnitImages<void>::CLOAK_MODAL:
-                modename = "CLK :";
-                break;
-            case UnitImages<void>::TRAVELMODE_MODAL:
-                modename = "GCNT:";
-                break;
-            case UnitImages<void>::RECIEVINGFIRE_MODAL:
-                modename = "RFIR:";
-                break;
-            case UnitImages<void>::RECEIVINGMISSILES_MODAL:
-                modename = "RMIS:";
-                break;
-            case UnitImages<void>::RECEIVINGMISSILELOCK_MODAL:
-                modename = "RML :";
-                break;
-            case UnitImages<void>::RECEIVINGTARGETLOCK_MODAL:
-                modename = "RTL :";
-                break;
-            case UnitImages<void>::COLLISIONWARNING_MODAL:
-                modename = "COL :";
-                break;
-            case UnitImages<void>::CANJUMP_MODAL:
-                modename = "JUMP:";
-                break;
-            case UnitImages<void>::CANDOCK_MODAL:
-                modename = "DOCK:";
-                break;
-            default:
-                modename = "UNK :";
-            }
-            switch (ivalue)
-            {
-            case UnitImages<void>::OFF:
-                modevalue = "OFF";
-                break;
-            case UnitImages<void>::ON:
-                modevalue = "ON";
-                break;
-            case UnitImages<void>::SWITCHING:
-                modevalue = "<>";
-                break;
-            case UnitImages<void>::ACTIVE:
-                modevalue = "ACTIVE";
-                break;
-            case UnitImages<void>::FAW:
-                modevalue = "FAW";
-                break;
-            case UnitImages<void>::MANEUVER:
-                modevalue = "MANEUVER";
-                break;
-            case UnitImages<void>::TRAVEL:
-                modevalue = "TRAVEL";
-                break;
-            case UnitImages<void>::NOT_APPLICABLE:
-                modevalue = "N / A";
-                break;
-            case UnitImages<void>::READY:
-                modevalue = "READY";
-                break;
-            case UnitImages<void>::NODRIVE:
-                modevalue = "NO DRIVE";
-                break;
-            case UnitImages<void>::TOOFAR:
-                modevalue = "TOO FAR";
-                break;
-            case UnitImages<void>::NOT_ENOUGH_ENERGY:
-                modevalue = "LOW ENERGY";
-                break;
-            case UnitImages<void>::WARNING:
-                modevalue = "WARNING!";
-                break;
-            case UnitImages<void>::NOMINAL:
-                modevalue = " - ";
-                break;
-            case UnitImages<void>::AUTOREADY:
-                modevalue = "AUTO READY";
-                break;
-            default:
-                modevalue = "MALFUNCTION!";
-            }
             GFXColorf(textcol);
-            // text->SetSize(px+textwidthapproxHACK*(modename.size()+modevalue.size()), -2);
             text->SetSize(2, -2);
-            text->Draw(modename + modevalue, 0, false, false, automatte);
+            text->Draw(GaugeText(i, un), 0, false, false, automatte);
         }
     }
     text->bgcol = origbgcol;
@@ -1934,6 +1968,7 @@ GameCockpit::GameCockpit(const char *file, Unit *parent, const std::string &pilo
     }
     for (i = 0; i < UnitImages<void>::NUMGAUGES; i++)
         gauges[i] = nullptr;
+    ResetGaugeStates();
     radarSprites[0] = radarSprites[1] = Pit[0] = Pit[1] = Pit[2] = Pit[3] = nullptr;
 
     static bool st_draw_all_boxes =
@@ -3831,6 +3866,7 @@ void GameCockpit::updateRadar(Unit *ship)
 void GameCockpit::SetParent(Unit *unit, const char *filename, const char *unitmodname, const QVector &startloc)
 {
     this->Cockpit::SetParent(unit, filename, unitmodname, startloc);
+    ResetGaugeStates();
     updateRadar(unit);
 }
 void GameCockpit::OnDockEnd(Unit *station, Unit *ship)
@@ -100,6 +100,20 @@ class GameCockpit : public Cockpit
     /// The font that the entire cockpit will use. Currently without color
     TextPlane *text;
     Gauge *gauges[UnitImages<void>::NUMGAUGES];
+    /// Last value of each gauge and the text drawn for it, so the HUD need not look every stat up every frame
+    struct GaugeState
+    {
+        float value;
+        double evaluated; // real time, -1 when stale
+        float textvalue;  // value text was formatted from
+        std::string text;
+    };
+    GaugeState gaugestates[UnitImages<void>::NUMGAUGES];
+    const Unit *gaugeunit;
+    /// ConfigStamp of gaugeunit: units are pooled, so a new one may turn up at the address of the last
+    unsigned int gaugestamp;
+    /// Makes every gauge look its stat up again
+    void ResetGaugeStates();
     /// holds misc panels.  Panel[0] is always crosshairs (and adjusted to be in center of view screen, not cockpit)
     std::vector<VSSprite *> Panel;
     /// flag to decide whether to draw all target boxes
@@ -192,6 +206,10 @@ class GameCockpit : public Cockpit
     float LookupTargetStat(int stat, Unit *target);
     /// Looks up a particular Gauge stat on unit
     float LookupUnitStat(int stat, Unit *target);
+    /// LookupUnitStat at most once per graphics/hud/gauge_update_interval, for what the HUD displays
+    float CachedUnitStat(int stat, Unit *target);
+    /// Text of a digital or modal gauge, reformatted only when its value changes
+    const std::string &GaugeText(int stat, Unit *target);
     /// Loads cockpit info...just as constructor
     void Init(const char *file);
     /// Draws Cockpit then restores viewport
@@ -11,6 +11,7 @@
 #include "faction_generic.h"
 #endif
 #include <assert.h>
+#include <string.h>
 
 #include "vegastrike.h"
 
@@ -227,11 +228,9 @@ struct OrigMeshLoader
 #define READSTRING(inmemfile, word32index, stringlen, stringvar)                                                       \
     do                                                                                                                 \
     { /* By Klauss - Much more efficient than the preceding code, and yet still portable */                            \
-        uchar8bit *inmemstring = (uchar8bit *)(inmemfile + word32index);                                               \
-        uchar8bit oc = inmemstring[stringlen];                                                                         \
-        inmemstring[stringlen] = 0;                                                                                    \
-        stringvar = (const char *)inmemstring;                                                                         \
-        inmemstring[stringlen] = oc;                                                                                   \
+        /* The buffer may be a read only mapping, so never terminate the string in place */                          \
+        const char *inmemstring = (const char *)(inmemfile + word32index);                                             \
+        stringvar.assign(inmemstring, strnlen(inmemstring, stringlen));                                                \
         word32index += (stringlen + 3) / 4;                                                                            \
     } while (0)
 
@@ -316,7 +315,8 @@ vector<Mesh *> Mesh::LoadMeshes(VSFileSystem::VSFile &Inputfile, const Vector &s
         uint32bit i32val;
         float32bit f32val;
         uchar8bit c8val[4];
-    } * inmemfile;
+    };
+    const chunk32 *inmemfile;
 #ifdef STANDALONE
     printf("Loading Mesh File: %s\n", Inputfile.GetFilename().c_str());
     fseek(Inputfile, 4 + sizeof(uint32bit), SEEK_SET);
@@ -327,15 +327,16 @@ vector<Mesh *> Mesh::LoadMeshes(VSFileSystem::VSFile &Inputfile, const Vector &s
         fprintf(stderr, "Corrupt file %s, aborting\n", Inputfile.GetFilename().c_str());
         exit(-1);
     }
-    inmemfile = (chunk32 *)malloc(Inputlength + 1);
-    if (!inmemfile)
+    chunk32 *inmembuffer = (chunk32 *)malloc(Inputlength + 1);
+    if (!inmembuffer)
     {
         fprintf(stderr, "Buffer allocation failed, Aborting");
         exit(-1);
     }
     rewind(Inputfile);
-    fread(inmemfile, 1, Inputlength, Inputfile);
+    fread(inmembuffer, 1, Inputlength, Inputfile);
     fcloseInput(Inputfile);
+    inmemfile = inmembuffer;
 #else
     uint32bit Inputlength = Inputfile.Size();
     if (Inputlength < sizeof(uint32bit) * 13 || Inputlength > (1 << 30))
@@ -343,14 +344,14 @@ vector<Mesh *> Mesh::LoadMeshes(VSFileSystem::VSFile &Inputfile, const Vector &s
         fprintf(stderr, "Corrupt file %s, aborting\n", Inputfile.GetFilename().c_str());
         abort();
     }
-    inmemfile = (chunk32 *)malloc(Inputlength);
+    // Parse straight out of the file mapping (or the already inflated volume entry) instead of
+    // copying the whole file into a private buffer first; it is released once all meshes are built
+    inmemfile = (const chunk32 *)Inputfile.Map();
     if (!inmemfile)
     {
-        fprintf(stderr, "Buffer allocation failed, Aborting\n");
+        fprintf(stderr, "Mapping of %s failed, Aborting\n", Inputfile.GetFilename().c_str());
         exit(-2);
     }
-    Inputfile.Read(inmemfile, Inputlength);
-    Inputfile.Close();
 #endif
     // Extract superheader fields
     word32index += 3;
@@ -998,7 +999,11 @@ vector<Mesh *> Mesh::LoadMeshes(VSFileSystem::VSFile &Inputfile, const Vector &s
             output.back()->orig[i + 1].lodsize = meshes.back().sizes[i];
         output.back()->numlods = output.back()->orig->numlods = meshes.back().num;
     }
-    free(inmemfile);
+#ifdef STANDALONE
+    free(inmembuffer);
+#else
+    Inputfile.Close();
+#endif
     inmemfile = nullptr;
 #ifndef STANDALONE
     return output;
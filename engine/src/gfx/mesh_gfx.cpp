@@ -23,6 +23,7 @@
 #include "lin_time.h"
 #include "mesh.h"
 #include "mesh_xml.h"
+#include "texture_loader.h"
 #include "vs_globals.h"
 #include <algorithm>
 #if defined(CG_SUPPORT)
@@ -282,6 +283,7 @@ Texture *Mesh::TempGetTexture(MeshXML *xml, std::string filename, std::string fa
             return ret;
         }
     }
+    TextureLoader::Scope async_textures;
     ret = new Texture(facplus.c_str(), 1, fil, TEXTURE2D, TEXTURE_2D, GFXFALSE, 65536, detail);
     if (!ret->LoadSuccess())
     {
@@ -346,6 +348,7 @@ Texture *Mesh::TempGetTexture(MeshXML *xml, int index, std::string factionname)
     }
     else
     {
+        TextureLoader::Scope async_textures;
         if (zt->alpha_name.length() == 0)
         {
             string temptex = faction_prefix + zt->decal_name;
@@ -358,7 +358,7 @@ bool CriteriaContains::isDestination(unsigned system) const
     // Not only for realism
     // but the systems may have not been created yet.
     string key(string("visited_") + name);
-    vector<float> *v = &_Universe->AccessCockpit()->savegame->getMissionData(key);
+    const vector<float> *v = &_Universe->AccessCockpit()->savegame->readMissionData(key);
     if (v->empty())
         return false;
     if ((*v)[0] != 1.0)
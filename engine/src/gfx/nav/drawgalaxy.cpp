@@ -36,6 +36,7 @@
 #include <algorithm>
 #include <assert.h> //needed for assert() calls
 #include <cmath>
+#include <limits.h>
 
 using std::string;
 using std::vector;
@@ -88,7 +89,7 @@ static void DrawNodeDescription(string text, float x_, float y_, float size_x, f
 static char GetSystemColor(string source)
 {
     // FIXME: update me!!!
-    vector<float> *v = &_Universe->AccessCockpit()->savegame->getMissionData("visited_" + source);
+    const vector<float> *v = &_Universe->AccessCockpit()->savegame->readMissionData("visited_" + source);
     if (v->size())
     {
         float k = (*v)[0];
@@ -267,7 +268,7 @@ bool checkedVisited(const std::string &n)
     else
     {
         string key(string("visited_") + n);
-        vector<float> *v = &_Universe->AccessCockpit()->savegame->getMissionData(key);
+        const vector<float> *v = &_Universe->AccessCockpit()->savegame->readMissionData(key);
         if (v->size() > 0)
             return true;
         return false;
@@ -349,11 +350,21 @@ NavigationSystem::CachedSystemIterator::SystemInfo::SystemInfo(const string &nam
 {
 }
 
-void NavigationSystem::CachedSystemIterator::SystemInfo::loadData(map<string, unsigned> *index_table)
+void NavigationSystem::CachedSystemIterator::SystemInfo::loadData(const GalaxyGraph &graph, GalaxyGraph::SystemId id,
+                                                                  const vector<unsigned> &index_table)
 {
-    string xyz = _Universe->getGalaxyProperty(name, "xyz");
     QVector pos;
-    if (xyz.size() && (sscanf(xyz.c_str(), "%lf %lf %lf", &pos.i, &pos.j, &pos.k) >= 3))
+    bool haspos;
+    if (id != GalaxyGraph::NoSystem)
+    {
+        haspos = graph.getPosition(id, pos);
+    }
+    else
+    {
+        string xyz = _Universe->getGalaxyProperty(name, "xyz");
+        haspos = xyz.size() && (sscanf(xyz.c_str(), "%lf %lf %lf", &pos.i, &pos.j, &pos.k) >= 3);
+    }
+    if (haspos)
     {
         pos.j = -pos.j;
     }
@@ -366,41 +377,46 @@ void NavigationSystem::CachedSystemIterator::SystemInfo::loadData(map<string, un
     position = pos;
 
     UpdateColor();
-    const vector<std::string> &destinations = _Universe->getAdjacentStarSystems(name);
-    for (size_t i = 0; i < destinations.size(); ++i)
-        if (index_table->count(destinations[i]) != 0)
-            lowerdestinations.push_back((*index_table)[destinations[i]]);
+    if (id == GalaxyGraph::NoSystem)
+        return;
+    for (const GalaxyGraph::SystemId *adj = graph.beginAdjacent(id); adj != graph.endAdjacent(id); ++adj)
+        if (index_table[*adj] != UINT_MAX)
+            lowerdestinations.push_back(index_table[*adj]);
 }
 
 void NavigationSystem::CachedSystemIterator::init(string current_system, unsigned max_systems)
 {
     systems.clear();
     unsigned count = 0;
-    string sys;
 
-    map<string, unsigned> index_table;
-    std::deque<std::string> frontier;
-    frontier.push_back(current_system);
+    // Walk the compiled jump graph; index_table maps graph ids to positions in systems
+    const GalaxyGraph &graph = _Universe->getGalaxyGraph();
+    GalaxyGraph::SystemId start = graph.find(current_system);
     systems.push_back(SystemInfo(current_system));
-    index_table[current_system] = 0;
-    while (!frontier.empty())
+    if (start == GalaxyGraph::NoSystem)
     {
-        sys = frontier.front();
-        frontier.pop_front();
-
-        int nas = UniverseUtil::GetNumAdjacentSystems(sys);
-        for (int j = 0; j < nas && count < max_systems; ++j)
+        systems[0].loadData(graph, start, vector<unsigned>());
+        return;
+    }
+    vector<unsigned> index_table(graph.size(), UINT_MAX);
+    vector<GalaxyGraph::SystemId> frontier;
+    frontier.push_back(start);
+    index_table[start] = 0;
+    for (size_t head = 0; head < frontier.size(); ++head)
+    {
+        GalaxyGraph::SystemId sys = frontier[head];
+        for (const GalaxyGraph::SystemId *adj = graph.beginAdjacent(sys);
+             adj != graph.endAdjacent(sys) && count < max_systems; ++adj)
         {
-            string n = UniverseUtil::GetAdjacentSystem(sys, j);
-            if (index_table.count(n) == 0)
+            if (index_table[*adj] == UINT_MAX)
             {
-                frontier.push_back(n);
-                index_table[n] = systems.size();
-                systems.push_back(SystemInfo(n));
+                frontier.push_back(*adj);
+                index_table[*adj] = systems.size();
+                systems.push_back(SystemInfo(graph.name(*adj)));
                 ++count;
             }
         }
-        systems[index_table[sys]].loadData(&index_table);
+        systems[index_table[sys]].loadData(graph, sys, index_table);
     }
 }
 
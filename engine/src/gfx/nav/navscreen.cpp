@@ -522,7 +522,7 @@ void NavigationSystem::DrawMission()
     float deltay = screenskipby4[3] - screenskipby4[2];
     float originx = screenskipby4[0]; // left
     float originy = screenskipby4[3]; // top
-    vector<float> *killlist = &_Universe->AccessCockpit()->savegame->getMissionData(string("kills"));
+    const vector<float> *killlist = &_Universe->AccessCockpit()->savegame->readMissionData(string("kills"));
     string relationskills = "Relations";
     if (killlist->size() > 0)
         relationskills += " | Kills";
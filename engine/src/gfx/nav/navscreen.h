@@ -2,6 +2,7 @@
 #define _NAVSCREEN_H_
 
 #include "drawlist.h"
+#include "galaxy_graph.h"
 #include "gfx/hud.h"
 #include "gfx/masks.h"
 #include "gnuhash.h"
@@ -61,7 +62,7 @@ class NavigationSystem
             SystemInfo(const string &name);
             SystemInfo(const string &name, const QVector &position, const std::vector<std::string> &destinations,
                        CachedSystemIterator *csi);
-            void loadData(std::map<string, unsigned> *index_table);
+            void loadData(const GalaxyGraph &graph, GalaxyGraph::SystemId id, const std::vector<unsigned> &index_table);
         };
 
       private:
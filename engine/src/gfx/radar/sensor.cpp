@@ -1,6 +1,7 @@
 // -*- mode: c++; c-basic-offset: 4; indent-tabs-mode: nil -*-
 
 #include "sensor.h"
+#include "cmd/contact_snapshot.h"
 #include "cmd/planet_generic.h"
 #include "cmd/unit_find.h"
 #include "cmd/unit_generic.h"
@@ -188,8 +189,7 @@ const Sensor::TrackCollection &Sensor::FindTracksInRange() const
     unitLocator.action.init(this, &collection, player);
     if (!is_null(player->location[Unit::UNIT_ONLY]))
     {
-        findObjects(_Universe->activeStarSystem()->collidemap[Unit::UNIT_ONLY], player->location[Unit::UNIT_ONLY],
-                    &unitLocator);
+        ContactSnapshot::Find(_Universe->activeStarSystem()->collidemap[Unit::UNIT_ONLY], player, &unitLocator);
     }
     if (allGravUnits)
     {
@@ -0,0 +1,319 @@
+#include "texture_loader.h"
+#include "aux_texture.h"
+#include "configxml.h"
+#include "gldrv/sdds.h"
+#include "vs_globals.h"
+#include "vsfilesystem.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace VSFileSystem;
+
+struct TextureLoader::Job
+{
+    Texture *tex;   // texture doing the load, null once cancelled (and for standalone decodes)
+    Texture *entry; // shared texture other instances reference
+    VSFile *file;
+    VSFile *alphafile;
+    int maxdimension;
+    GFXBOOL detailtexture;
+    float priority;
+    VSImage image;
+    unsigned char *data;
+    bool standalone; // from QueueDecode: never uploaded by Update()
+    bool finished;   // standalone decode done, waiting for TakeDecoded
+    bool dropped;    // standalone decode cancelled while a worker had it
+};
+
+namespace
+{
+typedef TextureLoader::Job TextureJob;
+
+std::mutex job_mutex;
+std::condition_variable job_ready;
+std::deque<TextureJob *> queued;        // waiting for a worker
+std::vector<TextureJob *> in_progress;  // being decoded
+std::vector<TextureJob *> decoded;      // waiting for the upload
+int scope_depth = 0;
+
+bool enabled()
+{
+    static bool async = XMLSupport::parse_bool(vs_config->getVariable("graphics", "async_texture_loading", "false"));
+    return async;
+}
+
+size_t uploadBytes(const VSImage &image)
+{
+    size_t pixels = image.sizeX * image.sizeY;
+    switch (image.mode)
+    {
+    case VSImage::_DXT1:
+    case VSImage::_DXT1RGBA:
+        return pixels / 2;
+    case VSImage::_DXT3:
+    case VSImage::_DXT5:
+    case VSImage::_8BIT:
+        return pixels;
+    case VSImage::_24BIT:
+        return pixels * 3;
+    default:
+        return pixels * 4;
+    }
+}
+
+void releaseJob(TextureJob *job)
+{
+    if (job->data)
+        free(job->data);
+    if (job->image.palette)
+        free(job->image.palette);
+    delete job->file;
+    delete job->alphafile;
+    delete job;
+}
+
+void workerLoop()
+{
+    ddsDecodeInline();
+    std::unique_lock<std::mutex> lock(job_mutex);
+    for (;;)
+    {
+        job_ready.wait(lock, [] { return !queued.empty(); });
+        TextureJob *job = queued.front();
+        queued.pop_front();
+        in_progress.push_back(job);
+        lock.unlock();
+
+        // The image is decoded into the job's own VSImage, so nothing the GL thread uses is touched here
+        job->data = job->image.ReadImage(job->file, nullptr, true, job->alphafile);
+
+        lock.lock();
+        in_progress.erase(std::find(in_progress.begin(), in_progress.end(), job));
+        if (!job->standalone)
+            decoded.push_back(job);
+        else if (job->dropped)
+            releaseJob(job);
+        else
+            job->finished = true;
+    }
+}
+
+void startWorkers()
+{
+    static bool started = false;
+    if (started)
+        return;
+    started = true;
+    static int numthreads = XMLSupport::parse_int(vs_config->getVariable("graphics", "texture_loader_threads", "2"));
+    for (int i = 0; i < std::max(numthreads, 1); ++i)
+        std::thread(workerLoop).detach();
+}
+
+bool byPriority(const TextureJob *a, const TextureJob *b)
+{
+    return a->priority > b->priority;
+}
+
+TextureJob *newJob(VSFile *f, VSFile *f2)
+{
+    // Volume entries are extracted through the shared volume table, which is not thread safe:
+    // have it done now, so that workers only ever read from memory or their own FILE
+    f->Size();
+    if (f2)
+        f2->Size();
+    TextureJob *job = new TextureJob;
+    job->tex = nullptr;
+    job->entry = nullptr;
+    job->file = f;
+    job->alphafile = f2;
+    job->maxdimension = 65536;
+    job->detailtexture = GFXFALSE;
+    job->priority = 0;
+    job->image.palette = nullptr;
+    job->data = nullptr;
+    job->standalone = false;
+    job->finished = false;
+    job->dropped = false;
+    return job;
+}
+
+void queueJob(TextureJob *job)
+{
+    startWorkers();
+    {
+        std::lock_guard<std::mutex> lock(job_mutex);
+        queued.push_back(job);
+    }
+    job_ready.notify_one();
+}
+} // namespace
+
+TextureLoader::Scope::Scope()
+{
+    ++scope_depth;
+}
+
+TextureLoader::Scope::~Scope()
+{
+    --scope_depth;
+}
+
+bool TextureLoader::Active()
+{
+    return scope_depth > 0 && enabled();
+}
+
+void TextureLoader::Queue(Texture *tex, VSFile *f, VSFile *f2, int maxdimension, GFXBOOL detailtexture)
+{
+    TextureJob *job = newJob(f, f2);
+    job->tex = tex;
+    job->entry = tex->Original();
+    job->maxdimension = maxdimension;
+    job->detailtexture = detailtexture;
+    queueJob(job);
+}
+
+TextureLoader::Job *TextureLoader::QueueDecode(VSFile *f, VSFile *f2)
+{
+    TextureJob *job = newJob(f, f2);
+    job->standalone = true;
+    queueJob(job);
+    return job;
+}
+
+bool TextureLoader::TakeDecoded(Job *job, VSImage &image, unsigned char *&data)
+{
+    {
+        std::lock_guard<std::mutex> lock(job_mutex);
+        if (!job->finished)
+            return false;
+    }
+    image = job->image;
+    data = job->data;
+    job->data = nullptr;
+    job->image.palette = nullptr;
+    releaseJob(job);
+    return true;
+}
+
+void TextureLoader::CancelDecode(Job *job)
+{
+    {
+        std::lock_guard<std::mutex> lock(job_mutex);
+        std::deque<TextureJob *>::iterator it = std::find(queued.begin(), queued.end(), job);
+        if (it != queued.end())
+        {
+            queued.erase(it);
+        }
+        else if (!job->finished)
+        {
+            // The worker releases it when done
+            job->dropped = true;
+            return;
+        }
+    }
+    releaseJob(job);
+}
+
+// Hands the load of from over to to, in whatever state it is; job_mutex must be held
+static bool retarget(Texture *from, Texture *to)
+{
+    for (size_t i = 0; i < queued.size(); ++i)
+    {
+        if (queued[i]->tex == from)
+        {
+            queued[i]->tex = to;
+            return true;
+        }
+    }
+    for (size_t i = 0; i < in_progress.size(); ++i)
+    {
+        if (in_progress[i]->tex == from)
+        {
+            in_progress[i]->tex = to;
+            return true;
+        }
+    }
+    for (size_t i = 0; i < decoded.size(); ++i)
+    {
+        if (decoded[i]->tex == from)
+        {
+            decoded[i]->tex = to;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TextureLoader::Cancel(Texture *tex)
+{
+    std::lock_guard<std::mutex> lock(job_mutex);
+    for (std::deque<TextureJob *>::iterator it = queued.begin(); it != queued.end(); ++it)
+    {
+        if ((*it)->tex == tex)
+        {
+            releaseJob(*it);
+            queued.erase(it);
+            return true;
+        }
+    }
+    // Decodes already running cannot be interrupted; Update() discards them
+    return retarget(tex, nullptr);
+}
+
+bool TextureLoader::Handover(Texture *from, Texture *to)
+{
+    std::lock_guard<std::mutex> lock(job_mutex);
+    return retarget(from, to);
+}
+
+void TextureLoader::Prioritize(const Texture *tex, float priority)
+{
+    const Texture *entry = tex->Original();
+    std::lock_guard<std::mutex> lock(job_mutex);
+    for (size_t i = 0; i < queued.size(); ++i)
+        if (queued[i]->tex == tex || queued[i]->entry == entry)
+            queued[i]->priority = priority;
+    for (size_t i = 0; i < decoded.size(); ++i)
+        if (decoded[i]->tex == tex || decoded[i]->entry == entry)
+            decoded[i]->priority = priority;
+}
+
+void TextureLoader::Update()
+{
+    static size_t budget =
+        XMLSupport::parse_int(vs_config->getVariable("graphics", "texture_upload_budget_kb", "4096")) * 1024;
+    std::vector<TextureJob *> ready;
+    {
+        std::lock_guard<std::mutex> lock(job_mutex);
+        if (decoded.empty())
+            return;
+        ready.swap(decoded);
+    }
+    std::stable_sort(ready.begin(), ready.end(), byPriority);
+    size_t uploaded = 0;
+    size_t i = 0;
+    for (; i < ready.size() && (uploaded < budget || i == 0); ++i)
+    {
+        TextureJob *job = ready[i];
+        if (job->tex)
+        {
+            uploaded += uploadBytes(job->image);
+            job->tex->FinishLoad(job->image, job->data, job->maxdimension, job->detailtexture);
+            // FinishLoad took over the data and palette
+            job->data = nullptr;
+            job->image.palette = nullptr;
+        }
+        releaseJob(job);
+    }
+    if (i < ready.size())
+    {
+        std::lock_guard<std::mutex> lock(job_mutex);
+        decoded.insert(decoded.begin(), ready.begin() + i, ready.end());
+    }
+}
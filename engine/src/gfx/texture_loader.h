@@ -0,0 +1,64 @@
+#ifndef _TEXTURE_LOADER_H_
+#define _TEXTURE_LOADER_H_
+
+#include "gldrv/gfxlib_struct.h"
+
+class Texture;
+class VSImage;
+namespace VSFileSystem
+{
+class VSFile;
+}
+
+/**
+ * Background texture loading.
+ * Image files are decoded by a small pool of worker threads; the GL thread picks the
+ * results up once a frame in Update() and uploads them, highest priority first, until
+ * the per-frame upload budget is spent.
+ * While its load is pending a texture has no GFX name and renders as the white
+ * placeholder, see Texture::MakeActive().
+ * Only loads issued inside a Scope are eligible, so that code relying on textures
+ * being resident right after construction keeps working.
+ *
+ * QueueDecode() runs a decode on the same workers without any Texture behind it; the
+ * caller polls it with TakeDecoded() and uploads the image itself.
+ */
+class TextureLoader
+{
+  public:
+    struct Job;
+
+    /// Makes Texture::Load() queue eligible loads while in scope (if enabled in the config)
+    class Scope
+    {
+      public:
+        Scope();
+        ~Scope();
+    };
+
+    /// Whether loads issued right now may be queued
+    static bool Active();
+    /// Queues the decode of f (and alpha file f2, may be null) for tex; takes ownership of both files
+    static void Queue(Texture *tex, VSFileSystem::VSFile *f, VSFileSystem::VSFile *f2, int maxdimension,
+                      GFXBOOL detailtexture);
+    /// Drops the pending load of tex, returns false if tex was not loading anything
+    static bool Cancel(Texture *tex);
+    /// Has to finish the pending load of from, returns false if from was not loading anything
+    static bool Handover(Texture *from, Texture *to);
+    /// Changes the upload order of a pending texture
+    static void Prioritize(const Texture *tex, float priority);
+    /// Queues the decode of f (and alpha file f2, may be null) for the caller; takes ownership of both files
+    static Job *QueueDecode(VSFileSystem::VSFile *f, VSFileSystem::VSFile *f2);
+    /**
+     * Once job is decoded, hands the result over and releases job.
+     * data and image.palette then belong to the caller; data is null when the decode failed.
+     * Returns false, leaving job alone, while it is still queued or decoding.
+     */
+    static bool TakeDecoded(Job *job, VSImage &image, unsigned char *&data);
+    /// Releases job whatever its state
+    static void CancelDecode(Job *job);
+    /// Uploads decoded textures within the frame budget. Must be called from the GL thread.
+    static void Update();
+};
+
+#endif
@@ -17,6 +17,7 @@
 #include "gfx/animation.h"
 #include "gfx/vsimage.h"
 #include "hud.h"
+#include "lin_time.h"
 #include "universe_util.h"
 #include "vs_globals.h"
 #include "vsfilesystem.h"
@@ -164,12 +165,23 @@ VDU::VDU(const char *file, TextPlane *textp, unsigned short modes, short rwws, s
     StartArmor = ma;
     maxhull = mh;
     got_target_info = true;
+    viewTexture = -1;
+    viewWidth = viewHeight = 0;
+    viewRefreshed = 0;
+    viewRefreshedStyle = CP_TARGET;
+    viewRefreshedTarget = nullptr;
     SwitchMode(nullptr);
 
     // printf("\nVDU rows=%d,col=%d\n",rows,cols);
     // cout << "vdu" << endl;
 }
 
+VDU::~VDU()
+{
+    if (viewTexture >= 0)
+        GFXDeleteTexture(viewTexture);
+}
+
 GFXColor getDamageColor(float armor, bool gradient = false)
 {
     static GFXColor damaged = vs_config->getColor("default", "hud_target_damaged", GFXColor(1, 0, 0, 1));
@@ -1708,27 +1720,83 @@ void VDU::SetViewingStyle(VIEWSTYLE vs)
 
 void VDU::DrawStarSystemAgain(float x, float y, float w, float h, VIEWSTYLE viewStyle, Unit *parent, Unit *target)
 {
-    GFXEnable(DEPTHTEST);
-    GFXEnable(DEPTHWRITE);
-    VIEWSTYLE which = viewStyle;
-    float tmpaspect = g_game.aspect;
-    g_game.aspect = w / h;
-    _Universe->AccessCamera(which)->SetSubwindow(x, y, w, h);
-    _Universe->SelectCamera(which);
-    VIEWSTYLE tmp = _Universe->AccessCockpit()->GetView();
-    _Universe->AccessCockpit()->SetView(viewStyle);
-    _Universe->AccessCockpit()->SelectProperCamera();
-    _Universe->AccessCockpit()->SetupViewPort(true); /// this is the final, smoothly calculated cam
-    GFXClear(GFXFALSE);
-    GFXColor4f(1, 1, 1, 1);
-    _Universe->activeStarSystem()->Draw(false);
-    g_game.aspect = tmpaspect;
-    _Universe->AccessCamera(which)->SetSubwindow(0, 0, 1, 1);
-    _Universe->AccessCockpit()->SetView(tmp);
-    _Universe->AccessCockpit()->SelectProperCamera();
-    _Universe->AccessCockpit()->SetupViewPort(true); /// this is the final, smoothly calculated cam
+    // Drawing the system again costs about as much as the main view. Unless vdu_view_fps is 0, the camera
+    // is refreshed only that often, at vdu_view_resolution of the VDU size and vdu_view_detail of the usual
+    // level of detail, and the image is kept in a texture and stretched over the VDU in between.
+    static float view_fps = XMLSupport::parse_float(vs_config->getVariable("graphics", "hud", "vdu_view_fps", "15"));
+    static float view_resolution =
+        XMLSupport::parse_float(vs_config->getVariable("graphics", "hud", "vdu_view_resolution", ".5"));
+    static float view_detail =
+        XMLSupport::parse_float(vs_config->getVariable("graphics", "hud", "vdu_view_detail", ".5"));
+    bool cached = view_fps > 0;
+    int width = int(w * g_game.x_resolution);
+    int height = int(h * g_game.y_resolution);
+    if (cached)
+    {
+        float scale = mymin(mymax(view_resolution, 0.05f), 1.0f);
+        width = mymax(int(width * scale), 1);
+        height = mymax(int(height * scale), 1);
+    }
+    double now = realTime();
+    bool refresh = !cached || viewTexture < 0 || width != viewWidth || height != viewHeight ||
+                   viewStyle != viewRefreshedStyle || target != viewRefreshedTarget ||
+                   now - viewRefreshed >= 1 / view_fps;
+    if (refresh)
+    {
+        GFXEnable(DEPTHTEST);
+        GFXEnable(DEPTHWRITE);
+        VIEWSTYLE which = viewStyle;
+        float tmpaspect = g_game.aspect;
+        float tmpdetail = g_game.detaillevel;
+        g_game.aspect = w / h;
+        if (cached)
+            g_game.detaillevel *= view_detail;
+        _Universe->AccessCamera(which)->SetSubwindow(x, y, float(width) / g_game.x_resolution,
+                                                     float(height) / g_game.y_resolution);
+        _Universe->SelectCamera(which);
+        VIEWSTYLE tmp = _Universe->AccessCockpit()->GetView();
+        _Universe->AccessCockpit()->SetView(viewStyle);
+        _Universe->AccessCockpit()->SelectProperCamera();
+        _Universe->AccessCockpit()->SetupViewPort(true); /// this is the final, smoothly calculated cam
+        GFXClear(GFXFALSE);
+        GFXColor4f(1, 1, 1, 1);
+        _Universe->activeStarSystem()->Draw(false);
+        if (cached)
+        {
+            if (viewTexture < 0)
+                GFXCreateTexture(width, height, RGB24, &viewTexture, nullptr, 0, BILINEAR, TEXTURE2D, CLAMP);
+            GFXCopyScreenToTexture(viewTexture, int(x * g_game.x_resolution), int(y * g_game.y_resolution), width,
+                                   height);
+            viewWidth = width;
+            viewHeight = height;
+            viewRefreshed = now;
+            viewRefreshedStyle = viewStyle;
+            viewRefreshedTarget = target;
+        }
+        g_game.aspect = tmpaspect;
+        g_game.detaillevel = tmpdetail;
+        _Universe->AccessCamera(which)->SetSubwindow(0, 0, 1, 1);
+        _Universe->AccessCockpit()->SetView(tmp);
+        _Universe->AccessCockpit()->SelectProperCamera();
+        _Universe->AccessCockpit()->SetupViewPort(true); /// this is the final, smoothly calculated cam
+    }
     GFXRestoreHudMode();
     GFXBlendMode(ONE, ZERO);
+    if (cached)
+    {
+        // HUD mode draws in normalized device coordinates
+        float left = 2 * x - 1, bottom = 2 * y - 1, right = left + 2 * w, top = bottom + 2 * h;
+        const float verts[4 * (3 + 2)] = {
+            left, bottom, 0, 0, 0, right, bottom, 0, 1, 0, right, top, 0, 1, 1, left, top, 0, 0, 1,
+        };
+        GFXDisable(DEPTHTEST);
+        GFXDisable(LIGHTING);
+        GFXEnable(TEXTURE0);
+        GFXSelectTexture(viewTexture, 0);
+        GFXTextureEnv(0, GFXREPLACETEXTURE);
+        GFXDraw(GFXQUAD, verts, 4, 3, 0, 2);
+        GFXTextureEnv(0, GFXMODULATETEXTURE);
+    }
     GFXDisable(TEXTURE1);
     GFXDisable(TEXTURE0);
     GFXDisable(DEPTHTEST);
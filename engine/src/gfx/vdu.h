@@ -66,6 +66,12 @@ class VDU : public VSSprite
     void DrawTargetSpr(VSSprite *s, float percent, float &x, float &y, float &w, float &h);
     /// draws the target camera
     void DrawStarSystemAgain(float x, float y, float w, float h, VIEWSTYLE viewStyle, Unit *parent, Unit *target);
+    /// The last target camera image, shown until the next refresh; -1 until one is taken
+    int viewTexture;
+    int viewWidth, viewHeight;
+    double viewRefreshed;
+    VIEWSTYLE viewRefreshedStyle;
+    const Unit *viewRefreshedTarget;
 
   public:
     void ReceivedTargetData()
@@ -98,6 +104,7 @@ class VDU : public VSSprite
     };
     VDU(const char *file, TextPlane *textp, unsigned short modes, short rows, short cols, float *MaxArmor,
         float *maxhull);
+    ~VDU();
     /// Draws the entire VDU, all data, etc
     void Draw(GameCockpit *parentcp, Unit *parent, const GFXColor &c);
     /// Changes the mode of the current VDU to another legal mode
@@ -267,6 +267,9 @@ GFXBOOL /*GFXDRVAPI*/ GFXTransferTexture(
 GFXBOOL /*GFXDRVAPI*/ GFXTransferSubTexture(unsigned char *buffer, int handle, int x, int y, unsigned int width,
                                             unsigned int height, enum TEXTURE_IMAGE_TARGET image2D = TEXTURE_2D);
 
+/// Replaces the texture with a width x height copy of the framebuffer at x,y (in pixels)
+GFXBOOL /*GFXDRVAPI*/ GFXCopyScreenToTexture(int handle, int x, int y, int width, int height);
+
 /// Deletes the texture from the graphics card
 void /*GFXDRVAPI*/ GFXDeleteTexture(int handle);
 
@@ -291,6 +291,12 @@ extern PFNGLUNIFORM4IVPROC glUniform4iv_p;
 extern PFNGLDELETESHADERPROC glDeleteShader_p;
 extern PFNGLDELETEPROGRAMPROC glDeleteProgram_p;
 
+#ifdef GL_PROGRAM_BINARY_LENGTH
+extern PFNGLGETPROGRAMBINARYPROC glGetProgramBinary_p;
+extern PFNGLPROGRAMBINARYPROC glProgramBinary_p;
+extern PFNGLPROGRAMPARAMETERIPROC glProgramParameteri_p;
+#endif
+
 #endif /* __APPLE_PANTHER_GCC33_CLI__ */
 
 // extern int sharedcolortable;
@@ -142,6 +142,12 @@ PFNGLUNIFORM4IVPROC glUniform4iv_p = 0;
 PFNGLDELETESHADERPROC glDeleteShader_p = 0;
 PFNGLDELETEPROGRAMPROC glDeleteProgram_p = 0;
 
+#ifdef GL_PROGRAM_BINARY_LENGTH
+PFNGLGETPROGRAMBINARYPROC glGetProgramBinary_p = 0;
+PFNGLPROGRAMBINARYPROC glProgramBinary_p = 0;
+PFNGLPROGRAMPARAMETERIPROC glProgramParameteri_p = 0;
+#endif
+
 #endif /* __APPLE_PANTHER_GCC33_CLI__ */
 
 typedef void (*(*get_gl_proc_fptr_t)(const GLubyte *))();
@@ -386,6 +392,15 @@ void init_opengl_extensions()
         glDeleteShader_p = (PFNGLDELETESHADERPROC)GET_GL_PROC((GET_GL_PTR_TYP) "glDeleteShader");
     if (!glDeleteProgram_p)
         glDeleteProgram_p = (PFNGLDELETEPROGRAMPROC)GET_GL_PROC((GET_GL_PTR_TYP) "glDeleteProgram");
+#ifdef GL_PROGRAM_BINARY_LENGTH
+    // Core in 4.1, otherwise GL_ARB_get_program_binary; the shader binary cache needs all three
+    if (!glGetProgramBinary_p)
+        glGetProgramBinary_p = (PFNGLGETPROGRAMBINARYPROC)GET_GL_PROC((GET_GL_PTR_TYP) "glGetProgramBinary");
+    if (!glProgramBinary_p)
+        glProgramBinary_p = (PFNGLPROGRAMBINARYPROC)GET_GL_PROC((GET_GL_PTR_TYP) "glProgramBinary");
+    if (!glProgramParameteri_p)
+        glProgramParameteri_p = (PFNGLPROGRAMPARAMETERIPROC)GET_GL_PROC((GET_GL_PTR_TYP) "glProgramParameteri");
+#endif
         // fixme
 #endif
 
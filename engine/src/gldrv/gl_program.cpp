@@ -1,15 +1,22 @@
+#include <errno.h>
 #include <map>
 #include <set>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
 
 #include <boost/algorithm/string/predicate.hpp>
 
 #include "config_xml.h"
+#include "configxml.h"
 #include "gl_globals.h"
 #include "gldrv/gfxlib.h"
 #include "lin_time.h"
 #include "options.h"
 #include "vegastrike.h"
 #include "vs_globals.h"
+#include "vsfilesystem.h"
+#include "xml_support.h"
 
 using boost::algorithm::icontains;
 
@@ -17,6 +24,10 @@ using boost::algorithm::icontains;
 #define snprintf _snprintf
 #endif
 
+#if !defined(__APPLE__) && defined(GL_PROGRAM_BINARY_LENGTH)
+#define PROGRAM_BINARY_CACHE
+#endif
+
 typedef std::pair<unsigned int, std::pair<std::string, std::string>> ProgramCacheKey;
 typedef std::map<ProgramCacheKey, int> ProgramCache;
 typedef std::map<int, ProgramCacheKey> ProgramICache;
@@ -202,6 +213,195 @@ static std::string appendDefines(const std::string &prog, const char *extra_defi
         return std::string(extra_defines) + "\n#line 0\n" + prog;
 }
 
+#ifdef PROGRAM_BINARY_CACHE
+/*
+ * Linked programs are kept on disk in homedir/shadercache, so that the next launch can skip
+ * compiling and linking. A binary is only good for the driver that produced it and for the exact
+ * source it came from (includes and extra defines expanded), so the driver identity and a hash of
+ * the source are stored with it and checked on load. A binary that does not match, is damaged,
+ * or that the driver refuses is simply rebuilt from source and written again.
+ * Disabled with graphics/shader_binary_cache, or when the driver offers no binary format.
+ */
+static const char programBinaryMagic[8] = {'V', 'S', 'P', 'R', 'O', 'G', 'B', '1'};
+
+static uint64_t hashBytes(const void *data, size_t len, uint64_t hash = 14695981039346656037ULL)
+{
+    // FNV-1a
+    const unsigned char *bytes = (const unsigned char *)data;
+    for (size_t i = 0; i < len; ++i)
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    return hash;
+}
+
+static bool programBinaryCacheEnabled()
+{
+    static bool enabled = false;
+    static bool initted = false;
+    if (!initted)
+    {
+        initted = true;
+        static bool configured =
+            XMLSupport::parse_bool(vs_config->getVariable("graphics", "shader_binary_cache", "true"));
+        if (configured && glGetProgramBinary_p && glProgramBinary_p && glProgramParameteri_p)
+        {
+            GLint formats = 0;
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+            enabled = formats > 0;
+        }
+        VSFileSystem::vs_fprintf(stderr, "Shader cache: %s\n", enabled ? "enabled" : "disabled");
+    }
+    return enabled;
+}
+
+static const std::string &driverIdentity()
+{
+    static std::string identity;
+    if (identity.empty())
+    {
+        const GLenum names[] = {GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION};
+        for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i)
+        {
+            const GLubyte *value = glGetString(names[i]);
+            if (value)
+                identity += (const char *)value;
+            identity += '\n';
+        }
+    }
+    return identity;
+}
+
+static std::string programBinaryPath(const char *vprogram, const char *fprogram, const char *extra_defines)
+{
+    // The name only has to tell programs apart, the header decides whether the contents are usable
+    std::string name = std::string(vprogram) + "." + fprogram;
+    for (std::string::iterator it = name.begin(); it != name.end(); ++it)
+        if (*it == '/' || *it == '\\' || *it == ':')
+            *it = '_';
+    char suffix[16];
+    snprintf(suffix, sizeof(suffix), ".%08x", cacheKey(vprogram, fprogram, extra_defines).first);
+    return VSFileSystem::homedir + "/shadercache/" + name + suffix + ".bin";
+}
+
+template <typename T> static bool readField(const std::vector<char> &contents, size_t &pos, T &value)
+{
+    if (contents.size() - pos < sizeof(T))
+        return false;
+    memcpy(&value, &contents[pos], sizeof(T));
+    pos += sizeof(T);
+    return true;
+}
+
+template <typename T> static void writeField(FILE *fp, const T &value)
+{
+    fwrite(&value, sizeof(T), 1, fp);
+}
+
+static GLuint loadProgramBinary(const std::string &path, uint64_t sourcehash)
+{
+    FILE *fp = fopen(path.c_str(), "rb");
+    if (!fp)
+    {
+        // Not cached yet is the normal case for a new shader or a cleared cache
+        if (errno == ENOENT)
+            VSFileSystem::vs_dprintf(1, "Shader cache: %s not cached\n", path.c_str());
+        else
+            VSFileSystem::vs_fprintf(stderr, "Shader cache: cannot read %s, rebuilding\n", path.c_str());
+        return 0;
+    }
+    std::vector<char> contents;
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (size > 0)
+    {
+        contents.resize(size);
+        if (fread(&contents[0], 1, size, fp) != (size_t)size)
+            contents.clear();
+    }
+    fclose(fp);
+
+    const std::string &identity = driverIdentity();
+    size_t pos = sizeof(programBinaryMagic);
+    uint32_t identitylen = 0, format = 0, length = 0;
+    uint64_t storedsource = 0, checksum = 0;
+    const char *problem = nullptr;
+    if (contents.size() < pos)
+        problem = "is truncated";
+    else if (memcmp(&contents[0], programBinaryMagic, pos) != 0)
+        problem = "is stale (older cache format)";
+    else if (!readField(contents, pos, identitylen) || contents.size() - pos < identitylen)
+        problem = "is truncated";
+    else if (identitylen != identity.size() || identity.compare(0, identitylen, &contents[pos], identitylen) != 0)
+        problem = "is stale (built by another driver)";
+    else if (!readField(contents, pos += identitylen, storedsource) || !readField(contents, pos, format) ||
+             !readField(contents, pos, length) || !readField(contents, pos, checksum))
+        problem = "is truncated";
+    else if (storedsource != sourcehash)
+        problem = "is stale (shader sources changed)";
+    else if (contents.size() - pos != length || length == 0 || hashBytes(&contents[pos], length) != checksum)
+        problem = "is corrupt";
+    if (problem)
+    {
+        VSFileSystem::vs_fprintf(stderr, "Shader cache: %s %s, rebuilding\n", path.c_str(), problem);
+        return 0;
+    }
+
+    GLuint sp = glCreateProgram_p();
+    glProgramBinary_p(sp, format, &contents[pos], length);
+    GLint successp = 0;
+    glGetProgramiv_p(sp, GL_LINK_STATUS, &successp);
+    if (successp == 0 || !validateLog(sp, false))
+    {
+        // Typically a driver update that kept the version string
+        VSFileSystem::vs_fprintf(stderr, "Shader cache: driver rejected %s, rebuilding\n", path.c_str());
+        glDeleteProgram_p(sp);
+        while (glGetError() != GL_NO_ERROR)
+            ;
+        return 0;
+    }
+    VSFileSystem::vs_dprintf(1, "Shader cache: loaded %s\n", path.c_str());
+    return sp;
+}
+
+static void saveProgramBinary(const std::string &path, uint64_t sourcehash, GLuint sp)
+{
+    GLint length = 0;
+    glGetProgramiv_p(sp, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+    std::vector<char> binary(length);
+    GLsizei written = 0;
+    GLenum format = 0;
+    glGetProgramBinary_p(sp, length, &written, &format, &binary[0]);
+    if (written <= 0)
+        return;
+
+    // Written aside and renamed into place, so that a reader never sees half a file
+    VSFileSystem::CreateDirectoryHome("shadercache");
+    std::string tmppath = path + ".tmp";
+    FILE *fp = fopen(tmppath.c_str(), "wb");
+    if (!fp)
+        return;
+    const std::string &identity = driverIdentity();
+    fwrite(programBinaryMagic, sizeof(programBinaryMagic), 1, fp);
+    writeField(fp, (uint32_t)identity.size());
+    fwrite(identity.data(), identity.size(), 1, fp);
+    writeField(fp, sourcehash);
+    writeField(fp, (uint32_t)format);
+    writeField(fp, (uint32_t)written);
+    writeField(fp, hashBytes(&binary[0], written));
+    bool ok = fwrite(&binary[0], written, 1, fp) == 1;
+    ok = (fclose(fp) == 0) && ok;
+    if (ok)
+    {
+        remove(path.c_str());
+        ok = rename(tmppath.c_str(), path.c_str()) == 0;
+    }
+    if (!ok)
+        remove(tmppath.c_str());
+}
+#endif
+
 static int GFXCreateProgramNoCache(const char *vprogram, const char *fprogram, const char *extra_defines)
 {
     if (vprogram[0] == '\0' && fprogram[0] == '\0')
@@ -241,6 +441,20 @@ static int GFXCreateProgramNoCache(const char *vprogram, const char *fprogram, c
         fragprg = appendDefines(fragprg, extra_defines);
     }
 
+#ifdef PROGRAM_BINARY_CACHE
+    std::string binarypath;
+    uint64_t sourcehash = 0;
+    if (programBinaryCacheEnabled())
+    {
+        binarypath = programBinaryPath(vprogram, fprogram, extra_defines);
+        sourcehash = hashBytes(vertexprg.c_str(), vertexprg.size() + 1);
+        sourcehash = hashBytes(fragprg.c_str(), fragprg.size() + 1, sourcehash);
+        GLuint cached = loadProgramBinary(binarypath, sourcehash);
+        if (cached)
+            return cached;
+    }
+#endif
+
     GLint vproghandle = 0;
     GLint fproghandle = 0;
     GLint sp = 0;
@@ -300,6 +514,10 @@ static int GFXCreateProgramNoCache(const char *vprogram, const char *fprogram, c
     sp = glCreateProgram_p();
     glAttachShader_p(sp, vproghandle);
     glAttachShader_p(sp, fproghandle);
+#ifdef PROGRAM_BINARY_CACHE
+    if (!binarypath.empty())
+        glProgramParameteri_p(sp, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
     glLinkProgram_p(sp);
 
     GLint successp = 0;
@@ -334,6 +552,10 @@ static int GFXCreateProgramNoCache(const char *vprogram, const char *fprogram, c
         printf("Error code %s\n", gluErrorString(errCode));
         sp = 0; // no proper vertex prog support
     }
+#ifdef PROGRAM_BINARY_CACHE
+    if (sp && !binarypath.empty())
+        saveProgramBinary(binarypath, sourcehash, sp);
+#endif
     return sp;
 }
 
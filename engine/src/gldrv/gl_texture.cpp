@@ -23,6 +23,7 @@
 #include "gl_globals.h"
 #include "gldrv/gfxlib.h"
 #include "gldrv/sdds.h"
+#include "profiler.h"
 #include "vegastrike.h"
 #include "vs_globals.h"
 
@@ -697,8 +698,12 @@ const char *GetImageTargetName(TEXTURE_IMAGE_TARGET imagetarget)
 GFXBOOL /*GFXDRVAPI*/ GFXTransferSubTexture(unsigned char *buffer, int handle, int x, int y, unsigned int width,
                                             unsigned int height, enum TEXTURE_IMAGE_TARGET imagetarget)
 {
+    if (handle < 0 || !textures[handle].alive)
+        return GFXFALSE;
     GLenum image2D = GetImageTarget(imagetarget);
-    glBindTexture(textures[handle].targets, textures[handle].name);
+    // Through the binding cache, which a bare glBindTexture would leave stale
+    GFXActiveTexture(textures[handle].texturestage);
+    GFXSelectTexture(handle, textures[handle].texturestage);
 
     // internalformat = GetTextureFormat (handle);
 
@@ -706,6 +711,26 @@ GFXBOOL /*GFXDRVAPI*/ GFXTransferSubTexture(unsigned char *buffer, int handle, i
     return GFXTRUE;
 }
 
+/*
+ * Where DDS chains decoded in software are kept between runs (graphics/decoded_texture_cache), or
+ * empty. Reading a chain back skips decoding it, but takes four to eight times the room of the DDS.
+ */
+static const std::string &decodedTextureCacheDir()
+{
+    static std::string dir;
+    static bool initted = false;
+    if (!initted)
+    {
+        initted = true;
+        if (XMLSupport::parse_bool(vs_config->getVariable("graphics", "decoded_texture_cache", "false")))
+        {
+            VSFileSystem::CreateDirectoryHome("texturecache");
+            dir = VSFileSystem::homedir + "/texturecache";
+        }
+    }
+    return dir;
+}
+
 GFXBOOL /*GFXDRVAPI*/ GFXTransferTexture(unsigned char *buffer, int handle, int inWidth, int inHeight,
                                          TEXTUREFORMAT internformat, enum TEXTURE_IMAGE_TARGET imagetarget,
                                          int maxdimension, GFXBOOL detail_texture, unsigned int pageIndex)
@@ -892,11 +917,18 @@ GFXBOOL /*GFXDRVAPI*/ GFXTransferTexture(unsigned char *buffer, int handle, int
 
     int height = textures[handle].height;
     int width = textures[handle].width;
+    // Number of levels already decoded in software, when there is a whole chain to upload
+    int decodedmips = 0;
     // If s3tc compression is disabled, our DDS files must be software decompressed
     if (internformat >= DXT1 && internformat <= DXT5 && !gl_options.s3tc)
     {
         unsigned char *tmpbuffer = buffer + offset1;
-        ddsDecompress(tmpbuffer, data, internformat, textures[handle].height, textures[handle].width);
+        // Decode the file's own mipmaps too when they are wanted, rather than rebuilding them from the first level
+        if (((textures[handle].mipmapped & (TRILINEAR | MIPMAP)) && gl_options.mipmap >= 2) || detail_texture)
+            decodedmips =
+                ddsDecompressMipsCached(decodedTextureCacheDir(), tmpbuffer, data, internformat, height, width, mips);
+        else
+            ddsDecompressMipsCached(decodedTextureCacheDir(), tmpbuffer, data, internformat, height, width, 1);
         buffer = data;
         internformat = RGBA32;
         textures[handle].textureformat = GL_RGBA;
@@ -954,6 +986,22 @@ GFXBOOL /*GFXDRVAPI*/ GFXTransferTexture(unsigned char *buffer, int handle, int
                 }
                 /* END HACK */
             }
+            else if (decodedmips > 1)
+            {
+                // Software decompressed DDS, upload the decoded chain
+                unsigned char *level = buffer;
+                for (int i = 0; i < decodedmips; ++i)
+                {
+                    glTexImage2D(image2D, i, internalformat, width, height, 0, textures[handle].textureformat,
+                                 GL_UNSIGNED_BYTE, level);
+                    level += width * height * 4;
+                    if (width != 1)
+                        width >>= 1;
+                    if (height != 1)
+                        height >>= 1;
+                }
+                glTexParameteri(textures[handle].targets, GL_TEXTURE_MAX_LEVEL, decodedmips - 1);
+            }
             else
             {
                 // We want mipmaps but we have uncompressed data
@@ -1039,6 +1087,18 @@ GFXBOOL /*GFXDRVAPI*/ GFXTransferTexture(unsigned char *buffer, int handle, int
     return GFXTRUE;
 }
 
+GFXBOOL /*GFXDRVAPI*/ GFXCopyScreenToTexture(int handle, int x, int y, int width, int height)
+{
+    if (handle < 0 || !textures[handle].alive || textures[handle].targets != GL_TEXTURE_2D)
+        return GFXFALSE;
+    GFXActiveTexture(textures[handle].texturestage);
+    GFXSelectTexture(handle, textures[handle].texturestage);
+    glCopyTexImage2D(GL_TEXTURE_2D, 0, textures[handle].textureformat, x, y, width, height, 0);
+    textures[handle].iwidth = textures[handle].width = width;
+    textures[handle].iheight = textures[handle].height = height;
+    return GFXTRUE;
+}
+
 void /*GFXDRVAPI*/ GFXDeleteTexture(int handle)
 {
     if (textures[handle].alive)
@@ -1139,7 +1199,10 @@ void /*GFXDRVAPI*/ GFXSelectTexture(int handle, int stage)
         GFXActiveTexture(stage);
         activetexture[stage] = handle;
         if (gl_options.Multitexture || (stage == 0))
+        {
             glBindTexture(textures[handle].targets, textures[handle].name);
+            PROFILE_COUNT(TextureBinds, 1);
+        }
     }
 }
 
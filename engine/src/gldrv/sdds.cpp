@@ -1,6 +1,15 @@
 #include "gldrv/sdds.h"
 #include "vs_globals.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <thread>
 
 #ifndef GETL16
 #define GETL16(buf) (((unsigned short)(buf)[0]) | ((unsigned short)(buf)[1] << 8))
@@ -15,16 +24,17 @@
 
 /*	Software decompression for DDS files, helper functions */
 
-void decode_color_block(unsigned char *RESTRICT dst, unsigned char *RESTRICT src, int w, int h, int rowbytes,
-                        TEXTUREFORMAT format)
+/*
+ *  Every block is first turned into a small table (4 RGBA colors, 8 alpha levels) and then each texel is a
+ *  single table lookup and 4 byte store, which keeps the inner loops free of branches. w and h are the part
+ *  of the block that lies inside the image (less than 4 on the right and bottom edges of odd sized levels).
+ */
+static void decode_color_block(unsigned char *RESTRICT dst, const unsigned char *RESTRICT src, int w, int h,
+                               int rowbytes, TEXTUREFORMAT format)
 {
-    int i, x, y;
-    unsigned int indexes, idx;
-    unsigned char *d;
-    unsigned char colors[4][3];
-    unsigned short c0, c1;
-    c0 = GETL16(&src[0]);
-    c1 = GETL16(&src[2]);
+    unsigned char colors[4][4];
+    unsigned short c0 = GETL16(&src[0]);
+    unsigned short c1 = GETL16(&src[2]);
     colors[0][0] = ((c0 >> 11) & 0x1f) << 3;
     colors[0][1] = ((c0 >> 5) & 0x3f) << 2;
     colors[0][2] = ((c0)&0x1f) << 3;
@@ -33,7 +43,7 @@ void decode_color_block(unsigned char *RESTRICT dst, unsigned char *RESTRICT src
     colors[1][2] = ((c1)&0x1f) << 3;
     if ((c0 > c1) || (format == DXT5))
     {
-        for (i = 0; i < 3; ++i)
+        for (int i = 0; i < 3; ++i)
         {
             colors[2][i] = (2 * colors[0][i] + colors[1][i] + 1) / 3;
             colors[3][i] = (2 * colors[1][i] + colors[0][i] + 1) / 3;
@@ -41,125 +51,344 @@ void decode_color_block(unsigned char *RESTRICT dst, unsigned char *RESTRICT src
     }
     else
     {
-        for (i = 0; i < 3; ++i)
+        for (int i = 0; i < 3; ++i)
         {
             colors[2][i] = (colors[0][i] + colors[1][i] + 1) >> 1;
             colors[3][i] = 255;
         }
     }
+    // Only DXT1 carries alpha in the color block; DXT3/5 alpha is written over it afterwards
+    bool punchthrough = (format == DXT1 || format == DXT1RGBA) && c0 <= c1;
+    colors[0][3] = colors[1][3] = colors[2][3] = 255;
+    colors[3][3] = punchthrough ? 0 : 255;
     src += 4;
-    if (format == DXT1 || format == DXT1RGBA)
+    for (int y = 0; y < h; ++y)
     {
-        for (y = 0; y < h; ++y)
-        {
-            d = dst + (y * rowbytes);
-            indexes = src[y];
-            for (x = 0; x < w; ++x)
-            {
-                idx = indexes & 0x03;
-                d[0] = colors[idx][0];
-                d[1] = colors[idx][1];
-                d[2] = colors[idx][2];
-                d[3] = ((c0 <= c1) && idx == 3) ? 0 : 255;
-                indexes >>= 2;
-                d += 4;
-            }
-        }
+        unsigned char *d = dst + (y * rowbytes);
+        unsigned int indexes = src[y];
+        for (int x = 0; x < w; ++x, d += 4, indexes >>= 2)
+            memcpy(d, colors[indexes & 0x03], 4);
+    }
+}
+
+static void decode_dxt3_alpha(unsigned char *RESTRICT dst, const unsigned char *RESTRICT src, int w, int h,
+                              int rowbytes)
+{
+    for (int y = 0; y < h; ++y)
+    {
+        unsigned char *d = dst + (y * rowbytes);
+        unsigned int bits = GETL16(&src[2 * y]);
+        for (int x = 0; x < w; ++x, d += 4, bits >>= 4)
+            d[0] = (bits & 0x0f) * 17;
+    }
+}
+
+static void decode_dxt5_alpha(unsigned char *RESTRICT dst, const unsigned char *RESTRICT src, int w, int h,
+                              int rowbytes)
+{
+    unsigned char alphas[8];
+    unsigned char a0 = src[0], a1 = src[1];
+    alphas[0] = a0;
+    alphas[1] = a1;
+    if (a0 > a1)
+    {
+        for (int code = 2; code < 8; ++code)
+            alphas[code] = ((8 - code) * a0 + (code - 1) * a1) / 7;
     }
     else
     {
-        for (y = 0; y < h; ++y)
-        {
-            d = dst + (y * rowbytes);
-            indexes = src[y];
-            for (x = 0; x < w; ++x)
-            {
-                idx = indexes & 0x03;
-                d[0] = colors[idx][0];
-                d[1] = colors[idx][1];
-                d[2] = colors[idx][2];
-                indexes >>= 2;
-                d += 4;
-            }
-        }
+        for (int code = 2; code < 6; ++code)
+            alphas[code] = ((6 - code) * a0 + (code - 1) * a1) / 5;
+        alphas[6] = 0;
+        alphas[7] = 255;
+    }
+    unsigned long long bits = GETL64(src) >> 16;
+    for (int y = 0; y < h; ++y)
+    {
+        // Each row takes 12 bits whatever the width of the block
+        unsigned int row = (unsigned int)(bits >> (12 * y));
+        unsigned char *d = dst + (y * rowbytes);
+        for (int x = 0; x < w; ++x, d += 4, row >>= 3)
+            d[0] = alphas[row & 0x07];
     }
 }
 
-void decode_dxt3_alpha(unsigned char *RESTRICT dst, unsigned char *RESTRICT src, int w, int h, int rowbytes)
+static inline int dds_block_bytes(TEXTUREFORMAT format)
+{
+    return (format == DXT1 || format == DXT1RGBA) ? 8 : 16;
+}
+
+static size_t dds_level_bytes(TEXTUREFORMAT format, int height, int width)
 {
-    int x, y;
-    unsigned char *d;
-    unsigned int bits;
-    for (y = 0; y < h; ++y)
+    return (size_t)((width + 3) / 4) * ((height + 3) / 4) * dds_block_bytes(format);
+}
+
+// Decodes the block rows [firstrow, lastrow) of one level
+static void decode_block_rows(const unsigned char *input, unsigned char *output, TEXTUREFORMAT format, int height,
+                              int width, int firstrow, int lastrow)
+{
+    const int bpp = 4;
+    const int rowbytes = width * bpp;
+    const int blocksperrow = (width + 3) / 4;
+    const unsigned char *pos_in = input + (size_t)firstrow * blocksperrow * dds_block_bytes(format);
+    for (int by = firstrow; by < lastrow; ++by)
     {
-        d = dst + (y * rowbytes);
-        bits = GETL16(&src[2 * y]);
-        bits = GETL16(&src[2 * y]);
-        for (x = 0; x < w; ++x)
+        int y = by * 4;
+        int sy = std::min(4, height - y);
+        for (int x = 0; x < width; x += 4)
         {
-            d[0] = (bits & 0x0f) * 17;
-            bits >>= 4;
-            d += 4;
+            int sx = std::min(4, width - x);
+            unsigned char *pos_out = output + ((size_t)y * width + x) * bpp;
+            const unsigned char *color = (format == DXT3 || format == DXT5) ? pos_in + 8 : pos_in;
+            decode_color_block(pos_out, color, sx, sy, rowbytes, format);
+            if (format == DXT3)
+                decode_dxt3_alpha(pos_out + 3, pos_in, sx, sy, rowbytes);
+            else if (format == DXT5)
+                decode_dxt5_alpha(pos_out + 3, pos_in, sx, sy, rowbytes);
+            pos_in += dds_block_bytes(format);
         }
     }
 }
 
-void decode_dxt5_alpha(unsigned char *RESTRICT dst, unsigned char *RESTRICT src, int w, int h, int bpp, int rowbytes)
+// Levels smaller than this are not worth waking the helpers for
+#define DDS_THREADED_MIN_PIXELS (256 * 256)
+
+/*
+ * Helpers for large levels decoded outside a decoder pool, started on first use and never
+ * stopped. A level is cut in chunks of block rows handed out through an atomic counter; the
+ * caller decodes chunks too and waits for every helper to be done with the level.
+ */
+namespace
 {
-    int x, y, code;
-    unsigned char *d, a0 = src[0], a1 = src[1];
-    unsigned long long bits = GETL64(src) >> 16;
-    for (y = 0; y < h; ++y)
+struct Level
+{
+    const unsigned char *input;
+    unsigned char *output;
+    TEXTUREFORMAT format;
+    int height, width, blockrows, rowsper;
+};
+
+thread_local bool decode_inline = false;
+std::once_flag helpers_started;
+int helpers = 0;
+std::mutex helpers_busy; // one level at a time; other callers decode inline meanwhile
+std::mutex level_mutex;
+std::condition_variable level_start;
+std::condition_variable level_done;
+Level level;
+std::atomic<int> level_next(0);
+unsigned int level_generation = 0;
+int level_running = 0; // helpers not done with the current level
+
+void decodeChunks(const Level &l)
+{
+    for (int chunk; (chunk = level_next++) * l.rowsper < l.blockrows;)
+        decode_block_rows(l.input, l.output, l.format, l.height, l.width, chunk * l.rowsper,
+                          std::min((chunk + 1) * l.rowsper, l.blockrows));
+}
+
+void helperLoop()
+{
+    std::unique_lock<std::mutex> lock(level_mutex);
+    // Helpers are all started before the first level, which they must not miss however late they get here
+    unsigned int seen = 0;
+    for (;;)
     {
-        d = dst + (y * rowbytes);
-        for (x = 0; x < w; ++x)
-        {
-            code = ((unsigned int)bits) & 0x07;
-            if (code < 2)
-                d[0] = src[code];
-            else if (a0 > a1)
-                d[0] = ((8 - code) * a0 + (code - 1) * a1) / 7;
-            else if (code >= 6)
-                d[0] = (code == 6) ? 0 : 255;
-            else
-                d[0] = ((6 - code) * a0 + (code - 1) * a1) / 5;
-            bits >>= 3;
-            d += bpp;
-        }
-        if (w < 4)
-            bits >>= (3 * (4 - w));
+        level_start.wait(lock, [&seen] { return level_generation != seen; });
+        seen = level_generation;
+        Level l = level;
+        lock.unlock();
+        decodeChunks(l);
+        lock.lock();
+        if (--level_running == 0)
+            level_done.notify_one();
     }
 }
 
+void startHelpers()
+{
+    helpers = std::min<int>(std::max<int>(std::thread::hardware_concurrency(), 1), 8) - 1;
+    for (int i = 0; i < helpers; ++i)
+        std::thread(helperLoop).detach();
+}
+} // namespace
+
+void ddsDecodeInline()
+{
+    decode_inline = true;
+}
+
+static void decode_level(const unsigned char *input, unsigned char *output, TEXTUREFORMAT format, int height, int width)
+{
+    int blockrows = (height + 3) / 4;
+    if (!decode_inline && width * height >= DDS_THREADED_MIN_PIXELS)
+        std::call_once(helpers_started, startHelpers);
+    if (decode_inline || width * height < DDS_THREADED_MIN_PIXELS || helpers == 0 || !helpers_busy.try_lock())
+    {
+        decode_block_rows(input, output, format, height, width, 0, blockrows);
+        return;
+    }
+    std::lock_guard<std::mutex> busy(helpers_busy, std::adopt_lock);
+    // A few chunks per thread, so that a slow thread does not hold the level up
+    Level l = {input, output, format, height, width, blockrows, std::max(blockrows / ((helpers + 1) * 4), 1)};
+    {
+        std::lock_guard<std::mutex> lock(level_mutex);
+        level = l;
+        level_next = 0;
+        level_running = helpers;
+        ++level_generation;
+    }
+    level_start.notify_all();
+    decodeChunks(l);
+    std::unique_lock<std::mutex> lock(level_mutex);
+    level_done.wait(lock, [] { return level_running == 0; });
+}
+
 void ddsDecompress(unsigned char *&RESTRICT buffer, unsigned char *&RESTRICT data, TEXTUREFORMAT internformat,
                    int height, int width)
 {
-    unsigned char *pos_out = nullptr, *pos_in = nullptr;
-    int bpp = 4;
-    unsigned int sx, sy;
+    ddsDecompressMips(buffer, data, internformat, height, width, 1);
+}
 
-    sx = (width < 4) ? width : 4;
-    sy = (height < 4) ? width : 4;
-    data = (unsigned char *)malloc(height * width * bpp);
-    pos_out = data;
-    pos_in = buffer;
-    for (int y = 0; y < height; y += 4)
-        for (int x = 0; x < width; x += 4)
+// Counts the levels of the chain that actually exist, and the bytes they take compressed and decoded
+static int dds_chain(TEXTUREFORMAT format, int height, int width, int mips, size_t &inbytes, size_t &outbytes)
+{
+    if (mips < 1)
+        mips = 1;
+    inbytes = outbytes = 0;
+    int levels = 0;
+    for (int w = width, h = height; levels < mips; ++levels)
+    {
+        inbytes += dds_level_bytes(format, h, w);
+        outbytes += (size_t)w * h * 4;
+        if (w == 1 && h == 1)
         {
-            pos_out = data + (y * width + x) * bpp;
-            if (internformat == DXT3)
-            {
-                decode_dxt3_alpha(pos_out + 3, pos_in, sx, sy, width * bpp);
-                pos_in += 8;
-            }
-            else if (internformat == DXT5)
-            {
-                decode_dxt5_alpha(pos_out + 3, pos_in, sx, sy, bpp, width * bpp);
-                pos_in += 8;
-            }
-            decode_color_block(pos_out, pos_in, sx, sy, width * bpp, internformat);
-            pos_in += 8;
+            ++levels;
+            break;
         }
+        w = std::max(w >> 1, 1);
+        h = std::max(h >> 1, 1);
+    }
+    return levels;
+}
+
+int ddsDecompressMips(const unsigned char *buffer, unsigned char *&data, TEXTUREFORMAT internformat, int height,
+                      int width, int mips)
+{
+    size_t inbytes, total;
+    int levels = dds_chain(internformat, height, width, mips, inbytes, total);
+    data = (unsigned char *)malloc(total);
+    const unsigned char *pos_in = buffer;
+    unsigned char *pos_out = data;
+    for (int i = 0, w = width, h = height; i < levels; ++i)
+    {
+        decode_level(pos_in, pos_out, internformat, h, w);
+        pos_in += dds_level_bytes(internformat, h, w);
+        pos_out += (size_t)w * h * 4;
+        w = std::max(w >> 1, 1);
+        h = std::max(h >> 1, 1);
+    }
+    return levels;
+}
+
+/*
+ * Decoded chains cached on disk, for machines that decode every texture in software. An entry is
+ * a header (magic, format, size, levels, hash and length of the compressed levels, length of the
+ * decoded ones) followed by the levels as ddsDecompressMips lays them out; its name is the hash.
+ * Entries are written aside and renamed into place, so that a reader never sees half a file, and
+ * never removed: the cache directory may be emptied at any time.
+ */
+static const char ddsCacheMagic[8] = {'V', 'S', 'D', 'D', 'S', 'R', 'G', '1'};
+
+struct DDSCacheHeader
+{
+    char magic[8];
+    uint32_t format, width, height, levels;
+    uint64_t hash, inbytes, outbytes;
+};
+
+// FNV-1a over 64 bit words, which keeps the hash well below the cost of decoding
+static uint64_t dds_hash(const unsigned char *data, size_t len)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8)
+    {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * 1099511628211ULL;
+    }
+    for (; i < len; ++i)
+        hash = (hash ^ data[i]) * 1099511628211ULL;
+    return hash;
+}
+
+static bool dds_cache_read(const std::string &path, const DDSCacheHeader &want, unsigned char *&data)
+{
+    FILE *fp = fopen(path.c_str(), "rb");
+    if (!fp)
+        return false;
+    DDSCacheHeader got;
+    bool ok = fread(&got, sizeof(got), 1, fp) == 1 && memcmp(&got, &want, sizeof(got)) == 0;
+    if (ok)
+    {
+        data = (unsigned char *)malloc(want.outbytes);
+        ok = fread(data, 1, want.outbytes, fp) == want.outbytes && fgetc(fp) == EOF;
+        if (!ok)
+        {
+            free(data);
+            data = nullptr;
+        }
+    }
+    fclose(fp);
+    return ok;
+}
+
+static void dds_cache_write(const std::string &path, const DDSCacheHeader &header, const unsigned char *data)
+{
+    // Loader threads may decode the same texture at once, each one writes its own temporary file
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".%zx.tmp", std::hash<std::thread::id>()(std::this_thread::get_id()));
+    std::string tmppath = path + suffix;
+    FILE *fp = fopen(tmppath.c_str(), "wb");
+    if (!fp)
+        return;
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1 && fwrite(data, 1, header.outbytes, fp) == header.outbytes;
+    ok = (fclose(fp) == 0) && ok;
+    if (ok)
+    {
+        remove(path.c_str());
+        ok = rename(tmppath.c_str(), path.c_str()) == 0;
+    }
+    if (!ok)
+        remove(tmppath.c_str());
+}
+
+int ddsDecompressMipsCached(const std::string &cachedir, const unsigned char *buffer, unsigned char *&data,
+                            TEXTUREFORMAT internformat, int height, int width, int mips)
+{
+    if (cachedir.empty())
+        return ddsDecompressMips(buffer, data, internformat, height, width, mips);
+    DDSCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ddsCacheMagic, sizeof(header.magic));
+    size_t inbytes, outbytes;
+    int levels = dds_chain(internformat, height, width, mips, inbytes, outbytes);
+    header.format = internformat;
+    header.width = width;
+    header.height = height;
+    header.levels = levels;
+    header.hash = dds_hash(buffer, inbytes);
+    header.inbytes = inbytes;
+    header.outbytes = outbytes;
+    char name[32];
+    snprintf(name, sizeof(name), "/%016llx.rgba", (unsigned long long)header.hash);
+    std::string path = cachedir + name;
+    if (dds_cache_read(path, header, data))
+        return levels;
+    ddsDecompressMips(buffer, data, internformat, height, width, mips);
+    dds_cache_write(path, header, data);
+    return levels;
 }
 
 /*  END of software decompression for DDS helper functions */
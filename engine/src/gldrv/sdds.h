@@ -1,6 +1,7 @@
 #ifndef _SDDS_H_
 #define _SDDS_H_
 #include "gldrv/gfxlib_struct.h"
+#include <string>
 
 /*
  *       input is the compressed dxt file, already read in by vsimage.
@@ -15,4 +16,29 @@
 
 void ddsDecompress(unsigned char *&input, unsigned char *&output, TEXTUREFORMAT format, int height, int width);
 
+/*
+ *       Same as ddsDecompress, but decodes the first mips levels of the chain found in input. The levels are
+ *       stored one after another in output, largest first, each one as tightly packed rgba rows.
+ *       Large levels are decoded by a few persistent helper threads, unless the calling thread
+ *       called ddsDecodeInline.
+ *
+ *       returns the number of levels decoded (the chain stops early once it reaches 1x1).
+ */
+int ddsDecompressMips(const unsigned char *input, unsigned char *&output, TEXTUREFORMAT format, int height, int width,
+                      int mips);
+
+/*
+ *       Same as ddsDecompressMips, through an on-disk cache of decoded chains in cachedir (which must exist;
+ *       an empty cachedir skips the cache). Entries are keyed by a hash of the compressed levels, and one
+ *       that is missing, damaged or made from other data is decoded again and rewritten.
+ */
+int ddsDecompressMipsCached(const std::string &cachedir, const unsigned char *input, unsigned char *&output,
+                            TEXTUREFORMAT format, int height, int width, int mips);
+
+/*
+ *       Marks the calling thread as one of a pool of decoders, such as the texture loader's: its
+ *       decodes then run on the thread itself, since the pool already keeps the cores busy.
+ */
+void ddsDecodeInline();
+
 #endif
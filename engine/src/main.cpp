@@ -47,6 +47,7 @@
 #include "in_kb.h"
 #include "lin_time.h"
 #include "main_loop.h"
+#include "object_pool.h"
 #include "python/init.h"
 #include "save_util.h"
 #include "savegame.h"
@@ -144,6 +145,8 @@ int readCommandLineOptions(int argc, char **argv);
 void VSExit(int code)
 {
     Music::CleanupMuzak();
+    // The save writer is detached; nothing else waits for it before exit
+    WaitForSaveFileWrites();
     winsys_exit(code);
 }
 
@@ -153,6 +156,7 @@ void cleanup(void)
     printf("Thank you for playing!\n");
     if (_Universe != nullptr)
         _Universe->WriteSaveGame(true);
+    WaitForSaveFileWrites();
 #ifdef _WIN32
 #if defined(_MSC_VER) && defined(_DEBUG)
     if (!cleanexit)
@@ -173,6 +177,8 @@ void cleanup(void)
     Music::CleanupMuzak();
     winsys_shutdown();
     AUDDestroy();
+    if (XMLSupport::parse_bool(vs_config->getVariable("general", "print_pool_stats", "false")))
+        ObjectPool::printStats(stdout);
     delete[] CONFIGFILE;
 }
 
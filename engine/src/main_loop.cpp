@@ -46,9 +46,13 @@
 #include "gfx/background.h"
 #include "gfx/cockpit.h"
 #include "gfx/matrix.h"
+#include "gfx/texture_loader.h"
 #include "in_kb_data.h"
 #include "main_loop.h"
+#include "profiler.h"
+#include "python/python_time.h"
 #include "save_util.h"
+#include "savegame.h"
 #include "universe_util.h"
 #include "vs_random.h"
 #include "vsfilesystem.h"
@@ -266,6 +270,7 @@ void QuitNow()
         if (game_options.write_savegame_on_exit)
         {
             _Universe->WriteSaveGame(true); // gotta do important stuff first
+            WaitForSaveFileWrites();
         }
         if (forcefeedback)
         {
@@ -1092,6 +1097,14 @@ void restore_main_loop()
 
 void main_loop()
 {
+    PROFILE_ZONE("Frame");
+    static bool profilefromstart =
+        XMLSupport::parse_bool(vs_config->getVariable("profiler", "enabled", "false"));
+    if (profilefromstart)
+    {
+        profilefromstart = false;
+        Profiler::setEnabled(true);
+    }
     // Evaluate number of loops per second each XX loops
     if (loop_count == 500)
     {
@@ -1108,7 +1121,13 @@ void main_loop()
     loop_count++;
 
     // Execute DJ script
-    Music::MuzakCycle();
+    {
+        PROFILE_ZONE("Audio");
+        Music::MuzakCycle();
+    }
+
+    // Upload textures decoded in the background since the last frame
+    TextureLoader::Update();
 
     _Universe->StartDraw();
     if (myterrain)
@@ -1117,11 +1136,17 @@ void main_loop()
 #ifndef NO_GFX
     BOOST_LOG_TRIVIAL(trace) << boost::format("Drawn %1% vertices in %2% batches") % gl_vertices_this_frame %
                                     gl_batches_this_frame;
+    PROFILE_COUNT(DrawCalls, gl_batches_this_frame);
     gl_vertices_this_frame = 0;
     gl_batches_this_frame = 0;
 #endif
 
     // Commit audio scene status to renderer
     if (g_game.sound_enabled)
+    {
+        PROFILE_ZONE("Audio");
         Audio::SceneManager::getSingleton()->commit();
+    }
+    Profiler::endFrame();
+    PythonTime::endFrame();
 }
@@ -0,0 +1,188 @@
+#include "object_pool.h"
+
+#include <mutex>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using ObjectPool::ALIGN;
+using ObjectPool::MAX_BLOCK;
+using ObjectPool::Pool;
+
+struct ObjectPool::Pool
+{
+    std::mutex lock; // the free list and counters; chunks are only added under it
+    const char *family;
+    size_t blocksize;
+    size_t chunkblocks;
+    std::vector<char *> chunks;
+    void *freelist;
+    size_t live;
+    size_t peak;
+    size_t allocations;
+#ifndef NDEBUG
+    std::vector<std::vector<bool>> inuse; // per chunk, per block
+#endif
+};
+
+namespace
+{
+// A chunk holds at least MIN_BLOCKS blocks and is about CHUNK_BYTES
+const size_t MIN_BLOCKS = 8;
+const size_t CHUNK_BYTES = 65536;
+
+// Guards the list of pools; never destroyed: units are still deleted while static objects go away at exit
+std::mutex &poolsLock()
+{
+    static std::mutex *lock = new std::mutex;
+    return *lock;
+}
+
+std::vector<Pool *> &allPools()
+{
+    static std::vector<Pool *> *pools = new std::vector<Pool *>;
+    return *pools;
+}
+
+size_t blockSize(size_t size)
+{
+    return (size + ALIGN - 1) & ~(ALIGN - 1);
+}
+
+// Families of the same name (a header included in several places) share their pools
+Pool *findPool(const char *family, size_t blocksize)
+{
+    std::lock_guard<std::mutex> guard(poolsLock());
+    std::vector<Pool *> &pools = allPools();
+    for (size_t i = 0; i < pools.size(); ++i)
+        if (pools[i]->blocksize == blocksize && !strcmp(pools[i]->family, family))
+            return pools[i];
+    Pool *pool = new Pool;
+    pool->family = family;
+    pool->blocksize = blocksize;
+    pool->chunkblocks = CHUNK_BYTES / blocksize > MIN_BLOCKS ? CHUNK_BYTES / blocksize : MIN_BLOCKS;
+    pool->freelist = nullptr;
+    pool->live = 0;
+    pool->peak = 0;
+    pool->allocations = 0;
+    pools.push_back(pool);
+    return pool;
+}
+
+void grow(Pool *pool)
+{
+    char *chunk = static_cast<char *>(::operator new(pool->blocksize * pool->chunkblocks));
+    pool->chunks.push_back(chunk);
+#ifndef NDEBUG
+    pool->inuse.push_back(std::vector<bool>(pool->chunkblocks, false));
+#endif
+    // Thread the free list front to back, so fresh blocks are handed out in address order
+    for (size_t i = pool->chunkblocks; i-- > 0;)
+    {
+        void *block = chunk + i * pool->blocksize;
+        *static_cast<void **>(block) = pool->freelist;
+        pool->freelist = block;
+    }
+}
+
+#ifndef NDEBUG
+std::vector<bool>::reference useFlag(Pool *pool, void *block)
+{
+    char *p = static_cast<char *>(block);
+    for (size_t i = 0; i < pool->chunks.size(); ++i)
+    {
+        char *chunk = pool->chunks[i];
+        if (p >= chunk && p < chunk + pool->blocksize * pool->chunkblocks && (p - chunk) % pool->blocksize == 0)
+            return pool->inuse[i][(p - chunk) / pool->blocksize];
+    }
+    fprintf(stderr, "ObjectPool: %p was not allocated from the %s pool of %u byte blocks\n", block, pool->family,
+            (unsigned)pool->blocksize);
+    abort();
+}
+#endif
+
+Pool *familyPool(ObjectPool::Family &family, size_t blocksize)
+{
+    std::atomic<Pool *> &slot = family.pools[blocksize / ALIGN - 1];
+    Pool *pool = slot.load(std::memory_order_acquire);
+    if (!pool)
+    {
+        pool = findPool(family.name, blocksize);
+        slot.store(pool, std::memory_order_release);
+    }
+    return pool;
+}
+} // namespace
+
+namespace ObjectPool
+{
+Family::Family(const char *name) : name(name)
+{
+    for (size_t i = 0; i < MAX_BLOCK / ALIGN; ++i)
+        pools[i] = nullptr;
+}
+
+void *allocate(Family &family, size_t size)
+{
+    size_t blocksize = blockSize(size);
+    if (blocksize > MAX_BLOCK)
+        return ::operator new(size);
+    Pool *pool = familyPool(family, blocksize);
+    std::lock_guard<std::mutex> guard(pool->lock);
+    if (!pool->freelist)
+        grow(pool);
+    void *block = pool->freelist;
+    pool->freelist = *static_cast<void **>(block);
+#ifndef NDEBUG
+    useFlag(pool, block) = true;
+#endif
+    ++pool->allocations;
+    if (++pool->live > pool->peak)
+        pool->peak = pool->live;
+    return block;
+}
+
+void release(Family &family, void *block, size_t size)
+{
+    if (!block)
+        return;
+    size_t blocksize = blockSize(size);
+    if (blocksize > MAX_BLOCK)
+    {
+        ::operator delete(block);
+        return;
+    }
+    Pool *pool = familyPool(family, blocksize);
+    std::lock_guard<std::mutex> guard(pool->lock);
+#ifndef NDEBUG
+    std::vector<bool>::reference used = useFlag(pool, block);
+    if (!used)
+    {
+        fprintf(stderr, "ObjectPool: %s block %p of %u bytes deleted twice\n", family.name, block,
+                (unsigned)blocksize);
+        abort();
+    }
+    used = false;
+    memset(block, 0xdd, blocksize);
+#endif
+    *static_cast<void **>(block) = pool->freelist;
+    pool->freelist = block;
+    --pool->live;
+}
+
+void printStats(FILE *fp)
+{
+    std::lock_guard<std::mutex> guard(poolsLock());
+    std::vector<Pool *> &pools = allPools();
+    for (size_t i = 0; i < pools.size(); ++i)
+    {
+        Pool &pool = *pools[i];
+        std::lock_guard<std::mutex> poolguard(pool.lock);
+        size_t capacity = pool.chunks.size() * pool.chunkblocks;
+        fprintf(fp, "ObjectPool %s/%u: %u live, %u peak, %u capacity (%.0f%% used), %u allocations\n", pool.family,
+                (unsigned)pool.blocksize, (unsigned)pool.live, (unsigned)pool.peak, (unsigned)capacity,
+                capacity ? 100.0 * pool.live / capacity : 0.0, (unsigned)pool.allocations);
+    }
+}
+} // namespace ObjectPool
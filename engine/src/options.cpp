@@ -18,6 +18,7 @@ void vs_options::init()
     custompython = vs_config->getVariable("general", "custompython", "import custom;custom.processMessage");
     quick_savegame_summaries =
         XMLSupport::parse_bool(vs_config->getVariable("general", "quick_savegame_summaries", "true"));
+    binary_mission_data = XMLSupport::parse_bool(vs_config->getVariable("general", "binary_mission_data", "false"));
     garbagecollectfrequency = XMLSupport::parse_int(vs_config->getVariable("general", "garbagecollectfrequency", "20"));
     numoldsystems = XMLSupport::parse_int(vs_config->getVariable("general", "numoldsystems", "6"));
     deleteoldsystems = XMLSupport::parse_bool(vs_config->getVariable("general", "deleteoldsystems", "true"));
@@ -27,6 +27,7 @@ class vs_options
     std::string empty_mission;
     std::string custompython;
     bool quick_savegame_summaries;
+    bool binary_mission_data;
     int garbagecollectfrequency;
     uint numoldsystems;
     bool deleteoldsystems;
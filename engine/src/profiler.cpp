@@ -0,0 +1,213 @@
+#include "profiler.h"
+#include "configxml.h"
+#include "vs_globals.h"
+#include "vsfilesystem.h"
+#include "xml_support.h"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+namespace Profiler
+{
+std::atomic<bool> enabled(false);
+}
+
+namespace
+{
+struct Event
+{
+    const char *name;
+    int64_t begin; // ns since the profiler epoch
+    int64_t end;
+};
+
+struct ThreadLog
+{
+    unsigned int tid;
+    std::mutex lock; // against writeTrace only, the owning thread is the single writer
+    std::vector<Event> events;
+    size_t next;
+    bool wrapped;
+    std::vector<Event> open; // zones begun and not yet ended, innermost last
+};
+
+struct Frame
+{
+    int64_t end;
+    unsigned int counters[Profiler::NumCounters];
+};
+
+std::mutex logslock;
+std::vector<std::unique_ptr<ThreadLog>> logs; // kept after their threads exit, for the trace
+thread_local ThreadLog *threadlog = nullptr;
+
+std::mutex frameslock;
+std::vector<Frame> frames;
+size_t nextframe = 0;
+std::atomic<unsigned int> counters[Profiler::NumCounters];
+
+const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+int64_t now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+size_t ringSize()
+{
+    static size_t size = XMLSupport::parse_int(vs_config->getVariable("profiler", "ring_size", "65536"));
+    return size ? size : 1;
+}
+
+ThreadLog *getThreadLog()
+{
+    if (!threadlog)
+    {
+        std::unique_ptr<ThreadLog> log(new ThreadLog);
+        log->events.resize(ringSize());
+        log->next = 0;
+        log->wrapped = false;
+        std::lock_guard<std::mutex> guard(logslock);
+        log->tid = logs.size();
+        threadlog = log.get();
+        logs.push_back(std::move(log));
+    }
+    return threadlog;
+}
+
+void writeEvent(FILE *fp, bool &first, const Event &e, unsigned int tid)
+{
+    fprintf(fp, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", first ? "" : ",",
+            e.name, tid, e.begin / 1000.0, (e.end - e.begin) / 1000.0);
+    first = false;
+}
+} // namespace
+
+namespace Profiler
+{
+void setEnabled(bool enable)
+{
+    if (enabled.exchange(enable) == enable)
+        return;
+    if (enable)
+    {
+        // Each recording makes a trace of its own, without what the last one left in the rings
+        {
+            std::lock_guard<std::mutex> guard(logslock);
+            for (size_t i = 0; i < logs.size(); ++i)
+            {
+                std::lock_guard<std::mutex> logguard(logs[i]->lock);
+                logs[i]->next = 0;
+                logs[i]->wrapped = false;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> guard(frameslock);
+            frames.clear();
+            nextframe = 0;
+        }
+        for (unsigned int i = 0; i < NumCounters; ++i)
+            counters[i] = 0;
+        VSFileSystem::vs_fprintf(stderr, "Profiler: recording\n");
+    }
+    else
+    {
+        static std::string file = vs_config->getVariable("profiler", "trace_file", "profile.json");
+        std::string path = VSFileSystem::homedir + "/" + file;
+        if (writeTrace(path))
+            VSFileSystem::vs_fprintf(stderr, "Profiler: trace written to %s\n", path.c_str());
+        else
+            VSFileSystem::vs_fprintf(stderr, "Profiler: could not write %s\n", path.c_str());
+    }
+}
+
+void beginZone(const char *name)
+{
+    Event e = {name, now(), 0};
+    getThreadLog()->open.push_back(e);
+}
+
+void endZone()
+{
+    ThreadLog *log = getThreadLog();
+    if (log->open.empty())
+        return;
+    Event e = log->open.back();
+    log->open.pop_back();
+    e.end = now();
+    std::lock_guard<std::mutex> guard(log->lock);
+    log->events[log->next] = e;
+    if (++log->next == log->events.size())
+    {
+        log->next = 0;
+        log->wrapped = true;
+    }
+}
+
+void addCount(Counter counter, unsigned int amount)
+{
+    counters[counter].fetch_add(amount, std::memory_order_relaxed);
+}
+
+void endFrame()
+{
+    if (!isEnabled())
+        return;
+    Frame frame;
+    frame.end = now();
+    for (unsigned int i = 0; i < NumCounters; ++i)
+        frame.counters[i] = counters[i].exchange(0, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> guard(frameslock);
+    if (frames.size() < ringSize())
+    {
+        frames.push_back(frame);
+    }
+    else
+    {
+        frames[nextframe] = frame;
+        nextframe = (nextframe + 1) % frames.size();
+    }
+}
+
+bool writeTrace(const std::string &filename)
+{
+    FILE *fp = fopen(filename.c_str(), "w");
+    if (!fp)
+        return false;
+    bool first = true;
+    fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    {
+        std::lock_guard<std::mutex> guard(logslock);
+        for (size_t i = 0; i < logs.size(); ++i)
+        {
+            ThreadLog &log = *logs[i];
+            std::lock_guard<std::mutex> logguard(log.lock);
+            if (log.wrapped)
+                for (size_t j = log.next; j < log.events.size(); ++j)
+                    writeEvent(fp, first, log.events[j], log.tid);
+            for (size_t j = 0; j < log.next; ++j)
+                writeEvent(fp, first, log.events[j], log.tid);
+        }
+    }
+    {
+        static const char *names[NumCounters] = {"units simulated", "pairs tested", "draw calls", "texture binds"};
+        std::lock_guard<std::mutex> guard(frameslock);
+        for (size_t i = 0; i < frames.size(); ++i)
+        {
+            const Frame &frame = frames[(nextframe + i) % frames.size()];
+            for (unsigned int c = 0; c < NumCounters; ++c)
+            {
+                fprintf(fp, "%s\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"count\":%u}}",
+                        first ? "" : ",", names[c], frame.end / 1000.0, frame.counters[c]);
+                first = false;
+            }
+        }
+    }
+    fprintf(fp, "\n]}\n");
+    return fclose(fp) == 0;
+}
+} // namespace Profiler
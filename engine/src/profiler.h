@@ -0,0 +1,74 @@
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#include <atomic>
+#include <string>
+
+/*
+ * Scoped frame profiler.
+ * PROFILE_ZONE("name") times the rest of the enclosing block. Zones nest, and every thread
+ * records into a ring buffer of its own, so only the last profiler/ring_size zones per thread
+ * are kept. PROFILE_COUNT adds to one of the per frame counters, which are closed by
+ * Profiler::endFrame once per frame.
+ *
+ * Toggled with the ToggleProfiler key, or profiler/enabled at startup. Turning it off writes
+ * everything recorded as a Chrome trace (chrome://tracing, Perfetto) to profiler/trace_file in
+ * the home directory. While off, a zone costs one relaxed atomic load.
+ * Zone names must be string literals: only the pointer is stored.
+ */
+namespace Profiler
+{
+enum Counter
+{
+    UnitsSimulated,
+    PairsTested,
+    DrawCalls,
+    TextureBinds,
+    NumCounters
+};
+
+extern std::atomic<bool> enabled;
+
+inline bool isEnabled()
+{
+    return enabled.load(std::memory_order_relaxed);
+}
+
+void setEnabled(bool enable);
+void beginZone(const char *name);
+void endZone();
+void addCount(Counter counter, unsigned int amount);
+/// Main thread, once per frame
+void endFrame();
+/// Everything still in the ring buffers; false when the file cannot be written
+bool writeTrace(const std::string &filename);
+
+class Zone
+{
+    bool active;
+
+  public:
+    explicit Zone(const char *name) : active(isEnabled())
+    {
+        if (active)
+            beginZone(name);
+    }
+    ~Zone()
+    {
+        if (active)
+            endZone();
+    }
+};
+} // namespace Profiler
+
+#define PROFILE_ZONE_CAT2(a, b) a##b
+#define PROFILE_ZONE_CAT(a, b) PROFILE_ZONE_CAT2(a, b)
+#define PROFILE_ZONE(name) Profiler::Zone PROFILE_ZONE_CAT(profile_zone_, __LINE__)(name)
+#define PROFILE_COUNT(counter, amount)                                                                                 \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (Profiler::isEnabled())                                                                                     \
+            Profiler::addCount(Profiler::counter, (amount));                                                           \
+    } while (0)
+
+#endif
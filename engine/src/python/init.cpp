@@ -22,6 +22,7 @@
 #include "init.h"
 #include "python_compile.h"
 #include "python_class.h"
+#include "python_time.h"
 #include "cmd/unit_generic.h"
 #if defined(_WIN32) && !defined(__CYGWIN__)
 #include <direct.h>
@@ -155,6 +156,7 @@ void Python::init()
     // Now we can do python things about them and initialize them
     Py_Initialize();
     initpaths();
+    PythonTime::init();
 
 #if BOOST_VERSION != 102800
     boost::python::converter::registry::insert(Vector_convertible, QVector_construct, boost::python::type_id<QVector>());
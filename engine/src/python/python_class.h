@@ -30,10 +30,11 @@
 #include "cmd/ai/fire.h"
 #include <memory>
 #include "init.h"
+#include "python/python_time.h"
 #define PYTHONCALLBACK(rtype, ptr, str) \
-  boost::python::call_method<rtype>(ptr, str)
+  (PythonTime::Scope("callback", Py_TYPE(ptr)->tp_name, str), boost::python::call_method<rtype>(ptr, str))
 #define PYTHONCALLBACK2(rtype, ptr, str, str2) \
-  boost::python::call_method<rtype>(ptr, str, str2)
+  (PythonTime::Scope("callback", Py_TYPE(ptr)->tp_name, str), boost::python::call_method<rtype>(ptr, str, str2))
 
 /*
 These following #defines will create a module for python
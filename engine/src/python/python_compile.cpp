@@ -8,6 +8,7 @@
 #include "init.h"
 #include "universe_util.h"
 #include "in_kb_data.h"
+#include "python_time.h"
 Hashtable<string, PyObject, 1023> compiled_python;
 
 char *LoadString(const char *filename)
@@ -74,6 +75,7 @@ PyObject *CompilePython(const std::string &name)
 extern PyObject *PyInit_VS;
 void CompileRunPython(const std::string &filename)
 {
+    PYTHON_TIME("script", filename.c_str(), nullptr);
     static bool ndebug_libs = XMLSupport::parse_bool(vs_config->getVariable("AI", "compile_python", "true"));
     if (ndebug_libs)
     {
@@ -0,0 +1,234 @@
+#include "python_time.h"
+#include "configxml.h"
+#include "vs_globals.h"
+#include "vsfilesystem.h"
+#include "xml_support.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+namespace PythonTime
+{
+std::atomic<bool> enabled(false);
+
+struct Site
+{
+    const char *name; // the key in sites, stable for the life of the program
+    unsigned long calls;
+    int64_t total; // ns
+    int64_t max;
+    unsigned long maxframe;
+    int64_t framens; // this frame so far
+    bool touched;    // listed in touched
+};
+} // namespace PythonTime
+
+using PythonTime::Site;
+
+namespace
+{
+struct Open
+{
+    Site *site;
+    int64_t begin;
+    bool zone; // a profiler zone was begun with it
+};
+
+struct SlowFrame
+{
+    unsigned long frame;
+    int64_t total;
+    const char *worst;
+    int64_t worstns;
+};
+
+std::mutex lock;
+std::unordered_map<std::string, Site> sites;
+std::string key; // reused to look sites up without allocating
+std::vector<Site *> touched;
+std::vector<SlowFrame> slowest; // slowest first
+unsigned long frame = 0;
+int64_t frametotal = 0;
+thread_local std::vector<Open> open; // innermost last
+
+const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+int64_t now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+size_t slowestFrames()
+{
+    static size_t count = XMLSupport::parse_int(vs_config->getVariable("python", "slowest_frames", "10"));
+    return count;
+}
+
+bool bySiteTotal(const Site *a, const Site *b)
+{
+    return a->total > b->total;
+}
+} // namespace
+
+namespace PythonTime
+{
+void init()
+{
+    if (XMLSupport::parse_bool(vs_config->getVariable("python", "time_accounting", "false")))
+        enabled = true;
+}
+
+Site *enter(const char *kind, const char *object, const char *method)
+{
+    Site *site;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        key.assign(kind);
+        key += ' ';
+        key += object ? object : "?";
+        if (method)
+        {
+            key += '.';
+            key += method;
+        }
+        std::unordered_map<std::string, Site>::iterator it = sites.find(key);
+        if (it == sites.end())
+        {
+            it = sites.insert(std::make_pair(key, Site())).first;
+            Site &added = it->second;
+            added.name = it->first.c_str();
+            added.calls = 0;
+            added.total = 0;
+            added.max = 0;
+            added.maxframe = 0;
+            added.framens = 0;
+            added.touched = false;
+        }
+        site = &it->second;
+    }
+    Open o = {site, 0, Profiler::isEnabled()};
+    if (o.zone)
+        Profiler::beginZone(site->name);
+    o.begin = now();
+    open.push_back(o);
+    return site;
+}
+
+void leave(Site *site)
+{
+    int64_t end = now();
+    if (open.empty() || open.back().site != site)
+        return;
+    Open o = open.back();
+    open.pop_back();
+    if (o.zone)
+        Profiler::endZone();
+    int64_t ns = end - o.begin;
+    std::lock_guard<std::mutex> guard(lock);
+    ++site->calls;
+    site->total += ns;
+    if (ns > site->max)
+    {
+        site->max = ns;
+        site->maxframe = frame;
+    }
+    site->framens += ns;
+    if (!site->touched)
+    {
+        site->touched = true;
+        touched.push_back(site);
+    }
+    // Nested calls are already inside their caller's time
+    if (open.empty())
+        frametotal += ns;
+}
+
+// Closes the frame, true when it is time for a summary in the log
+static bool closeFrame()
+{
+    static unsigned long logframes =
+        XMLSupport::parse_int(vs_config->getVariable("python", "time_log_frames", "0"));
+    std::lock_guard<std::mutex> guard(lock);
+    // Calls still open when accounting was turned off are closed by a later frame
+    if (touched.empty() && !isEnabled())
+        return false;
+    SlowFrame slow = {frame, frametotal, nullptr, 0};
+    for (size_t i = 0; i < touched.size(); ++i)
+    {
+        Site *site = touched[i];
+        if (site->framens > slow.worstns)
+        {
+            slow.worst = site->name;
+            slow.worstns = site->framens;
+        }
+        site->framens = 0;
+        site->touched = false;
+    }
+    touched.clear();
+    ++frame;
+    frametotal = 0;
+    size_t count = slowestFrames();
+    if (slow.worst && (slowest.size() < count || (count && slowest.back().total < slow.total)))
+    {
+        std::vector<SlowFrame>::iterator at = slowest.begin();
+        while (at != slowest.end() && at->total >= slow.total)
+            ++at;
+        slowest.insert(at, slow);
+        if (slowest.size() > count)
+            slowest.pop_back();
+    }
+    return logframes && frame % logframes == 0;
+}
+
+void endFrame()
+{
+    if (closeFrame())
+        logSummary();
+}
+
+void report(FILE *fp, size_t maxsites)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    std::vector<const Site *> sorted;
+    sorted.reserve(sites.size());
+    for (std::unordered_map<std::string, Site>::const_iterator it = sites.begin(); it != sites.end(); ++it)
+        sorted.push_back(&it->second);
+    std::sort(sorted.begin(), sorted.end(), bySiteTotal);
+    if (maxsites && sorted.size() > maxsites)
+        sorted.resize(maxsites);
+    fprintf(fp, "Python time over %lu frames\n", frame);
+    fprintf(fp, "%10s %8s %10s %10s %8s  %s\n", "total ms", "calls", "mean us", "max us", "at frame", "entry point");
+    for (size_t i = 0; i < sorted.size(); ++i)
+    {
+        const Site *site = sorted[i];
+        fprintf(fp, "%10.2f %8lu %10.1f %10.1f %8lu  %s\n", site->total / 1e6, site->calls,
+                site->calls ? site->total / 1e3 / site->calls : 0.0, site->max / 1e3, site->maxframe, site->name);
+    }
+    if (slowest.empty())
+        return;
+    fprintf(fp, "Slowest frames in Python\n");
+    fprintf(fp, "%8s %10s %10s  %s\n", "frame", "total ms", "worst ms", "worst entry point");
+    for (size_t i = 0; i < slowest.size(); ++i)
+        fprintf(fp, "%8lu %10.2f %10.2f  %s\n", slowest[i].frame, slowest[i].total / 1e6, slowest[i].worstns / 1e6,
+                slowest[i].worst);
+}
+
+void logSummary()
+{
+    static size_t lines = XMLSupport::parse_int(vs_config->getVariable("python", "time_summary_lines", "10"));
+    report(stderr, lines);
+}
+
+bool writeReport(const std::string &filename)
+{
+    FILE *fp = fopen(filename.c_str(), "w");
+    if (!fp)
+        return false;
+    report(fp, 0);
+    return fclose(fp) == 0;
+}
+} // namespace PythonTime
@@ -0,0 +1,67 @@
+#ifndef _PYTHON_TIME_H_
+#define _PYTHON_TIME_H_
+
+#include "profiler.h"
+
+#include <atomic>
+#include <stdio.h>
+#include <string>
+
+/*
+ * Wall time spent in Python, per mission, per script and per callback (Python class and method).
+ * Every entry point gets its call count, total and slowest call; every frame its Python total,
+ * and the slowest python/slowest_frames frames are kept along with the entry point that cost
+ * the most in each. Times are inclusive: a mission's time holds the callbacks it made.
+ *
+ * Recorded while python/time_accounting is on or the profiler is recording; the entry points
+ * then show up as zones in the profiler trace too. While off, a scope costs two relaxed atomic
+ * loads. The DumpPythonTime key prints the busiest entry points and writes the whole report to
+ * python/time_report_file in the home directory.
+ */
+namespace PythonTime
+{
+struct Site;
+
+extern std::atomic<bool> enabled;
+
+inline bool isEnabled()
+{
+    return enabled.load(std::memory_order_relaxed) || Profiler::isEnabled();
+}
+
+/// Reads the configuration; called by Python::init
+void init();
+Site *enter(const char *kind, const char *object, const char *method);
+void leave(Site *site);
+/// Main thread, once per frame
+void endFrame();
+/// The sites sorted by total time, at most maxsites of them (all when 0), then the slowest frames
+void report(FILE *fp, size_t maxsites);
+/// report to stderr, a line per site
+void logSummary();
+/// false when the file cannot be written
+bool writeReport(const std::string &filename);
+
+class Scope
+{
+    Site *site;
+
+  public:
+    Scope(const char *kind, const char *object, const char *method = nullptr)
+        : site(isEnabled() ? enter(kind, object, method) : nullptr)
+    {
+    }
+    ~Scope()
+    {
+        if (site)
+            leave(site);
+    }
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+};
+} // namespace PythonTime
+
+#define PYTHON_TIME(kind, object, method)                                                                              \
+    PythonTime::Scope PROFILE_ZONE_CAT(python_time_, __LINE__)(kind, object, method)
+
+#endif
@@ -22,6 +22,8 @@ voidEXPORT_UTIL( SetGalaxyFaction )
 EXPORT_UTIL( GetGalaxyPropertyDefault, "" )
 EXPORT_UTIL( GetNumAdjacentSystems, 0 )
 EXPORT_UTIL( GetJumpPath, 0 )
+EXPORT_UTIL( GetJumpDistance, -1 )
+EXPORT_UTIL( GetFactionJumpPath, 0 )
 voidEXPORT_UTIL( terminateMission )
 EXPORT_UTIL( getTargetLabel, "" )
 voidEXPORT_UTIL( setTargetLabel )
@@ -3,6 +3,7 @@
 #include "cmd/script/mission.h"
 #include "cmd/unit_generic.h"
 #include "configxml.h"
+#include "endianness.h"
 #include "gfx/cockpit_generic.h"
 #include "hashtable.h"
 #include "load_mission.h"
@@ -10,8 +11,14 @@
 #include "vsfilesystem.h"
 #include <Python.h>
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <float.h>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "options.h"
@@ -142,27 +149,116 @@ std::string GetReadPlayerSaveGame(int num)
     return ret;
 }
 
+/*
+ * Save files are opened on the calling thread (so errors show up where they did before), but the
+ * savegame is put together from its snapshot, written and the file closed by a background thread,
+ * so that saves don't stall the frame on formatting or disk IO. Jobs run in the order they were
+ * queued, and return false when they failed.
+ */
+namespace
+{
+// Never destroyed: the detached writer thread still waits on them during static destruction
+std::mutex &save_write_mutex = *new std::mutex;
+std::condition_variable &save_write_ready = *new std::condition_variable;
+std::condition_variable &save_write_done = *new std::condition_variable;
+std::deque<std::function<bool()>> &save_writes = *new std::deque<std::function<bool()>>;
+bool save_write_busy = false;
+bool save_write_failed = false;
+
+void saveWriterLoop()
+{
+    std::unique_lock<std::mutex> lock(save_write_mutex);
+    for (;;)
+    {
+        save_write_ready.wait(lock, [] { return !save_writes.empty(); });
+        std::function<bool()> job;
+        job.swap(save_writes.front());
+        save_writes.pop_front();
+        save_write_busy = true;
+        lock.unlock();
+
+        bool ok = job();
+        job = nullptr; // and whatever it held is freed here too
+
+        lock.lock();
+        save_write_busy = false;
+        if (!ok)
+            save_write_failed = true;
+        if (save_writes.empty())
+            save_write_done.notify_all();
+    }
+}
+
+void QueueSaveJob(std::function<bool()> job)
+{
+    static bool started = false;
+    if (!started)
+    {
+        started = true;
+        std::thread(saveWriterLoop).detach();
+    }
+    {
+        std::lock_guard<std::mutex> lock(save_write_mutex);
+        save_writes.push_back(std::move(job));
+    }
+    save_write_ready.notify_one();
+}
+
+VSFile *OpenSaveFile(const string &name, VSFileType type)
+{
+    VSFile *f = new VSFile;
+    if (f->OpenCreateWrite(name, type) <= Ok)
+        return f;
+    delete f;
+    std::lock_guard<std::mutex> lock(save_write_mutex);
+    save_write_failed = true;
+    return nullptr;
+}
+
+// On the writer thread
+bool WriteSaveFile(VSFile *file, const string &name, const string &contents)
+{
+    bool ok = file->Write(contents.data(), contents.length()) == contents.length();
+    if (!ok)
+        fprintf(stderr, "WARNING : couldn't write the whole savegame %s\n", name.c_str());
+    file->Close();
+    delete file;
+    return ok;
+}
+} // namespace
+
+bool QueueSaveFileWrite(const string &name, VSFileType type, const std::shared_ptr<const std::string> &contents)
+{
+    VSFile *f = OpenSaveFile(name, type);
+    if (!f)
+        return false;
+    QueueSaveJob([f, name, contents] { return WriteSaveFile(f, name, *contents); });
+    return true;
+}
+
+bool WaitForSaveFileWrites()
+{
+    std::unique_lock<std::mutex> lock(save_write_mutex);
+    save_write_done.wait(lock, [] { return save_writes.empty() && !save_write_busy; });
+    bool ok = !save_write_failed;
+    save_write_failed = false;
+    return ok;
+}
+
 // Used only to copy a savegame to a different named one
 void SaveFileCopy(const char *src, const char *dst)
 {
     if (dst[0] != '\0' && src[0] != '\0')
     {
+        WaitForSaveFileWrites();
         VSFile f;
         VSError err = f.OpenReadOnly(src, SaveFile);
         if (err <= Ok)
         {
-            string savecontent = f.ReadFull();
+            std::shared_ptr<const std::string> savecontent = std::make_shared<const std::string>(f.ReadFull());
             f.Close();
-            err = f.OpenCreateWrite(dst, SaveFile);
-            if (err <= Ok)
-            {
-                f.Write(savecontent);
-                f.Close();
-            }
-            else
-            {
+            if (!QueueSaveFileWrite(dst, SaveFile, savecontent))
                 fprintf(stderr, "WARNING : couldn't open savegame to copy to : %s as SaveFile", dst);
-            }
         }
         else
         {
@@ -171,20 +267,64 @@ void SaveFileCopy(const char *src, const char *dst)
     }
 }
 
+/*
+ * Long campaigns keep thousands of mission data entries, most of which don't change between two
+ * saves. Each entry keeps the text it was last saved as until it is handed out for writing (by
+ * getMissionData and friends, or a load), so a save only copies and formats the entries changed
+ * since the previous one. The text is filled in by the save writer; the main thread only passes
+ * the pointer on.
+ */
+template <class Values, class Text> struct MissionDataEntry
+{
+    Values values;
+    std::shared_ptr<Text> text; // null when changed since the last save
+};
+
 class MissionStringDat
 {
   public:
-    typedef std::map<string, vector<std::string>> MSD;
+    typedef MissionDataEntry<vector<std::string>, vector<char>> Entry;
+    typedef std::map<string, Entry> MSD;
     MSD m;
 };
 
 class MissionFloatDat
 {
   public:
-    typedef vsUMap<string, vector<float>> MFD;
+    typedef MissionDataEntry<vector<float>, string> Entry;
+    typedef vsUMap<string, Entry> MFD;
     MFD m;
 };
 
+/*
+ * A save in the making. SaveGame::WriteSaveGame fills it on the main thread with what has to be read
+ * from the live game: the player data, pickled missions, news and factions as the text they are saved
+ * as, and copies of the mission data entries changed since the previous save (the others only pass on
+ * the text they were last saved as). The save writer then formats those entries and puts the savegame
+ * together.
+ */
+struct SaveSnapshot
+{
+    template <class Values, class Text> struct Entry
+    {
+        string key;
+        Values values;
+        std::shared_ptr<Text> text;
+        bool format; // key and values are set, and text is to be filled in (if there is one)
+    };
+    typedef Entry<vector<float>, string> FloatEntry;
+    typedef Entry<vector<string>, vector<char>> StringEntry;
+
+    string head; // player data and stardate
+    bool binary;
+    vector<FloatEntry> floats;
+    vector<StringEntry> strings;
+    string tail; // python, news and factions
+
+    // On the writer thread
+    string Build() const;
+};
+
 SaveGame::SaveGame(const std::string &pilot)
 {
     callsign = pilot;
@@ -192,6 +332,7 @@ SaveGame::SaveGame(const std::string &pilot)
     PlayerLocation.Set(FLT_MAX, FLT_MAX, FLT_MAX);
     missionstringdata = new MissionStringDat;
     missiondata = new MissionFloatDat;
+    touchMissionData();
 }
 
 SaveGame::~SaveGame()
@@ -295,41 +436,56 @@ string createPipedString(vector<string> s)
     return ret;
 }
 
+// Closes and frees both files
+static bool CopySavedShipFile(VSFile *src, VSFile *dst)
+{
+    string srcdata = src->ReadFull();
+    bool ok = dst->Write(srcdata) == srcdata.length();
+    src->Close();
+    dst->Close();
+    delete src;
+    delete dst;
+    return ok;
+}
+
+// When saving, the files are copied by the save writer, after the unit files queued before them are written
 void CopySavedShips(std::string filename, int player_num, const std::vector<std::string> &starships, bool load)
 {
+    if (starships.empty())
+        return;
+    string srcnam = filename;
+    string dstnam = GetWritePlayerSaveGame(player_num);
+    if (load)
+        std::swap(srcnam, dstnam);
     for (unsigned int i = 0; i < starships.size(); i += 2)
     {
         if (i == 2)
             i = 1;
-        VSFile src, dst;
-        string srcnam = filename;
-        string dstnam = GetWritePlayerSaveGame(player_num);
-        string tmp;
-        if (load)
-        {
-            tmp = srcnam;
-            srcnam = dstnam;
-            dstnam = tmp;
-        }
-        VSError e = src.OpenReadOnly(srcnam + "/" + starships[i] + ".csv", UnitSaveFile);
+        VSFile *src = new VSFile;
+        VSError e = src->OpenReadOnly(srcnam + "/" + starships[i] + ".csv", UnitSaveFile);
         if (e <= Ok)
         {
             VSFileSystem::CreateDirectoryHome(VSFileSystem::savedunitpath + "/" + dstnam);
-            VSError f = dst.OpenCreateWrite(dstnam + "/" + starships[i] + ".csv", UnitFile);
-            if (f <= Ok)
+            VSFile *dst = OpenSaveFile(dstnam + "/" + starships[i] + ".csv", UnitFile);
+            if (!dst)
+            {
+                printf("Error: Cannot Copy Unit %s from save file %s to %s\n", starships[i].c_str(), srcnam.c_str(),
+                       dstnam.c_str());
+                delete src;
+            }
+            else if (load)
             {
-                string srcdata = src.ReadFull();
-                dst.Write(srcdata);
+                CopySavedShipFile(src, dst);
             }
             else
             {
-                printf("Error: Cannot Copy Unit %s from save file %s to %s\n", starships[i].c_str(), srcnam.c_str(),
-                       dstnam.c_str());
+                QueueSaveJob([src, dst] { return CopySavedShipFile(src, dst); });
             }
         }
         else
         {
             printf("Error: Cannot Open Unit %s from save file %s.\n", starships[i].c_str(), srcnam.c_str());
+            delete src;
         }
     }
 }
@@ -410,73 +566,93 @@ void SaveGame::AddUnitToSave(const char *filename, int type, const char *faction
 
 std::vector<float> &SaveGame::getMissionData(const std::string &magic_number)
 {
-    return missiondata->m[magic_number];
+    MissionFloatDat::Entry &entry = missiondata->m[magic_number];
+    entry.text.reset();
+    return entry.values;
 }
 
 const std::vector<float> &SaveGame::readMissionData(const std::string &magic_number) const
 {
     static const std::vector<float> empty;
     MissionFloatDat::MFD::const_iterator it = missiondata->m.find(magic_number);
-    return (it == missiondata->m.end()) ? empty : it->second;
+    return (it == missiondata->m.end()) ? empty : it->second.values;
 }
 
 unsigned int SaveGame::getMissionDataLength(const std::string &magic_number) const
 {
     MissionFloatDat::MFD::const_iterator it = missiondata->m.find(magic_number);
-    return (it == missiondata->m.end()) ? 0 : it->second.size();
+    return (it == missiondata->m.end()) ? 0 : it->second.values.size();
+}
+
+static unsigned int missiondatageneration = 1;
+
+unsigned int SaveGame::getMissionDataGeneration()
+{
+    return missiondatageneration;
+}
+
+void SaveGame::touchMissionData()
+{
+    ++missiondatageneration;
 }
 
 const std::vector<string> &SaveGame::readMissionStringData(const std::string &magic_number) const
 {
     static const std::vector<string> empty;
     MissionStringDat::MSD::const_iterator it = missionstringdata->m.find(magic_number);
-    return (it == missionstringdata->m.end()) ? empty : it->second;
+    return (it == missionstringdata->m.end()) ? empty : it->second.values;
 }
 
 std::vector<string> &SaveGame::getMissionStringData(const std::string &magic_number)
 {
-    return missionstringdata->m[magic_number];
+    MissionStringDat::Entry &entry = missionstringdata->m[magic_number];
+    entry.text.reset();
+    return entry.values;
 }
 
 unsigned int SaveGame::getMissionStringDataLength(const std::string &magic_number) const
 {
     MissionStringDat::MSD::const_iterator it = missionstringdata->m.find(magic_number);
-    return (it == missionstringdata->m.end()) ? 0 : it->second.size();
+    return (it == missionstringdata->m.end()) ? 0 : it->second.values.size();
 }
 
 template <class MContainerType> void RemoveEmpty(MContainerType &t)
 {
     typename MContainerType::iterator i;
     for (i = t.begin(); i != t.end();)
-        if (i->second.empty())
+        if (i->second.values.empty())
             t.erase(i++);
 
         else
             ++i;
 }
 
-string SaveGame::WriteMissionData()
+// On the writer thread, like the other Format functions
+static void FormatMissionData(const vector<SaveSnapshot::FloatEntry> &entries, string &ret)
 {
-    string ret(" ");
-    RemoveEmpty<MissionFloatDat::MFD>(missiondata->m);
-    ret += XMLSupport::tostring((int)missiondata->m.size());
-    for (MissionFloatDat::MFD::iterator i = missiondata->m.begin(); i != missiondata->m.end(); i++)
+    ret += " ";
+    ret += XMLSupport::tostring((int)entries.size());
+    for (vector<SaveSnapshot::FloatEntry>::const_iterator i = entries.begin(); i != entries.end(); ++i)
     {
-        unsigned int siz = (*i).second.size();
-
-        // Escape spaces within the key by replacing them with a special char ¬
-        string k = (*i).first;
+        if (i->format)
         {
-            for (size_t i = 0, len = k.length(); i < len; ++i)
-                if (k[i] == ' ')
-                    k[i] = '`';
-        }
+            unsigned int siz = i->values.size();
+
+            // Escape spaces within the key by replacing them with a special char ¬
+            string k = i->key;
+            {
+                for (size_t i = 0, len = k.length(); i < len; ++i)
+                    if (k[i] == ' ')
+                        k[i] = '`';
+            }
 
-        ret += string("\n") + k + string(" ") + XMLSupport::tostring(siz) + " ";
-        for (unsigned int j = 0; j < siz; j++)
-            ret += XMLSupport::tostring((*i).second[j]) + " ";
+            string &text = *i->text;
+            text = string("\n") + k + string(" ") + XMLSupport::tostring(siz) + " ";
+            for (unsigned int j = 0; j < siz; j++)
+                text += XMLSupport::tostring(i->values[j]) + " ";
+        }
+        ret += *i->text;
     }
-    return ret;
 }
 
 std::string scanInString(char *&buf)
@@ -496,6 +672,7 @@ std::string scanInString(char *&buf)
 void SaveGame::ReadMissionData(char *&buf, bool select_data, const std::set<std::string> &select_data_filter)
 {
     missiondata->m.clear();
+    touchMissionData();
     int mdsize;
     char *buf2 = buf;
     sscanf(buf2, " %d ", &mdsize);
@@ -520,7 +697,7 @@ void SaveGame::ReadMissionData(char *&buf, bool select_data, const std::set<std:
         bool skip = true;
         if (!select_data || select_data_filter.count(mag_num))
         {
-            vecfloat = &missiondata->m[mag_num];
+            vecfloat = &missiondata->m[mag_num].values;
             vecfloat->clear();
             vecfloat->reserve(md_i_size);
             skip = false;
@@ -613,7 +790,7 @@ void SaveGame::ReadMissionStringData(char *&buf, bool select_data, const std::se
         // game file is broken.
         if (md_i_size >= 0 && (!select_data || select_data_filter.count(mag_num)))
         {
-            vecstring = &missionstringdata->m[mag_num];
+            vecstring = &missionstringdata->m[mag_num].values;
             vecstring->clear();
             vecstring->reserve(md_i_size);
             skip = false;
@@ -643,9 +820,10 @@ void SaveGame::PurgeZeroStarships() // DELETE unused function?
     for (MissionStringDat::MSD::iterator i = missionstringdata->m.begin(), ie = missionstringdata->m.end(); i != ie;
          ++i)
         if (fg_util::IsFGKey(i->first))
-            if (fg_util::CheckFG(i->second))
+            if (fg_util::CheckFG(i->second.values))
             {
                 // printf( "correcting flightgroup %s to have right landed ships\n", i->first.c_str() );
+                i->second.text.reset();
             }
 }
 
@@ -685,28 +863,262 @@ static inline void PushBackString(const string &input, vector<char> &ret)
     PushBackChars(input.c_str(), ret);
 }
 
-void SaveGame::WriteMissionStringData(std::vector<char> &ret)
+static void FormatMissionStringData(const vector<SaveSnapshot::StringEntry> &entries, std::vector<char> &ret)
 {
-    RemoveEmpty<MissionStringDat::MSD>(missionstringdata->m);
-    PushBackUInt(missionstringdata->m.size(), ret);
-    for (MissionStringDat::MSD::iterator i = missionstringdata->m.begin(); i != missionstringdata->m.end(); i++)
+    PushBackUInt(entries.size(), ret);
+    for (vector<SaveSnapshot::StringEntry>::const_iterator i = entries.begin(); i != entries.end(); ++i)
+    {
+        if (i->format)
+        {
+            const string &key = i->key;
+            unsigned int siz = i->values.size();
+            if (key == "mission_descriptions" || key == "mission_scripts" || key == "mission_vars" ||
+                key == "mission_names")
+            {
+                //*** BLACKLIST ***
+                // Don't bother to write these out since they waste a lot of space and aren't used.
+                siz = 0; // Not writing them out altogether will cause saved games to break.
+            }
+            vector<char> &text = *i->text;
+            text.clear();
+            PushBackChars("\n", text);
+            PushBackString(key, text);
+            PushBackUInt(siz, text);
+            PushBackChars(" ", text);
+            for (unsigned int j = 0; j < siz; j++)
+                PushBackString(i->values[j], text);
+        }
+        ret.insert(ret.end(), i->text->begin(), i->text->end());
+    }
+}
+
+/*
+ * Binary mission data, written as one "0 mission binary <length> <bytes>" packet in place of the
+ * "mission data" and "missionstring data" text packets. Every number is a little endian uint32:
+ *   header:  "VSMD" version floatcount stringcount indexlength
+ *   index:   per entry, keylength key valuecount offset (into the payload), float entries first
+ *   payload: float entries as valuecount raw floats, string entries as valuecount (length, bytes)
+ * The index lets a selective load (select_data_filter) jump straight to the entries it wants, and
+ * float vectors are copied in bulk rather than printed and parsed one number at a time.
+ * Only written with general/binary_mission_data, since older builds cannot read it; it is always
+ * read back.
+ */
+#define MISSION_BINARY_VERSION 1
+
+static inline void PushBackLE32(uint32_t i, string &ret)
+{
+    i = VSSwapHostIntToLittle(i);
+    ret.append((const char *)&i, sizeof(i));
+}
+
+static void PushBackIndexEntry(const string &key, uint32_t count, uint32_t offset, string &index)
+{
+    PushBackLE32(key.length(), index);
+    index += key;
+    PushBackLE32(count, index);
+    PushBackLE32(offset, index);
+}
+
+static void FormatMissionBinary(const SaveSnapshot &snapshot, std::string &ret)
+{
+    string index, payload;
+    for (vector<SaveSnapshot::FloatEntry>::const_iterator i = snapshot.floats.begin(); i != snapshot.floats.end(); ++i)
+    {
+        uint32_t siz = i->values.size();
+        PushBackIndexEntry(i->key, siz, payload.length(), index);
+        size_t at = payload.length();
+        payload.resize(at + siz * sizeof(float));
+        uint32_t *dst = (uint32_t *)&payload[at];
+        memcpy(dst, i->values.data(), siz * sizeof(float));
+        for (uint32_t j = 0; j < siz; ++j)
+            dst[j] = VSSwapHostIntToLittle(dst[j]);
+    }
+    for (vector<SaveSnapshot::StringEntry>::const_iterator i = snapshot.strings.begin(); i != snapshot.strings.end();
+         ++i)
     {
-        const string &key = (*i).first;
-        unsigned int siz = (*i).second.size();
+        const string &key = i->key;
+        uint32_t siz = i->values.size();
         if (key == "mission_descriptions" || key == "mission_scripts" || key == "mission_vars" ||
             key == "mission_names")
+            siz = 0; // see FormatMissionStringData
+        PushBackIndexEntry(key, siz, payload.length(), index);
+        for (uint32_t j = 0; j < siz; ++j)
         {
-            //*** BLACKLIST ***
-            // Don't bother to write these out since they waste a lot of space and aren't used.
-            siz = 0; // Not writing them out altogether will cause saved games to break.
+            PushBackLE32(i->values[j].length(), payload);
+            payload += i->values[j];
         }
-        PushBackChars("\n", ret);
-        PushBackString(key, ret);
-        PushBackUInt(siz, ret);
-        PushBackChars(" ", ret);
-        for (unsigned int j = 0; j < siz; j++)
-            PushBackString((*i).second[j], ret);
     }
+
+    string packet("VSMD");
+    PushBackLE32(MISSION_BINARY_VERSION, packet);
+    PushBackLE32(snapshot.floats.size(), packet);
+    PushBackLE32(snapshot.strings.size(), packet);
+    PushBackLE32(index.length(), packet);
+    ret += XMLSupport::tostring((unsigned int)(packet.length() + index.length() + payload.length())) + " ";
+    ret += packet;
+    ret += index;
+    ret += payload;
+}
+
+// The binary packet is laid out afresh every time, so it takes the values of every entry
+template <class Values, class Text>
+static void SnapshotEntry(const string &key, MissionDataEntry<Values, Text> &entry, bool binary,
+                          SaveSnapshot::Entry<Values, Text> &ret)
+{
+    ret.format = binary || !entry.text;
+    if (ret.format)
+    {
+        ret.key = key;
+        ret.values = entry.values;
+    }
+    if (binary)
+        return;
+    if (!entry.text)
+        entry.text = std::make_shared<Text>();
+    ret.text = entry.text;
+}
+
+void SaveGame::SnapshotMissionData(SaveSnapshot &snapshot)
+{
+    RemoveEmpty<MissionFloatDat::MFD>(missiondata->m);
+    RemoveEmpty<MissionStringDat::MSD>(missionstringdata->m);
+    snapshot.floats.resize(missiondata->m.size());
+    vector<SaveSnapshot::FloatEntry>::iterator f = snapshot.floats.begin();
+    for (MissionFloatDat::MFD::iterator i = missiondata->m.begin(); i != missiondata->m.end(); ++i, ++f)
+        SnapshotEntry(i->first, i->second, snapshot.binary, *f);
+    snapshot.strings.resize(missionstringdata->m.size());
+    vector<SaveSnapshot::StringEntry>::iterator s = snapshot.strings.begin();
+    for (MissionStringDat::MSD::iterator i = missionstringdata->m.begin(); i != missionstringdata->m.end(); ++i, ++s)
+        SnapshotEntry(i->first, i->second, snapshot.binary, *s);
+}
+
+string SaveSnapshot::Build() const
+{
+    string ret(head);
+    if (binary)
+    {
+        ret += "\n0 mission binary ";
+        FormatMissionBinary(*this, ret);
+    }
+    else
+    {
+        ret += "\n0 mission data ";
+        FormatMissionData(floats, ret);
+        ret += "\n0 missionstring data ";
+        vector<char> missionstringdata1;
+        FormatMissionStringData(strings, missionstringdata1);
+        ret.append(missionstringdata1.begin(), missionstringdata1.end());
+    }
+    ret += tail;
+    return ret;
+}
+
+namespace
+{
+// Bounds checked reads from a binary packet; any overrun just marks the reader bad
+struct BinaryReader
+{
+    const char *pos;
+    const char *end;
+    bool ok;
+
+    BinaryReader(const char *begin, const char *end) : pos(begin), end(end), ok(true)
+    {
+    }
+    const char *bytes(size_t n)
+    {
+        if (!ok || (size_t)(end - pos) < n)
+        {
+            ok = false;
+            return nullptr;
+        }
+        const char *ret = pos;
+        pos += n;
+        return ret;
+    }
+    uint32_t le32()
+    {
+        uint32_t i = 0;
+        if (const char *p = bytes(sizeof(i)))
+            memcpy(&i, p, sizeof(i));
+        return VSSwapHostIntToLittle(i);
+    }
+};
+} // namespace
+
+void SaveGame::ReadMissionBinary(char *&buf, const char *bufend, bool select_data,
+                                 const std::set<std::string> &select_data_filter)
+{
+    missiondata->m.clear();
+    touchMissionData();
+    missionstringdata->m.clear();
+    char *blob = buf;
+    unsigned long length = strtoul(buf, &blob, 10);
+    if (*blob == ' ')
+        ++blob;
+    if (!bufend)
+        bufend = blob + length;
+    if ((size_t)(bufend - blob) < length)
+    {
+        fprintf(stderr, "WARNING : truncated binary mission data in savegame\n");
+        buf = blob + strlen(blob);
+        return;
+    }
+    buf = blob + length;
+
+    BinaryReader header(blob, buf);
+    const char *magic = header.bytes(4);
+    uint32_t version = header.le32();
+    uint32_t floatcount = header.le32();
+    uint32_t stringcount = header.le32();
+    uint32_t indexlength = header.le32();
+    if (!header.ok || memcmp(magic, "VSMD", 4) != 0 || version != MISSION_BINARY_VERSION ||
+        !header.bytes(indexlength))
+    {
+        fprintf(stderr, "WARNING : unsupported binary mission data in savegame (version %u)\n", version);
+        return;
+    }
+    BinaryReader index(header.pos - indexlength, header.pos);
+    const char *payload = header.pos;
+    for (uint32_t i = 0; i < floatcount + stringcount && index.ok; ++i)
+    {
+        uint32_t keylength = index.le32();
+        const char *key = index.bytes(keylength);
+        uint32_t count = index.le32();
+        uint32_t offset = index.le32();
+        if (!index.ok || offset > (size_t)(buf - payload))
+            break;
+        string mag_num(key, keylength);
+        if (select_data && !select_data_filter.count(mag_num))
+            continue;
+        BinaryReader values(payload + offset, buf);
+        if (i < floatcount)
+        {
+            const char *floats = values.bytes((size_t)count * sizeof(float));
+            if (!floats)
+                break;
+            vector<float> &vecfloat = missiondata->m[mag_num].values;
+            vecfloat.resize(count);
+            uint32_t *dst = (uint32_t *)vecfloat.data();
+            memcpy(dst, floats, count * sizeof(float));
+            for (uint32_t j = 0; j < count; ++j)
+                dst[j] = VSSwapHostIntToLittle(dst[j]);
+        }
+        else
+        {
+            vector<string> &vecstring = missionstringdata->m[mag_num].values;
+            vecstring.reserve(std::min<size_t>(count, buf - payload));
+            for (uint32_t j = 0; j < count && values.ok; ++j)
+            {
+                uint32_t len = values.le32();
+                if (const char *str = values.bytes(len))
+                    vecstring.push_back(string(str, len));
+            }
+        }
+    }
+    if (!index.ok)
+        fprintf(stderr, "WARNING : corrupt binary mission data in savegame\n");
+    this->PurgeZeroStarships();
 }
 
 void SaveGame::ReadStardate(char *&buf)
@@ -717,7 +1129,7 @@ void SaveGame::ReadStardate(char *&buf)
 }
 
 void SaveGame::ReadSavedPackets(char *&buf, bool commitfactions, bool skip_news, bool select_data,
-                                const std::set<std::string> &select_data_filter)
+                                const std::set<std::string> &select_data_filter, const char *bufend)
 {
     int a = 0;
     char unitname[1024];
@@ -745,6 +1157,10 @@ void SaveGame::ReadSavedPackets(char *&buf, bool commitfactions, bool skip_news,
         {
             ReadMissionStringData(buf, select_data, select_data_filter);
         }
+        else if (a == 0 && 0 == strcmp(unitname, "mission") && 0 == strcmp(factname, "binary"))
+        {
+            ReadMissionBinary(buf, bufend, select_data, select_data_filter);
+        }
         else if (a == 0 && 0 == strcmp(unitname, "python") && 0 == strcmp(factname, "data"))
         {
             last_written_pickled_data = last_pickled_data = UnpickleAllMissions(buf);
@@ -859,88 +1275,74 @@ string SaveGame::WritePlayerData(const QVector &FP, std::vector<std::string> uni
     return playerdata;
 }
 
-string SaveGame::WriteDynamicUniverse()
+void SaveGame::SnapshotDynamicUniverse(SaveSnapshot &snapshot)
 {
-    string dyn_univ("");
-    int MB = MAXBUFFER;
-    char *tmp = (char *)malloc(MB);
-    memset(tmp, 0, MB);
-    // Write mission data
     // we save the stardate
-
     string stardate = AnyStringWriteString(_Universe->current_stardate.GetFullTrekDate());
-    dyn_univ += "\n0 stardate data " + stardate;
+    snapshot.head += "\n0 stardate data " + stardate;
+
+    // Mission data is formatted by the writer
+    snapshot.binary = game_options.binary_mission_data;
+    SnapshotMissionData(snapshot);
 
-    memset(tmp, 0, MB);
-    sprintf(tmp, "\n%d %s %s", 0, "mission", "data ");
-    dyn_univ += string(tmp);
-    dyn_univ += WriteMissionData();
-    memset(tmp, 0, MB);
-    sprintf(tmp, "\n%d %s %s", 0, "missionstring", "data ");
-    dyn_univ += string(tmp);
-    vector<char> missionstringdata1;
-    WriteMissionStringData(missionstringdata1);
-    dyn_univ += string(&missionstringdata1[0], missionstringdata1.size());
     if (!STATIC_VARS_DESTROYED)
         last_written_pickled_data = PickleAllMissions();
-    tmp = tmprealloc(tmp, MB, last_written_pickled_data.length() + 256 /*4 floats*/);
-    sprintf(tmp, "\n%d %s %s %s ", 0, "python", "data", last_written_pickled_data.c_str());
-    dyn_univ += string(tmp);
+    snapshot.tail += "\n0 python data " + last_written_pickled_data + " ";
 
     // Write news data
-    memset(tmp, 0, MB);
-    sprintf(tmp, "\n%d %s %s", 0, "news", "data ");
-    dyn_univ += string(tmp);
-    dyn_univ += WriteNewsData();
+    snapshot.tail += "\n0 news data ";
+    snapshot.tail += WriteNewsData();
     // Write faction relationships
-    memset(tmp, 0, MB);
-    sprintf(tmp, "\n%d %s %s", 0, "factions", "begin ");
-    dyn_univ += string(tmp);
-    dyn_univ += FactionUtil::SerializeFaction();
-
-    free(tmp);
-    tmp = nullptr;
-
-    return dyn_univ;
+    snapshot.tail += "\n0 factions begin ";
+    snapshot.tail += FactionUtil::SerializeFaction();
 }
 
 using namespace VSFileSystem;
 
-string SaveGame::WriteSaveGame(const char *systemname, const QVector &FP, float credits,
-                               std::vector<std::string> unitname, int player_num, std::string fact, bool write)
+void SaveGame::WriteSaveGame(const char *systemname, const QVector &FP, float credits, std::vector<std::string> unitname,
+                             int player_num, std::string fact)
 {
-    savestring = string("");
     printf("Writing Save Game %s\n", outputsavegame.c_str());
-    savestring += WritePlayerData(FP, unitname, systemname, credits, fact);
-    savestring += WriteDynamicUniverse();
-    if (outputsavegame.length() != 0)
+    if (outputsavegame.length() == 0)
+        return;
+    // A previous save of the same files may still be in flight, and must not end up on top of this one
+    WaitForSaveFileWrites();
+    std::shared_ptr<SaveSnapshot> snapshot = std::make_shared<SaveSnapshot>();
+    snapshot->head = WritePlayerData(FP, unitname, systemname, credits, fact);
+    SnapshotDynamicUniverse(*snapshot);
+
+    std::vector<std::pair<VSFile *, string>> files;
+    // WRITE THE SAVEGAME TO THE MISSION SAVENAME
+    if (VSFile *f = OpenSaveFile(outputsavegame, SaveFile))
     {
-        if (write)
+        files.push_back(std::make_pair(f, outputsavegame));
+        if (player_num != -1)
         {
-            VSFile f;
-            VSError err = f.OpenCreateWrite(outputsavegame, SaveFile);
-            if (err <= Ok)
+            // AND THEN COPY IT TO THE SPECIFIED SAVENAME (from save.4.x.txt)
+            last_pickled_data = last_written_pickled_data;
+            string sg = GetWritePlayerSaveGame(player_num);
+            if (sg.length() != 0)
             {
-                // check
-                // WRITE THE SAVEGAME TO THE MISSION SAVENAME
-                f.Write(savestring.c_str(), savestring.length());
-                f.Close();
-                if (player_num != -1)
-                {
-                    // AND THEN COPY IT TO THE SPECIFIED SAVENAME (from save.4.x.txt)
-                    last_pickled_data = last_written_pickled_data;
-                    string sg = GetWritePlayerSaveGame(player_num);
-                    SaveFileCopy(outputsavegame.c_str(), sg.c_str());
-                }
-            }
-            else
-            {
-                // error occured while opening file
-                cerr << "occured while opening file: " << outputsavegame << endl;
+                if (VSFile *f = OpenSaveFile(sg, SaveFile))
+                    files.push_back(std::make_pair(f, sg));
+                else
+                    fprintf(stderr, "WARNING : couldn't open savegame to copy to : %s as SaveFile", sg.c_str());
             }
         }
     }
-    return savestring;
+    else
+    {
+        // error occured while opening file
+        cerr << "occured while opening file: " << outputsavegame << endl;
+        return;
+    }
+    QueueSaveJob([snapshot, files] {
+        string contents = snapshot->Build();
+        bool ok = true;
+        for (size_t i = 0; i < files.size(); ++i)
+            ok = WriteSaveFile(files[i].first, files[i].second, contents) && ok;
+        return ok;
+    });
 }
 
 static float savedcredits = 0;
@@ -977,6 +1379,7 @@ void SaveGame::ParseSaveGame(const string &filename_p, string &FSS, const string
     VSError err = FileNotFound;
     if (read)
     {
+        WaitForSaveFileWrites();
         // TRY TO GET THE SPECIFIED SAVENAME TO LOAD
         string plsave = GetReadPlayerSaveGame(player_num);
         if (plsave.length())
@@ -1065,7 +1468,8 @@ void SaveGame::ParseSaveGame(const string &filename_p, string &FSS, const string
                     PlayerLocation = tmppos; // LaunchUnitNear(tmppos);
                 }
                 buf += headlen;
-                ReadSavedPackets(buf, commitfaction, skip_news, select_data, select_data_filter);
+                ReadSavedPackets(buf, commitfaction, skip_news, select_data, select_data_filter,
+                                 deletebuf + savestring.length());
             }
             free(freetmp2);
             freetmp2 = nullptr;
@@ -7,6 +7,8 @@
 // WARNING, SAVE FILES ARE LIMITED TO MAXBUFFER SIZE !!! (LOOK IN NETWORKING/CONST.H)
 
 #include "SharedPool.h"
+#include "vsfilesystem.h"
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -25,6 +27,7 @@ struct SavedUnits
 };
 class MissionFloatDat;
 class MissionStringDat;
+struct SaveSnapshot;
 class SaveGame
 {
     SaveGame(const SaveGame &)
@@ -38,8 +41,7 @@ class SaveGame
     std::string outputsavegame;
     std::string originalsystem;
     std::string callsign;
-    std::string WriteMissionData();
-    void WriteMissionStringData(std::vector<char> &ret);
+    void SnapshotMissionData(SaveSnapshot &snapshot);
     std::string WriteNewsData();
     void ReadStardate(char *&buf);
     void ReadNewsData(char *&buf, bool just_skip = false);
@@ -47,6 +49,8 @@ class SaveGame
                          const std::set<std::string> &select_data_filter = std::set<std::string>());
     void ReadMissionStringData(char *&buf, bool select_data = false,
                                const std::set<std::string> &select_data_filter = std::set<std::string>());
+    void ReadMissionBinary(char *&buf, const char *bufend, bool select_data = false,
+                           const std::set<std::string> &select_data_filter = std::set<std::string>());
     MissionStringDat *missionstringdata;
     MissionFloatDat *missiondata;
     std::string playerfaction;
@@ -63,7 +67,7 @@ class SaveGame
         callsign = cs;
     }
 
-    /** Get read-write access to mission data */
+    /** Get read-write access to mission data - the entry is formatted again by the next save */
     std::vector<float> &getMissionData(const std::string &magic_number);
 
     /** Get read-only access to mission data - note: returns empty stub if key isn't found */
@@ -72,7 +76,12 @@ class SaveGame
     /** Get mission data length (read-only) */
     unsigned int getMissionDataLength(const std::string &magic_number) const;
 
-    /** Get read-write access to mission string data */
+    /** Changes whenever float mission data is loaded or written through the save data functions
+     *  (save_util.h), so values derived from it can be cached */
+    static unsigned int getMissionDataGeneration();
+    static void touchMissionData();
+
+    /** Get read-write access to mission string data - the entry is formatted again by the next save */
     std::vector<std::string> &getMissionStringData(const std::string &magic_number);
 
     /** Get read-only access to mission string data - note: returns empty stub if key isn't found */
@@ -99,14 +108,16 @@ class SaveGame
         playerfaction = faction;
     }
     std::string WriteSavedUnit(SavedUnits *su);
-    std::string WriteSaveGame(const char *systemname, const QVector &Pos, float credits,
-                              std::vector<std::string> unitname, int player_num, std::string fact = "",
-                              bool write = true);
+    /// Takes a snapshot of the game and queues it to be written out by the save writer
+    void WriteSaveGame(const char *systemname, const QVector &Pos, float credits, std::vector<std::string> unitname,
+                       int player_num, std::string fact = "");
     std::string WritePlayerData(const QVector &FP, std::vector<std::string> unitname, const char *systemname,
                                 float credits, std::string fact = "");
-    std::string WriteDynamicUniverse();
+    void SnapshotDynamicUniverse(SaveSnapshot &snapshot);
+    /// bufend, when known, bounds the binary packets (which may contain NULs)
     void ReadSavedPackets(char *&buf, bool commitfaction, bool skip_news = false, bool select_data = false,
-                          const std::set<std::string> &select_data_filter = std::set<std::string>());
+                          const std::set<std::string> &select_data_filter = std::set<std::string>(),
+                          const char *bufend = nullptr);
     /// cast address to long (for 64 bits compatibility)
     void AddUnitToSave(const char *unitname, int type, const char *faction, long address);
     void RemoveUnitFromSave(long address); // cast it to a long
@@ -123,5 +134,11 @@ void WriteSaveGame(class Cockpit *cp, bool auto_save);
 const std::string &GetCurrentSaveGame();
 std::string SetCurrentSaveGame(std::string newname);
 const std::string &GetSaveDir();
+/// Blocks until every save file queued by WriteSaveGame is on disk; false when one of them could not be
+/// opened or written since the previous call
+bool WaitForSaveFileWrites();
+/// Opens name on the calling thread and leaves writing contents to it to the save writer
+bool QueueSaveFileWrite(const std::string &name, VSFileSystem::VSFileType type,
+                        const std::shared_ptr<const std::string> &contents);
 void CopySavedShips(std::string filename, int player_num, const std::vector<std::string> &starships, bool load);
 #endif
@@ -32,6 +32,7 @@
 #include "in_kb.h"
 #include "lin_time.h"
 #include "load_mission.h"
+#include "profiler.h"
 #include "universe.h"
 #include "vegastrike.h"
 #include "vs_globals.h"
@@ -348,17 +349,20 @@ void GameStarSystem::Draw(bool DrawCockpit)
     GFXColor tmpcol(0, 0, 0, 1);
     GFXGetLightContextAmbient(tmpcol);
     double processmesh = queryTime();
-    if (!game_options.draw_near_stars_in_front_of_planets)
-        stars->Draw();
-    Mesh::ProcessZFarMeshes();
-    if (game_options.draw_near_stars_in_front_of_planets)
-        stars->Draw();
-    GFXEnable(DEPTHTEST);
-    GFXEnable(DEPTHWRITE);
-    // need to wait for lights to finish
-    GamePlanet::ProcessTerrains();
-    Terrain::RenderAll();
-    Mesh::ProcessUndrawnMeshes(true);
+    {
+        PROFILE_ZONE("Mesh queues");
+        if (!game_options.draw_near_stars_in_front_of_planets)
+            stars->Draw();
+        Mesh::ProcessZFarMeshes();
+        if (game_options.draw_near_stars_in_front_of_planets)
+            stars->Draw();
+        GFXEnable(DEPTHTEST);
+        GFXEnable(DEPTHWRITE);
+        // need to wait for lights to finish
+        GamePlanet::ProcessTerrains();
+        Terrain::RenderAll();
+        Mesh::ProcessUndrawnMeshes(true);
+    }
     processmesh = queryTime() - processmesh;
     Nebula *neb;
 
@@ -369,8 +373,11 @@ void GameStarSystem::Draw(bool DrawCockpit)
     GFXLightContextAmbient(tmpcol);
     if ((neb = _Universe->AccessCamera()->GetNebula()))
         neb->SetFogState();
-    Beam::ProcessDrawQueue();
-    Bolt::Draw();
+    {
+        PROFILE_ZONE("Bolts");
+        Beam::ProcessDrawQueue();
+        Bolt::Draw();
+    }
 
     GFXFogMode(FOG_OFF);
     Animation::ProcessDrawQueue();
@@ -379,7 +386,10 @@ void GameStarSystem::Draw(bool DrawCockpit)
     GameStarSystem::DrawJumpStars();
     ConditionalCursorDraw(false);
     if (DrawCockpit)
+    {
+        PROFILE_ZONE("HUD");
         _Universe->AccessCockpit()->Draw();
+    }
     MeshAnimation::UpdateFrames();
 
     // And now we're done with the occluder set
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <assert.h>
 #include <boost/version.hpp>
 #include <expat.h>
@@ -24,6 +25,7 @@
 #include "lin_time.h"
 #include "load_mission.h"
 #include "options.h"
+#include "profiler.h"
 #include "savegame.h"
 #include "star_system_generic.h"
 #include "universe_generic.h"
@@ -70,6 +72,7 @@ StarSystem::StarSystem()
     collidetable = nullptr;
     collidemap[Unit::UNIT_ONLY] = new CollideMap(Unit::UNIT_ONLY);
     collidemap[Unit::UNIT_BOLT] = new CollideMap(Unit::UNIT_BOLT);
+    collision_cache = new CollisionCache;
 
     no_collision_time = 0; //(int)(1+2.000/SIMULATION_ATOM);
     /// adds to jumping table;
@@ -86,6 +89,7 @@ StarSystem::StarSystem(const char *filename, const Vector &centr, const float ti
     no_collision_time = 0; //(int)(1+2.000/SIMULATION_ATOM);
     collidemap[Unit::UNIT_ONLY] = new CollideMap(Unit::UNIT_ONLY);
     collidemap[Unit::UNIT_BOLT] = new CollideMap(Unit::UNIT_BOLT);
+    collision_cache = new CollisionCache;
 
     this->current_sim_location = 0;
     /// adds to jumping table;
@@ -140,6 +144,7 @@ StarSystem::~StarSystem()
     RemoveStarsystemFromUniverse();
     delete collidemap[Unit::UNIT_ONLY];
     delete collidemap[Unit::UNIT_BOLT];
+    delete collision_cache;
 }
 
 /********* FROM STAR SYSTEM XML *********/
@@ -503,6 +508,7 @@ void StarSystem::RequestPhysics(Unit *un, unsigned int queue)
 
 void StarSystem::UpdateUnitPhysics(bool firstframe)
 {
+    PROFILE_ZONE("Sim queue");
     static bool phytoggle = true;
     static int batchcount = SIM_QUEUE_SIZE - 1;
     double aitime = 0;
@@ -526,6 +532,9 @@ void StarSystem::UpdateUnitPhysics(bool firstframe)
             // scheduling also require a constant base priority, since otherwise priority changes
             // will wreak havoc with subunit interpolation. Luckily again, we only need
             // randomization on priority changes, so we're fine.
+            static bool batch_beams =
+                XMLSupport::parse_bool(vs_config->getVariable("physics", "batch_beam_collisions", "true"));
+            BeamBatch beams(batch_beams);
             try
             {
                 Unit *unit = nullptr;
@@ -549,13 +558,20 @@ void StarSystem::UpdateUnitPhysics(bool firstframe)
                     theunitcounter = theunitcounter + 1;
                     SIMULATION_ATOM *= priority;
                     unit->sim_atom_multiplier = priority;
+                    PROFILE_COUNT(UnitsSimulated, 1);
                     double aa = queryTime();
-                    unit->ExecuteAI();
+                    {
+                        PROFILE_ZONE("AI");
+                        unit->ExecuteAI();
+                    }
                     double bb = queryTime();
                     unit->ResetThreatLevel();
-                    // FIXME "firstframe"-- assume no more than 2 physics updates per frame.
-                    unit->UpdatePhysics(identity_transformation, identity_matrix, Vector(0, 0, 0),
-                                        priority == 1 ? firstframe : true, &this->gravitationalUnits(), unit);
+                    {
+                        PROFILE_ZONE("Physics");
+                        // FIXME "firstframe"-- assume no more than 2 physics updates per frame.
+                        unit->UpdatePhysics(identity_transformation, identity_matrix, Vector(0, 0, 0),
+                                            priority == 1 ? firstframe : true, &this->gravitationalUnits(), unit);
+                    }
                     double cc = queryTime();
                     aitime += bb - aa;
                     phytime += cc - bb;
@@ -575,13 +591,24 @@ void StarSystem::UpdateUnitPhysics(bool firstframe)
                 throw;
             }
             double c0 = queryTime();
-            Bolt::UpdatePhysics(this);
+            {
+                PROFILE_ZONE("Beams");
+                beams.Resolve();
+            }
+            {
+                PROFILE_ZONE("Bolts");
+                Bolt::UpdatePhysics(this);
+            }
             double cc = queryTime();
-            last_collisions.clear();
+            PROFILE_ZONE("Collision");
+            collision_cache->NextFrame();
             collidemap[Unit::UNIT_BOLT]->flatten();
             if (Unit::NUM_COLLIDE_MAPS > 1)
                 collidemap[Unit::UNIT_ONLY]->flatten(*collidemap[Unit::UNIT_BOLT]);
             Unit *unit;
+            static unsigned int collision_threads =
+                XMLSupport::parse_int(vs_config->getVariable("physics", "collision_threads", "1"));
+            CollisionBatch narrowphase(collision_threads);
             for (auto iter = physics_buffer[current_sim_location].createIterator(); (unit = *iter);)
             {
                 int priority = unit->sim_atom_multiplier;
@@ -595,6 +622,7 @@ void StarSystem::UpdateUnitPhysics(bool firstframe)
                 else
                     iter.moveBefore(physics_buffer[newloc]);
             }
+            narrowphase.Resolve();
             double dd = queryTime();
             collidetime += dd - cc;
             bolttime += cc - c0;
@@ -607,10 +635,10 @@ void StarSystem::UpdateUnitPhysics(bool firstframe)
     else
     {
         Unit *unit = nullptr;
+        collision_cache->NextFrame();
         for (auto iter = getUnitList().createIterator(); (unit = *iter); ++iter)
         {
             unit->ExecuteAI();
-            last_collisions.clear();
             unit->UpdatePhysics(identity_transformation, identity_matrix, Vector(0, 0, 0), firstframe,
                                 &this->gravitationalUnits(), unit);
             unit->CollideAll();
@@ -624,23 +652,92 @@ extern void UpdateCameraSnds();
 
 extern float getTimeCompression();
 
+static void runDirectorLoop(Mission *m)
+{
+    _Universe->SetActiveCockpit(m->player_num);
+    StarSystem *ss = _Universe->AccessCockpit()->activeStarSystem;
+    if (ss)
+        _Universe->pushActiveStarSystem(ss);
+    mission = m;
+    m->DirectorLoop();
+    if (ss)
+        _Universe->popActiveStarSystem();
+}
+
+/*
+ * Runs the director loops within python/director_budget_ms of real time. The first mission (the
+ * player's own) and those asking for director_every_frame run every frame; the others take turns,
+ * starting each frame where the last one ran out of budget, and the one at the head of the turn
+ * always runs. A mission that alone overran the budget sits out as many frames as it took budgets,
+ * and no mission waits more than python/director_max_wait frames. Deferred missions still advance
+ * the game clock, so their scripts find the time that passed when they run again.
+ */
+static void runDirectorLoopsBudgeted(double budget)
+{
+    static unsigned int maxwait =
+        XMLSupport::parse_int(vs_config->getVariable("python", "director_max_wait", "10"));
+    static size_t turn = 0;
+    double start = realTime();
+    // Missions terminating in their loop erase themselves from active_missions; walk the frame's list
+    const std::vector<Mission *> missions(*active_missions.Get());
+    const std::vector<Mission *> &live = *active_missions.Get();
+    size_t count = missions.size();
+    for (size_t i = 0; i < count; ++i)
+    {
+        Mission *m = missions[i];
+        if (m && (i == 0 || m->director.everyframe) && std::find(live.begin(), live.end(), m) != live.end())
+        {
+            m->director.waited = 0;
+            runDirectorLoop(m);
+        }
+    }
+    bool first = true;
+    size_t nextturn = turn;
+    for (size_t k = 0; k < count; ++k)
+    {
+        size_t i = (turn + k) % count;
+        Mission *m = missions[i];
+        if (!m || i == 0 || std::find(live.begin(), live.end(), m) == live.end() || m->director.everyframe)
+            continue;
+        bool overdue = m->director.waited >= maxwait;
+        if (!overdue && (m->director.sitout || (!first && realTime() - start >= budget)))
+        {
+            if (m->director.sitout)
+                --m->director.sitout;
+            else if (nextturn == turn)
+                nextturn = i;
+            ++m->director.waited;
+            m->DirectorDefer();
+            continue;
+        }
+        first = false;
+        m->director.waited = 0;
+        double began = realTime();
+        runDirectorLoop(m);
+        double took = realTime() - began;
+        if (took > budget)
+            m->director.sitout = std::min((unsigned int)(took / budget), maxwait);
+    }
+    // Whoever ran out of budget first goes first next frame; when no one did, move on by one
+    turn = nextturn != turn ? nextturn : (count ? (turn + 1) % count : 0);
+}
+
 // server
 void ExecuteDirector()
 {
+    PROFILE_ZONE("Python");
+    static double budget =
+        XMLSupport::parse_float(vs_config->getVariable("python", "director_budget_ms", "0")) / 1000;
     unsigned int curcockpit = _Universe->CurrentCockpit();
+    if (budget > 0)
+    {
+        runDirectorLoopsBudgeted(budget);
+    }
+    else
     {
         for (unsigned int i = 0; i < active_missions.size(); ++i)
             if (active_missions[i])
-            {
-                _Universe->SetActiveCockpit(active_missions[i]->player_num);
-                StarSystem *ss = _Universe->AccessCockpit()->activeStarSystem;
-                if (ss)
-                    _Universe->pushActiveStarSystem(ss);
-                mission = active_missions[i];
-                active_missions[i]->DirectorLoop();
-                if (ss)
-                    _Universe->popActiveStarSystem();
-            }
+                runDirectorLoop(active_missions[i]);
     }
     _Universe->SetActiveCockpit(curcockpit);
     mission = active_missions[0];
@@ -740,7 +837,10 @@ void StarSystem::Update(float priority, bool executeDirector)
                 static int dothis = 0;
                 if (this == _Universe->getActiveStarSystem(0))
                     if ((++dothis) % 2 == 0)
+                    {
+                        PROFILE_ZONE("Audio");
                         AUDRefreshSounds();
+                    }
                 for (unsigned int i = 0; i < active_missions.size(); ++i)
                     // waste of frakkin time
                     active_missions[i]->BriefingUpdate();
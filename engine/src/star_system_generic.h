@@ -18,6 +18,7 @@ class Terrain;
 class ContinuousTerrain;
 class Universe;
 class CollideMap;
+class CollisionCache;
 class Texture;
 // class TextPlane;
 struct AtmosphericFogMesh
@@ -145,7 +146,8 @@ class StarSystem
     std::vector<class MissileEffect *> dischargedMissiles;
     unsigned int zone; // short fix
   public:
-    std::multimap<Unit *, Unit *> last_collisions;
+    /// mesh collision state of unit pairs, kept from one physics frame to the next
+    CollisionCache *collision_cache;
     // short fix
     void SetZone(unsigned int zonenum)
     {
@@ -9,6 +9,7 @@
 #include "cmd/script/flightgroup.h"
 #include "cmd/unit_factory.h"
 #include "configxml.h"
+#include "galaxy_gen.h"
 #include "gfx/mesh.h"
 #include "star_system_generic.h"
 #include "universe_util.h"
@@ -1533,28 +1534,54 @@ void StarSystem::endElement(const string &name)
     }
 }
 
+// Hands a generated system to the handlers the parser would have called for its file
+static void loadGeneratedElement(StarSystem *system, const SystemElement &element)
+{
+    vector<const XML_Char *> atts;
+    atts.reserve(element.attributes.size() + 1);
+    for (size_t i = 0; i < element.attributes.size(); ++i)
+        atts.push_back(element.attributes[i].c_str());
+    atts.push_back(nullptr);
+    StarSystem::beginElement(system, element.name.c_str(), &atts[0]);
+    for (size_t i = 0; i < element.children.size(); ++i)
+        loadGeneratedElement(system, element.children[i]);
+    StarSystem::endElement(system, element.name.c_str());
+}
+
 void StarSystem::LoadXML(const char *filename, const Vector &centroid, const float timeofyear)
 {
     using namespace StarXML;
     bool autogenerated = false;
     this->filename = filename;
-    string file = VSFileSystem::GetCorrectStarSysPath(filename, autogenerated);
-    if (file.empty())
+    string fcontents;
+    SystemElement generated;
+    if (takeGeneratedStarSystem(filename, generated))
     {
-        file = filename;
+        // Just generated: whether or not it was also written out, there is no need to read it back
+        autogenerated = true;
     }
-    if (game_options.game_speed_affects_autogen_systems)
+    else
     {
-        autogenerated = false;
+        string file = VSFileSystem::GetCorrectStarSysPath(filename, autogenerated);
+        if (file.empty())
+        {
+            file = filename;
+        }
+        VSFile f;
+        VSError err;
+        // if (file.length()) {
+        err = f.OpenReadOnly(file, SystemFile);
+        if (err > Ok)
+        {
+            printf("StarSystem: file not found %s\n", file.c_str());
+            return;
+        }
+        fcontents = f.ReadFull();
+        f.Close();
     }
-    VSFile f;
-    VSError err;
-    // if (file.length()) {
-    err = f.OpenReadOnly(file, SystemFile);
-    if (err > Ok)
+    if (game_options.game_speed_affects_autogen_systems)
     {
-        printf("StarSystem: file not found %s\n", file.c_str());
-        return;
+        autogenerated = false;
     }
     xml = new StarXML;
     xml->scale = 1;
@@ -1572,17 +1599,21 @@ void StarSystem::LoadXML(const char *filename, const Vector &centroid, const flo
     xml->backgroundDegamma = false;
     xml->reflectivity = game_options.reflectivity;
     xml->unitlevel = 0;
-    XML_Parser parser = XML_ParserCreate(nullptr);
-    XML_SetUserData(parser, this);
-    XML_SetElementHandler(parser, &StarSystem::beginElement, &StarSystem::endElement);
+    if (!generated.name.empty())
+    {
+        // Straight from the generator, without the text of a file to parse
+        loadGeneratedElement(this, generated);
+    }
+    else
     {
-        string fcontents = f.ReadFull();
+        XML_Parser parser = XML_ParserCreate(nullptr);
+        XML_SetUserData(parser, this);
+        XML_SetElementHandler(parser, &StarSystem::beginElement, &StarSystem::endElement);
         BOOST_LOG_TRIVIAL(debug) << "Contents of star system:";
         BOOST_LOG_TRIVIAL(debug) << fcontents;
-        XML_Parse(parser, (fcontents).c_str(), f.Size(), 1);
+        XML_Parse(parser, fcontents.c_str(), fcontents.size(), 1);
+        XML_ParserFree(parser);
     }
-    f.Close();
-    XML_ParserFree(parser);
     unsigned int i;
     for (i = 0; i < xml->moons.size(); ++i)
     {
@@ -7,7 +7,9 @@
 #include "cmd/script/mission.h"
 #include "cmd/unit_generic.h"
 #include "cmd/unit_util.h"
+#include "configxml.h"
 #include "galaxy_gen.h"
+#include "galaxy_graph.h"
 #include "galaxy_xml.h"
 #include "gfx/cockpit_generic.h"
 #include "options.h"
@@ -175,7 +177,10 @@ void Universe::Init(const char *gal)
 {
     ROLES::getAllRolePriorities();
     LoadWeapons(VSFileSystem::weapon_list.c_str());
+    // Background generation reads the galaxy being replaced
+    cancelPregeneration();
     galaxy.reset(new GalaxyXML::Galaxy(gal));
+    galaxy_graph.reset();
     static bool firsttime = false;
     if (!firsttime)
     {
@@ -246,6 +251,7 @@ StarSystem *Universe::getStarSystem(string name)
 }
 
 extern void MakeStarSystem(string file, Galaxy *galaxy, string origin, int forcerandom);
+extern void PregenerateStarSystem(string file, Galaxy *galaxy, string origin);
 extern string RemoveDotSystem(const char *input);
 using namespace VSFileSystem;
 
@@ -292,10 +298,20 @@ void Universe::Generate2(StarSystem *ss)
     script_system = ss;
     VSFileSystem::vs_fprintf(stderr, "Loading Star System %s\n", ss->getFileName().c_str());
     const vector<std::string> &adjacent = getAdjacentStarSystems(ss->getFileName());
+    static bool pregenerate =
+        XMLSupport::parse_bool(vs_config->getVariable("general", "pregenerate_adjacent_systems", "true"));
+    vector<std::string> unloaded;
     for (unsigned int i = 0; i < adjacent.size(); i++)
     {
         VSFileSystem::vs_fprintf(stderr, " Next To: %s\n", adjacent[i].c_str());
+        string file = getStarSystemFileName(adjacent[i]);
+        if (pregenerate && !GetLoadedStarSystem(file.c_str()))
+            unloaded.push_back(file);
     }
+    // adjacent is a shared buffer that generating the system info reuses. The pregeneration
+    // jobs skip the systems that have a file, so none are looked for here.
+    for (unsigned int i = 0; i < unloaded.size(); i++)
+        PregenerateStarSystem(unloaded[i], galaxy.get(), RemoveDotSystem(ss->getFileName().c_str()));
     static bool first = true;
 
     first = false;
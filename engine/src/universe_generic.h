@@ -47,10 +47,13 @@ namespace GalaxyXML
 {
 class Galaxy;
 }
+class GalaxyGraph;
 class Universe
 {
   protected:
     std::unique_ptr<GalaxyXML::Galaxy> galaxy;
+    /// the jump network of galaxy, compiled on first use
+    mutable std::unique_ptr<GalaxyGraph> galaxy_graph;
     /// The users cockpit
     unsigned int current_cockpit;
     std::vector<Cockpit *> cockpit;
@@ -144,6 +147,7 @@ class Universe
     {
         return galaxy.get();
     }
+    GalaxyGraph &getGalaxyGraph() const;
     bool StillExists(StarSystem *ss);
     void setActiveStarSystem(StarSystem *ss)
     {
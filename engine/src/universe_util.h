@@ -133,6 +133,12 @@ std::string GetGalaxyProperty(std::string sys, std::string prop);
 /// get the shortest path between systems as found in universe/milky_way.xml
 std::vector<std::string> GetJumpPath(std::string from, std::string to);
 
+/// number of jumps on the shortest path between systems, -1 if there is none
+int GetJumpDistance(std::string from, std::string to);
+
+/// like GetJumpPath, but the path avoids systems owned by factions hostile to the given one when it can
+std::vector<std::string> GetFactionJumpPath(std::string from, std::string to, std::string faction);
+
 /// this gets a specific property of this system as found in universe/milky_way.xml and returns a default value if not
 /// found
 std::string GetGalaxyPropertyDefault(std::string sys, std::string prop, std::string def);
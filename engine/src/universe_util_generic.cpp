@@ -8,6 +8,8 @@
 #include "cmd/unit_generic.h"
 #include "cmd/unit_util.h"
 #include "configxml.h"
+#include "faction_generic.h"
+#include "galaxy_graph.h"
 #include "gfx/cockpit_generic.h"
 #include "lin_time.h"
 #include "linecollide.h"
@@ -470,6 +472,14 @@ int getNumUnits()
  */
 string GetAdjacentSystem(string str, int which)
 {
+    const GalaxyGraph &graph = _Universe->getGalaxyGraph();
+    GalaxyGraph::SystemId sys = graph.find(str);
+    if (sys != GalaxyGraph::NoSystem)
+    {
+        if (which < 0 || (unsigned)which >= graph.numAdjacent(sys))
+            return string();
+        return graph.name(graph.beginAdjacent(sys)[which]);
+    }
     return _Universe->getAdjacentStarSystems(str)[which];
 }
 string GetGalaxyProperty(string sys, string prop)
@@ -485,8 +495,8 @@ string GetGalaxyPropertyDefault(string sys, string prop, string def)
 string GetGalaxyFaction(string sys)
 {
     string fac = _Universe->getGalaxyProperty(sys, "faction");
-    vector<std::string> *ans =
-        &(_Universe->AccessCockpit(0)->savegame->getMissionStringData(string(DEFAULT_FACTION_SAVENAME) + sys));
+    const vector<std::string> *ans =
+        &(_Universe->AccessCockpit(0)->savegame->readMissionStringData(string(DEFAULT_FACTION_SAVENAME) + sys));
     if (ans->size())
         fac = (*ans)[0];
     return fac;
@@ -499,9 +509,17 @@ void SetGalaxyFaction(string sys, string fac)
         (*ans)[0] = fac;
     else
         ans->push_back(std::string(fac));
+    GalaxyGraph &graph = _Universe->getGalaxyGraph();
+    GalaxyGraph::SystemId id = graph.find(sys);
+    if (id != GalaxyGraph::NoSystem)
+        graph.setFaction(id, FactionUtil::GetFactionIndex(fac));
 }
 int GetNumAdjacentSystems(string sysname)
 {
+    const GalaxyGraph &graph = _Universe->getGalaxyGraph();
+    GalaxyGraph::SystemId sys = graph.find(sysname);
+    if (sys != GalaxyGraph::NoSystem)
+        return graph.numAdjacent(sys);
     return _Universe->getAdjacentStarSystems(sysname).size();
 }
 float GetDifficulty()
@@ -907,7 +925,7 @@ string getSaveInfo(const std::string &filename, bool formatForTextbox)
         for (set<string>::const_iterator it = campaign_score_vars.begin(); it != campaign_score_vars.end(); ++it)
         {
             string var = *it;
-            unsigned int curscore = savegame.getMissionData(var).size() + savegame.getMissionStringData(var).size();
+            unsigned int curscore = savegame.getMissionDataLength(var) + savegame.getMissionStringDataLength(var);
             if (curscore > 0)
             {
                 hit = true;
@@ -945,6 +963,23 @@ vector<string> GetJumpPath(string from, string to)
     return path;
 }
 
+int GetJumpDistance(string from, string to)
+{
+    const GalaxyGraph &graph = _Universe->getGalaxyGraph();
+    return graph.jumps(graph.find(from), graph.find(to));
+}
+
+vector<string> GetFactionJumpPath(string from, string to, string faction)
+{
+    const GalaxyGraph &graph = _Universe->getGalaxyGraph();
+    vector<GalaxyGraph::SystemId> route;
+    graph.route(graph.find(from), graph.find(to), route, FactionUtil::GetFactionIndex(faction));
+    vector<string> path;
+    for (size_t i = 0; i < route.size(); ++i)
+        path.push_back(graph.name(route[i]));
+    return path;
+}
+
 } // namespace UniverseUtil
 
 #undef activeSys
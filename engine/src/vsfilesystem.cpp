@@ -18,6 +18,7 @@ struct dirent
 #else
 #include <dirent.h>
 #include <pwd.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <unistd.h>
 #endif
@@ -1280,6 +1281,21 @@ int FileExistsHome(const string &filename, VSFileType type)
     return FileExists(homedir, filename, type);
 }
 
+bool PlainFileExists(const string &filename, VSFileType type)
+{
+    struct stat s;
+    for (size_t i = 0; i <= Rootdir.size(); ++i)
+    {
+        string dir = (i == 0 ? homedir : Rootdir[i - 1]) + "/" + Directories[type] + "/";
+        if (stat((dir + filename).c_str(), &s) >= 0 && !(s.st_mode & S_IFDIR))
+            return true;
+        for (size_t j = 0; j < SubDirectories[type].size(); ++j)
+            if (stat((dir + SubDirectories[type][j] + "/" + filename).c_str(), &s) >= 0 && !(s.st_mode & S_IFDIR))
+                return true;
+    }
+    return false;
+}
+
 VSError GetError(const char *str)
 {
     cerr << "!!! ERROR/WARNING VSFile : ";
@@ -1486,6 +1502,9 @@ void VSFile::private_init()
     size = 0;
     pk3_file = nullptr;
     pk3_extracted_file = nullptr;
+    mapped_data = nullptr;
+    mapped_size = 0;
+    mapped_heap = false;
     offset = 0;
     valid = false;
     file_type = alt_type = UnknownFile;
@@ -1524,6 +1543,7 @@ VSFile::VSFile(const char *filename, VSFileType type, VSFileMode mode)
 
 VSFile::~VSFile()
 {
+    Unmap();
     if (fp)
     {
         fclose(fp);
@@ -1818,6 +1838,73 @@ size_t VSFile::Read(void *ptr, size_t length)
     return nbread;
 }
 
+const char *VSFile::Map()
+{
+    if (mapped_data)
+        return mapped_data;
+    if (UseVolumes[this->alt_type] && this->volume_type != VSFSNone)
+    {
+        if (q_volume_format == vfmtPK3)
+        {
+            // The volume entry is already inflated in memory : hand it out as is
+            checkExtracted();
+            mapped_data = pk3_extracted_file;
+            mapped_size = this->size;
+            mapped_heap = false;
+        }
+        return mapped_data;
+    }
+    long length = this->Size();
+    if (fp == nullptr || length <= 0)
+        return nullptr;
+#if !defined(_WIN32) || defined(__CYGWIN__)
+    void *view = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+    if (view != MAP_FAILED)
+    {
+        mapped_data = (char *)view;
+        mapped_size = length;
+        mapped_heap = false;
+        return mapped_data;
+    }
+    if (VSFS_DEBUG() > 1)
+        cerr << "mmap failed for " << this->filename << ", reading it instead" << endl;
+#endif
+    // No mapping support : fall back to a private copy of the file
+    long pos = ftell(fp);
+    char *buffer = new char[length];
+    fseek(fp, 0, SEEK_SET);
+    size_t nbread = fread(buffer, 1, length, fp);
+    fseek(fp, pos, SEEK_SET);
+    if (nbread != (size_t)length)
+    {
+        delete[] buffer;
+        return nullptr;
+    }
+    mapped_data = buffer;
+    mapped_size = length;
+    mapped_heap = true;
+    return mapped_data;
+}
+
+void VSFile::Unmap()
+{
+    if (!mapped_data)
+        return;
+    if (mapped_heap)
+    {
+        delete[] mapped_data;
+    }
+    else if (mapped_data != pk3_extracted_file)
+    {
+#if !defined(_WIN32) || defined(__CYGWIN__)
+        munmap(mapped_data, mapped_size);
+#endif
+    }
+    mapped_data = nullptr;
+    mapped_size = 0;
+    mapped_heap = false;
+}
+
 VSError VSFile::ReadLine(void *ptr, size_t length)
 {
     char *ret;
@@ -1898,7 +1985,8 @@ string VSFile::ReadFull()
             else
                 content[readsize] = '\0';
         }
-        string res(content);
+        // Keep embedded NULs (binary save game packets)
+        string res(content, readsize > 0 ? readsize : 0);
         delete[] content;
         return res;
     }
@@ -2145,8 +2233,41 @@ bool VSFile::Valid()
     return valid;
 }
 
+FileLocation::FileLocation() : relative(false), type(UnknownFile)
+{
+}
+
+// The same types VSFile::OpenReadOnly saves the path of
+FileLocation::FileLocation(const VSFile &f)
+    : relative(f.GetType() == UnitFile || f.GetType() == AnimFile || f.GetType() == VSSpriteFile ||
+               f.GetType() == CockpitFile),
+      root(f.GetRoot()), subdirectory(f.GetSubDirectory()), type(f.GetAltType())
+{
+}
+
+FileLocation::Scope::Scope(const FileLocation &location) : pushed(location.relative)
+{
+    if (pushed)
+    {
+        current_path.push_back(location.root);
+        current_subdirectory.push_back(location.subdirectory);
+        current_type.push_back(location.type);
+    }
+}
+
+FileLocation::Scope::~Scope()
+{
+    if (pushed)
+    {
+        current_path.pop_back();
+        current_subdirectory.pop_back();
+        current_type.pop_back();
+    }
+}
+
 void VSFile::Close()
 {
+    Unmap();
     if (this->file_type >= ZoneBuffer && this->file_type != UnknownFile && this->pk3_extracted_file)
     {
         delete this->pk3_extracted_file;
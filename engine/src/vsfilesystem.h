@@ -304,6 +304,9 @@ int FileExistsHome(const string &filename, VSFileType type = UnknownFile);
 // Test if a file exists relative to data_path
 int FileExistsData(const char *filename, VSFileType type = UnknownFile);
 int FileExistsData(const string &filename, VSFileType type = UnknownFile);
+// Whether filename is a plain file of that type in the home or a data directory. Does not look in the volumes and
+// leaves failed alone, so other threads may ask once the paths are set up
+bool PlainFileExists(const string &filename, VSFileType type);
 
 VSError GetError(const char *str = nullptr);
 
@@ -330,6 +333,11 @@ class VSFile
 
     void checkExtracted();
 
+    // Read-only mapping of the whole file (see Map())
+    char *mapped_data;
+    size_t mapped_size;
+    bool mapped_heap;
+
     // VSFile internals
     VSFileType file_type;
     VSFileType alt_type;
@@ -396,6 +404,13 @@ class VSFile
     VSError WriteLine(const void *ptr);           // Write a line
     void WriteFull(void *ptr);                    // Write
 
+    /********************************** MEMORY MAPPING *********************************/
+    // Returns a read only view of the whole file, or nullptr on failure. Plain files are mmap'ed,
+    // files inside a volume return the already extracted buffer without copying. The view stays
+    // valid until Unmap(), Close() or destruction. Size() gives the length of the view.
+    const char *Map();
+    void Unmap();
+
 #if 0
     int Fscanf( const char *format, ... );
 #endif
@@ -660,6 +675,34 @@ class VSFile
   private:
     void private_init();
 };
+
+/*
+ * Where an open unit, animation, sprite or cockpit file was found. Files next to it are looked
+ * for there while it is open; a Scope does the same later on, without looking for the file again.
+ */
+class FileLocation
+{
+    bool relative; // whether the file's type has files looked for next to it
+    string root;
+    string subdirectory;
+    VSFileType type;
+
+  public:
+    FileLocation();
+    /// f must be open
+    explicit FileLocation(const VSFile &f);
+
+    class Scope
+    {
+        bool pushed;
+
+      public:
+        explicit Scope(const FileLocation &location);
+        ~Scope();
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+    };
+};
 }; // namespace VSFileSystem
 
 std::ostream &operator<<(std::ostream &ostr, VSFileSystem::VSError err);
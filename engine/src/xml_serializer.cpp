@@ -2,6 +2,7 @@
 #include "cmd/images.h"
 #include "cmd/unit_generic.h"
 #include "configxml.h"
+#include "savegame.h"
 #include "vegastrike.h"
 #include "vs_globals.h"
 #include "vsfilesystem.h"
@@ -140,16 +141,10 @@ void XMLSerializer::Write(const char *modificationname)
         if (strlen(modificationname) != 0)
             savedir = modificationname;
     VSFileSystem::CreateDirectoryHome(VSFileSystem::savedunitpath + "/" + savedir);
-    VSFile f;
-    VSError err = f.OpenCreateWrite(savedir + "/" + this->filename, UnitFile);
-    if (err > Ok)
-    {
-        fprintf(stderr, "!!! ERROR : Writing saved unit file : %s\n", f.GetFullPath().c_str());
-        return;
-    }
-    for (unsigned int i = 0; i < topnode.subnodes.size(); i++)
-        topnode.subnodes[i].Write(f, mythis, 0);
-    f.Close();
+    // The unit is read here; the file is written by the save writer
+    string name = savedir + "/" + this->filename;
+    if (!QueueSaveFileWrite(name, UnitFile, std::make_shared<const std::string>(WriteString())))
+        fprintf(stderr, "!!! ERROR : Writing saved unit file : %s\n", name.c_str());
 }
 
 static string TabString(int level)